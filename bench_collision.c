@@ -0,0 +1,272 @@
+// Collision pass benchmark
+// Runs the server's collision passes for one sub-step (player bullets vs
+// enemies, enemy bullets vs players, players vs enemies) over random
+// entities, from today's caps up to rooms of hundreds of players. Bullets
+// live in BulletSets and enemies in the enemy grid, as on the server. The
+// player bullet pass runs twice: testing every enemy against every
+// shooter's bullets with the projectile kernel, and culling enemies with a
+// band query on the grid first, as check_bullet_hits() does. Both must find
+// the same overlaps.
+//
+// Build and run with `make bench`.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <SDL2/SDL.h>
+#include "network_common.h"
+#include "network_movement.h"
+#include "network_grid.h"
+#include "network_bullets.h"
+#include "network_clock.h"
+
+// As in network_server.c
+#define ENEMY_WIDTH 192
+#define ENEMY_HEIGHT 65
+#define BULLET_WIDTH 40
+#define BULLET_HEIGHT 15
+#define ENEMY_SPEED 300
+#define ENEMY_BULLET_SPEED 400
+
+#define BENCH_TICK (1.0f / TICK_RATE)
+#define BENCH_TEST_BUDGET 2e8  // Bullet tests per scenario on the kernel-only side; sets how many ticks are timed
+
+typedef struct {
+    const char *name;
+    int players, bullets_per_player, enemies, enemy_bullets;
+} Scenario;
+
+typedef struct {
+    float x, y, vx;
+} Body;
+
+typedef struct {
+    Scenario scenario;
+    Body *player;
+    Body *enemy;
+    BulletSet *player_bullets;  // One set per player
+    BulletSet enemy_bullets;
+    SpatialGrid enemy_grid;
+    Arena arena;                // Grid and bullet storage
+    int *candidates;
+    int *hits;
+    Uint64 kernel_calls;        // bullets_overlap calls by each side, summed over ticks
+    Uint64 culled_calls;
+} World;
+
+static float random_range(float low, float high) {
+    return low + (high - low) * (float)rand() / (float)RAND_MAX;
+}
+
+static void scatter(Body *bodies, int count, float w, float h, float vx) {
+    for (int i = 0; i < count; i++) {
+        bodies[i].x = random_range(0, ARENA_WIDTH - w);
+        bodies[i].y = random_range(0, ARENA_HEIGHT - h);
+        bodies[i].vx = vx;
+    }
+}
+
+// Bullets start in a band around their owner and fly horizontally, as
+// fired bullets do
+static void scatter_bullets(BulletSet *set, int count, float y, float vx) {
+    for (int i = 0; i < count; i++) {
+        bullets_spawn(set, random_range(0, ARENA_WIDTH - BULLET_WIDTH),
+                      y + random_range(-PLAYER_HEIGHT, PLAYER_HEIGHT), vx, 0);
+    }
+}
+
+// Advance one tick, wrapping around the arena so density stays constant
+static void move(Body *bodies, int count, float w) {
+    for (int i = 0; i < count; i++) {
+        bodies[i].x += bodies[i].vx * BENCH_TICK;
+        if (bodies[i].x > ARENA_WIDTH) bodies[i].x -= ARENA_WIDTH + w;
+        if (bodies[i].x < -w) bodies[i].x += ARENA_WIDTH + w;
+    }
+}
+
+static void move_bullets(BulletSet *set) {
+    bullets_integrate(set, BENCH_TICK);
+    for (int i = 0; i < set->count; i++) {
+        if (set->x[i] > ARENA_WIDTH) set->x[i] -= ARENA_WIDTH + BULLET_WIDTH;
+        if (set->x[i] < -BULLET_WIDTH) set->x[i] += ARENA_WIDTH + BULLET_WIDTH;
+    }
+}
+
+static int world_init(World *world, const Scenario *scenario) {
+    memset(world, 0, sizeof(World));
+    world->scenario = *scenario;
+    arena_init(&world->arena, 0);
+
+    int slots = scenario->bullets_per_player > scenario->enemy_bullets
+                ? scenario->bullets_per_player : scenario->enemy_bullets;
+    world->player = malloc(sizeof(Body) * scenario->players);
+    world->enemy = malloc(sizeof(Body) * scenario->enemies);
+    world->player_bullets = arena_alloc(&world->arena, sizeof(BulletSet) * scenario->players);
+    world->candidates = malloc(sizeof(int) * scenario->enemies);
+    world->hits = malloc(sizeof(int) * slots);
+    if (!world->player || !world->enemy || !world->player_bullets || !world->candidates || !world->hits ||
+        !bullets_init(&world->enemy_bullets, scenario->enemy_bullets, &world->arena) ||
+        !grid_init(&world->enemy_grid, ARENA_WIDTH, ARENA_HEIGHT, scenario->enemies, &world->arena)) {
+        return 0;
+    }
+    for (int p = 0; p < scenario->players; p++) {
+        if (!bullets_init(&world->player_bullets[p], scenario->bullets_per_player, &world->arena)) return 0;
+    }
+
+    scatter(world->player, scenario->players, PLAYER_WIDTH, PLAYER_HEIGHT, 0);
+    scatter(world->enemy, scenario->enemies, ENEMY_WIDTH, ENEMY_HEIGHT, -ENEMY_SPEED);
+    for (int p = 0; p < scenario->players; p++) {
+        scatter_bullets(&world->player_bullets[p], scenario->bullets_per_player, world->player[p].y,
+                        PLAYER_BULLET_SPEED);
+    }
+    for (int b = 0; b < scenario->enemy_bullets; b++) {
+        bullets_spawn(&world->enemy_bullets, random_range(0, ARENA_WIDTH - BULLET_WIDTH),
+                      random_range(0, ARENA_HEIGHT - BULLET_HEIGHT), -ENEMY_BULLET_SPEED, 0);
+    }
+    return 1;
+}
+
+static void world_free(World *world) {
+    free(world->player);
+    free(world->enemy);
+    free(world->candidates);
+    free(world->hits);
+    arena_free(&world->arena);
+}
+
+static void world_step(World *world) {
+    move(world->enemy, world->scenario.enemies, ENEMY_WIDTH);
+    for (int p = 0; p < world->scenario.players; p++) move_bullets(&world->player_bullets[p]);
+    move_bullets(&world->enemy_bullets);
+}
+
+// Player bullets vs enemies as before the grid served it: every enemy
+// against every shooter's bullets
+static Uint64 bullets_kernel_only(World *world) {
+    Uint64 hits = 0;
+    for (int e = 0; e < world->scenario.enemies; e++) {
+        for (int p = 0; p < world->scenario.players; p++) {
+            if (world->player_bullets[p].count == 0) continue;
+            hits += bullets_overlap(&world->player_bullets[p], BULLET_WIDTH, BULLET_HEIGHT,
+                                    world->enemy[e].x, world->enemy[e].y, ENEMY_WIDTH, ENEMY_HEIGHT, world->hits);
+            world->kernel_calls++;
+        }
+    }
+    return hits;
+}
+
+// As check_bullet_hits(): the enemies near the box around each shooter's
+// bullets, each against all of that shooter's bullets
+static Uint64 bullets_grid_culled(World *world) {
+    Uint64 hits = 0;
+    for (int p = 0; p < world->scenario.players; p++) {
+        const BulletSet *bullets = &world->player_bullets[p];
+        float min_x, min_y, max_x, max_y;
+        if (!bullets_bounds(bullets, &min_x, &min_y, &max_x, &max_y)) continue;
+
+        int found = grid_query_band(&world->enemy_grid, min_x, min_y,
+                                    max_x - min_x + BULLET_WIDTH, max_y - min_y + BULLET_HEIGHT,
+                                    world->candidates, world->scenario.enemies);
+        for (int c = 0; c < found; c++) {
+            const Body *enemy = &world->enemy[world->candidates[c]];
+            hits += bullets_overlap(bullets, BULLET_WIDTH, BULLET_HEIGHT,
+                                    enemy->x, enemy->y, ENEMY_WIDTH, ENEMY_HEIGHT, world->hits);
+            world->culled_calls++;
+        }
+    }
+    return hits;
+}
+
+// The rest of a sub-step, the same either way: update_grids(), enemy
+// bullets vs each player and the ram pass through the grid
+static Uint64 other_passes(World *world) {
+    for (int e = 0; e < world->scenario.enemies; e++) {
+        grid_update(&world->enemy_grid, e, world->enemy[e].x, world->enemy[e].y, ENEMY_WIDTH, ENEMY_HEIGHT);
+    }
+
+    Uint64 hits = 0;
+    for (int p = 0; p < world->scenario.players; p++) {
+        const Body *player = &world->player[p];
+        hits += bullets_overlap(&world->enemy_bullets, BULLET_WIDTH, BULLET_HEIGHT,
+                                player->x, player->y, PLAYER_WIDTH, PLAYER_HEIGHT, world->hits);
+
+        int found = grid_query(&world->enemy_grid, player->x, player->y, PLAYER_WIDTH, PLAYER_HEIGHT,
+                               world->candidates, world->scenario.enemies);
+        for (int c = 0; c < found; c++) {
+            const Body *enemy = &world->enemy[world->candidates[c]];
+            hits += !(player->x + PLAYER_WIDTH <= enemy->x || player->x >= enemy->x + ENEMY_WIDTH ||
+                      player->y + PLAYER_HEIGHT <= enemy->y || player->y >= enemy->y + ENEMY_HEIGHT);
+        }
+    }
+    return hits;
+}
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+    static const Scenario scenarios[] = {
+        { "caps",    DEFAULT_PLAYERS, DEFAULT_BULLETS_PER_PLAYER, DEFAULT_ENEMIES, DEFAULT_ENEMY_BULLETS },
+        { "busy",    16,  16, 256,  256 },
+        { "large",   64,  13, 1024, 1024 },
+        { "largest", 256, 13, 1024, 4096 },
+    };
+
+    BulletKernel kernel = bullets_select_kernel(BULLET_KERNEL_AVX2);
+    printf("Collision passes per sub-step, %s kernel, %.0f px grid cells\n",
+           bullets_kernel_name(kernel), GRID_CELL_SIZE);
+    printf("%8s %9s %6s %12s %12s %8s %16s %10s\n",
+           "Room", "Entities", "Ticks", "Kernel (us)", "Culled (us)", "Speedup", "Kernel calls", "Overlaps");
+
+    for (size_t s = 0; s < sizeof(scenarios) / sizeof(scenarios[0]); s++) {
+        const Scenario *scenario = &scenarios[s];
+        World world;
+        srand(1942);
+        if (!world_init(&world, scenario)) {
+            printf("%8s allocation failed\n", scenario->name);
+            world_free(&world);
+            return 1;
+        }
+
+        double tests = (double)scenario->players * scenario->bullets_per_player * scenario->enemies;
+        int ticks = (int)(BENCH_TEST_BUDGET / tests);
+        if (ticks < 10) ticks = 10;
+        if (ticks > 1000) ticks = 1000;
+
+        Uint64 kernel_ns = 0, culled_ns = 0;
+        Uint64 kernel_hits = 0, culled_hits = 0;
+        for (int t = 0; t < ticks; t++) {
+            world_step(&world);
+
+            Uint64 start = clock_now_ns();
+            Uint64 shared = other_passes(&world);
+            Uint64 after_shared = clock_now_ns();
+            kernel_hits += bullets_kernel_only(&world);
+            Uint64 middle = clock_now_ns();
+            culled_hits += bullets_grid_culled(&world);
+            Uint64 end = clock_now_ns();
+
+            // Both sides pay for the shared passes
+            kernel_hits += shared;
+            culled_hits += shared;
+            kernel_ns += after_shared - start + middle - after_shared;
+            culled_ns += after_shared - start + end - middle;
+        }
+
+        int entities = scenario->players * (1 + scenario->bullets_per_player) +
+                       scenario->enemies + scenario->enemy_bullets;
+        char calls[48];
+        snprintf(calls, sizeof(calls), "%llu -> %llu",
+                 (unsigned long long)(world.kernel_calls / ticks), (unsigned long long)(world.culled_calls / ticks));
+        printf("%8s %9d %6d %12.1f %12.1f %7.1fx %16s %10llu%s\n",
+               scenario->name, entities, ticks,
+               kernel_ns / 1e3 / ticks, culled_ns / 1e3 / ticks,
+               culled_ns ? (double)kernel_ns / culled_ns : 0.0,
+               calls,
+               (unsigned long long)(culled_hits / ticks),
+               kernel_hits == culled_hits ? "" : "  MISMATCH");
+        world_free(&world);
+
+        if (kernel_hits != culled_hits) return 1;
+    }
+    return 0;
+}
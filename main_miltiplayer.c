@@ -158,6 +158,7 @@ int game_multiplayer(SDL_Window* win, SDL_Renderer* rend) {
         {255, 255, 100, 255},  // Yellow
         {255, 100, 255, 255}   // Magenta
     };
+    const int player_color_count = sizeof(player_colors) / sizeof(player_colors[0]);
 
     if (!tex || !bg_tex) {
         printf("Failed to load textures\n");
@@ -204,12 +205,35 @@ int game_multiplayer(SDL_Window* win, SDL_Renderer* rend) {
         // Receive game state from server
         client_receive_state(&netClient);
 
+        // React to one-off events the server delivered reliably
+        GameEvent game_event;
+        while (client_poll_event(&netClient, &game_event)) {
+            switch (game_event.type) {
+                case EVENT_EXPLOSION:
+                    if (soundOn && sColl1) Mix_PlayChannel(-1, sColl1, 0);
+                    break;
+                case EVENT_PLAYER_DIED:
+                    printf("[EVENT] Player %d was shot down (Score: %d)\n", game_event.player_id, game_event.value);
+                    break;
+                case EVENT_PLAYER_JOINED:
+                    printf("[EVENT] Player %d joined\n", game_event.player_id);
+                    break;
+                case EVENT_PLAYER_LEFT:
+                    printf("[EVENT] Player %d left\n", game_event.player_id);
+                    break;
+                default:
+                    break;
+            }
+        }
+
         // Render
         SDL_RenderClear(rend);
         SDL_RenderCopy(rend, bg_tex, NULL, NULL);
 
+        const RoomCapacity *room = &netClient.game_state.capacity;
+
         // Render all players
-        for (int i = 0; i < MAX_PLAYERS; i++) {
+        for (int i = 0; i < room->players; i++) {
             if (!netClient.game_state.players[i].active) continue;
             if (!netClient.game_state.players[i].alive) continue;
 
@@ -217,7 +241,7 @@ int game_multiplayer(SDL_Window* win, SDL_Renderer* rend) {
             SDL_Rect player_rect = {(int)player->x, (int)player->y, 192, 65};
             
             // Color code players
-            SDL_Color pc = player_colors[i];
+            SDL_Color pc = player_colors[i % player_color_count];
             SDL_SetTextureColorMod(tex, pc.r, pc.g, pc.b);
             SDL_RenderCopy(rend, tex, NULL, &player_rect);
 
@@ -235,12 +259,13 @@ int game_multiplayer(SDL_Window* win, SDL_Renderer* rend) {
             render_health_bar(rend, player->health, (int)player->x, (int)player->y + 70);
 
             // Render player bullets
-            for (int j = 0; j < MAX_BULLETS_PER_PLAYER; j++) {
-                if (!player->bullets[j].active) continue;
+            NetworkBullet *bullets = game_state_player_bullets(&netClient.game_state, i);
+            for (int j = 0; j < room->bullets_per_player; j++) {
+                if (!bullets[j].active) continue;
 
                 SDL_Rect bullet_rect = {
-                    (int)player->bullets[j].x, 
-                    (int)player->bullets[j].y, 
+                    (int)bullets[j].x, 
+                    (int)bullets[j].y, 
                     40, 15
                 };
                 SDL_SetTextureColorMod(bullet_tex, 255, 255, 255);
@@ -249,7 +274,7 @@ int game_multiplayer(SDL_Window* win, SDL_Renderer* rend) {
         }
 
         // Render enemies
-        for (int i = 0; i < MAX_ENEMIES; i++) {
+        for (int i = 0; i < room->enemies; i++) {
             if (!netClient.game_state.enemies[i].active) continue;
 
             NetworkEnemy* enemy = &netClient.game_state.enemies[i];
@@ -261,7 +286,7 @@ int game_multiplayer(SDL_Window* win, SDL_Renderer* rend) {
         }
 
         // Render enemy bullets
-        for (int i = 0; i < MAX_ENEMY_BULLETS; i++) {
+        for (int i = 0; i < room->enemy_bullets; i++) {
             if (!netClient.game_state.enemy_bullets[i].active) continue;
 
             SDL_Rect eb_rect = {
@@ -274,7 +299,7 @@ int game_multiplayer(SDL_Window* win, SDL_Renderer* rend) {
         }
 
         // Render explosions
-        for (int i = 0; i < 20; i++) {
+        for (int i = 0; i < room->explosions; i++) {
             if (!netClient.game_state.explosions[i].active) continue;
 
             SDL_Rect exp_rect = {
@@ -287,7 +312,7 @@ int game_multiplayer(SDL_Window* win, SDL_Renderer* rend) {
         }
 
         // Render local player info
-        if (netClient.player_id >= 0 && netClient.player_id < MAX_PLAYERS) {
+        if (netClient.player_id >= 0 && netClient.player_id < room->players) {
             NetworkPlayer* local = &netClient.game_state.players[netClient.player_id];
             
             if (local->active) {
@@ -313,11 +338,14 @@ int game_multiplayer(SDL_Window* win, SDL_Renderer* rend) {
         // Scoreboard
         SDL_Color white = {255, 255, 255, 255};
         render_text(rend, "SCOREBOARD", WINDOW_WIDTH - 200, 10, 20, white);
-        for (int i = 0; i < MAX_PLAYERS; i++) {
+        int sb_row = 0;
+        for (int i = 0; i < room->players; i++) {
             if (!netClient.game_state.players[i].active) continue;
+            if (40 + sb_row * 25 > WINDOW_HEIGHT - 120) break;  // Large rooms: as many as fit above the HUD
             char sb_text[64];
             sprintf(sb_text, "P%d: %d pts", i, netClient.game_state.players[i].score);
-            render_text(rend, sb_text, WINDOW_WIDTH - 200, 40 + i * 25, 18, player_colors[i]);
+            render_text(rend, sb_text, WINDOW_WIDTH - 200, 40 + sb_row * 25, 18, player_colors[i % player_color_count]);
+            sb_row++;
         }
 
         SDL_RenderPresent(rend);
@@ -0,0 +1,49 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "network_arena.h"
+
+// First free address of a block, rounded up to ARENA_ALIGN
+static uintptr_t block_cursor(const ArenaBlock *block) {
+    uintptr_t cursor = (uintptr_t)(block + 1) + block->used;
+    return (cursor + ARENA_ALIGN - 1) & ~(uintptr_t)(ARENA_ALIGN - 1);
+}
+
+void arena_init(Arena *arena, size_t block_size) {
+    arena->blocks = NULL;
+    arena->block_size = block_size ? block_size : ARENA_BLOCK_SIZE;
+    arena->allocated = 0;
+}
+
+void *arena_alloc(Arena *arena, size_t size) {
+    ArenaBlock *block = arena->blocks;
+    uintptr_t base = block ? (uintptr_t)(block + 1) : 0;
+    if (!block || block_cursor(block) + size > base + block->size) {
+        // Slack for aligning the first allocation, whatever malloc returns
+        size_t wanted = size + ARENA_ALIGN > arena->block_size ? size + ARENA_ALIGN : arena->block_size;
+        block = malloc(sizeof(ArenaBlock) + wanted);
+        if (!block) return NULL;
+        block->next = arena->blocks;
+        block->size = wanted;
+        block->used = 0;
+        arena->blocks = block;
+        base = (uintptr_t)(block + 1);
+    }
+
+    uintptr_t start = block_cursor(block);
+    block->used = start + size - base;
+    arena->allocated += size;
+    memset((void *)start, 0, size);
+    return (void *)start;
+}
+
+void arena_free(Arena *arena) {
+    ArenaBlock *block = arena->blocks;
+    while (block) {
+        ArenaBlock *next = block->next;
+        free(block);
+        block = next;
+    }
+    arena->blocks = NULL;
+    arena->allocated = 0;
+}
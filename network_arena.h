@@ -0,0 +1,52 @@
+#ifndef NETWORK_ARENA_H
+#define NETWORK_ARENA_H
+
+#include <stddef.h>
+
+#define ARENA_ALIGN 32                   // Every allocation suits the widest vector load (AVX2)
+#define ARENA_BLOCK_SIZE (64 * 1024)     // Default block; larger requests get a block of their own
+
+// One malloc'd block; allocations follow the header
+typedef struct ArenaBlock {
+    struct ArenaBlock *next;
+    size_t size;            // Usable bytes after the header
+    size_t used;
+} ArenaBlock;
+
+// Bump allocator for storage that lives as long as its owner
+// A room sizes everything from its capacities once, when it is created, so
+// nothing is freed piecemeal: allocation is a pointer bump and the whole
+// arena is released in one call. Blocks are chained, so growing never
+// moves earlier allocations.
+typedef struct {
+    ArenaBlock *blocks;     // Newest first
+    size_t block_size;      // Smallest block to request
+    size_t allocated;       // Bytes handed out
+} Arena;
+
+/**
+ * Start an empty arena; no memory is taken until the first allocation
+ *
+ * @param arena Pointer to Arena
+ * @param block_size Smallest block to request, 0 for ARENA_BLOCK_SIZE
+ */
+void arena_init(Arena *arena, size_t block_size);
+
+/**
+ * Allocate zeroed storage aligned to ARENA_ALIGN
+ *
+ * @param arena Pointer to Arena
+ * @param size Bytes wanted
+ * @return Pointer to the storage, or NULL if allocation failed
+ */
+void *arena_alloc(Arena *arena, size_t size);
+
+/**
+ * Release every allocation at once
+ * The arena is left empty and may be reused
+ *
+ * @param arena Pointer to Arena
+ */
+void arena_free(Arena *arena);
+
+#endif // NETWORK_ARENA_H
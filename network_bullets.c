@@ -0,0 +1,337 @@
+#include <string.h>
+#include "network_bullets.h"
+
+// Vector kernels are compiled for their instruction set with target
+// attributes and chosen at run time, so one build runs on any x86 CPU.
+// Elsewhere only the scalar kernels exist. All kernels do the same float
+// operations in the same order, so results are identical whichever runs.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BULLETS_X86 1
+#include <immintrin.h>
+#endif
+
+static BulletKernel kernel = BULLET_KERNEL_SCALAR;
+
+BulletKernel bullets_select_kernel(BulletKernel requested) {
+    BulletKernel best = BULLET_KERNEL_SCALAR;
+#ifdef BULLETS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2")) best = BULLET_KERNEL_SSE2;
+    if (__builtin_cpu_supports("avx2")) best = BULLET_KERNEL_AVX2;
+#endif
+    kernel = requested < best ? requested : best;
+    return kernel;
+}
+
+const char *bullets_kernel_name(BulletKernel which) {
+    switch (which) {
+        case BULLET_KERNEL_AVX2: return "AVX2";
+        case BULLET_KERNEL_SSE2: return "SSE2";
+        default: return "scalar";
+    }
+}
+
+int bullets_init(BulletSet *set, int slots, Arena *arena) {
+    memset(set, 0, sizeof(BulletSet));
+
+    // Vector kernels load whole vectors up to count rounded up
+    size_t size = sizeof(float) * ((slots + BULLET_LANES - 1) / BULLET_LANES * BULLET_LANES);
+    set->x = arena_alloc(arena, size);
+    set->y = arena_alloc(arena, size);
+    set->vx = arena_alloc(arena, size);
+    set->vy = arena_alloc(arena, size);
+    return set->x && set->y && set->vx && set->vy && pool_init(&set->pool, slots, arena);
+}
+
+void bullets_clear(BulletSet *set) {
+    pool_clear(&set->pool);
+    set->count = 0;
+}
+
+int bullets_spawn(BulletSet *set, float x, float y, float vx, float vy) {
+    EntityId id = pool_alloc(&set->pool);
+    if (id == ENTITY_NONE) return -1;
+
+    int i = set->count++;
+    set->x[i] = x;
+    set->y[i] = y;
+    set->vx[i] = vx;
+    set->vy[i] = vy;
+    return ENTITY_INDEX(id);
+}
+
+int bullets_remove(BulletSet *set, int slot) {
+    int i = pool_release(&set->pool, pool_id(&set->pool, slot));
+    if (i < 0) return 0;
+
+    int last = --set->count;
+    set->x[i] = set->x[last];
+    set->y[i] = set->y[last];
+    set->vx[i] = set->vx[last];
+    set->vy[i] = set->vy[last];
+    return 1;
+}
+
+int bullets_slot(const BulletSet *set, int i) {
+    return set->pool.dense[i];
+}
+
+// ---------------------------------------------------------------------------
+// Scalar kernels
+// ---------------------------------------------------------------------------
+
+static void integrate_scalar(BulletSet *set, float dt) {
+    for (int i = 0; i < set->count; i++) {
+        set->x[i] += set->vx[i] * dt;
+        set->y[i] += set->vy[i] * dt;
+    }
+}
+
+static int outside_scalar(const BulletSet *set, float min_x, float min_y, float max_x, float max_y, int *out) {
+    int count = 0;
+    for (int i = 0; i < set->count; i++) {
+        if (set->x[i] < min_x || set->x[i] > max_x || set->y[i] < min_y || set->y[i] > max_y) out[count++] = i;
+    }
+    return count;
+}
+
+static int overlap_scalar(const BulletSet *set, float w, float h, float tx, float ty, float tr, float tb, int *hits) {
+    int count = 0;
+    for (int i = 0; i < set->count; i++) {
+        if (set->x[i] + w > tx && set->x[i] < tr && set->y[i] + h > ty && set->y[i] < tb) hits[count++] = i;
+    }
+    return count;
+}
+
+static void bounds_scalar(const BulletSet *set, int first, float *lo_x, float *lo_y, float *hi_x, float *hi_y) {
+    for (int i = first; i < set->count; i++) {
+        if (set->x[i] < *lo_x) *lo_x = set->x[i];
+        if (set->x[i] > *hi_x) *hi_x = set->x[i];
+        if (set->y[i] < *lo_y) *lo_y = set->y[i];
+        if (set->y[i] > *hi_y) *hi_y = set->y[i];
+    }
+}
+
+// ---------------------------------------------------------------------------
+// SSE2 and AVX2 kernels
+// Arrays are padded to BULLET_LANES, so whole vectors are always loaded;
+// lanes past count are masked out of every result.
+// ---------------------------------------------------------------------------
+
+#ifdef BULLETS_X86
+
+// Append the indices of the set bits of a lane mask
+static int push_lanes(int mask, int base, int valid, int *out, int count) {
+    mask &= (1 << valid) - 1;
+    while (mask) {
+        int lane = __builtin_ctz(mask);
+        out[count++] = base + lane;
+        mask &= mask - 1;
+    }
+    return count;
+}
+
+__attribute__((target("sse2")))
+static void integrate_sse2(BulletSet *set, float dt) {
+    __m128 step = _mm_set1_ps(dt);
+    for (int i = 0; i < set->count; i += 4) {
+        __m128 x = _mm_add_ps(_mm_load_ps(&set->x[i]), _mm_mul_ps(_mm_load_ps(&set->vx[i]), step));
+        __m128 y = _mm_add_ps(_mm_load_ps(&set->y[i]), _mm_mul_ps(_mm_load_ps(&set->vy[i]), step));
+        _mm_store_ps(&set->x[i], x);
+        _mm_store_ps(&set->y[i], y);
+    }
+}
+
+__attribute__((target("sse2")))
+static int outside_sse2(const BulletSet *set, float min_x, float min_y, float max_x, float max_y, int *out) {
+    __m128 lo_x = _mm_set1_ps(min_x), lo_y = _mm_set1_ps(min_y);
+    __m128 hi_x = _mm_set1_ps(max_x), hi_y = _mm_set1_ps(max_y);
+    int count = 0;
+    for (int i = 0; i < set->count; i += 4) {
+        __m128 x = _mm_load_ps(&set->x[i]);
+        __m128 y = _mm_load_ps(&set->y[i]);
+        __m128 out_x = _mm_or_ps(_mm_cmplt_ps(x, lo_x), _mm_cmpgt_ps(x, hi_x));
+        __m128 out_y = _mm_or_ps(_mm_cmplt_ps(y, lo_y), _mm_cmpgt_ps(y, hi_y));
+        int mask = _mm_movemask_ps(_mm_or_ps(out_x, out_y));
+        if (mask) count = push_lanes(mask, i, set->count - i < 4 ? set->count - i : 4, out, count);
+    }
+    return count;
+}
+
+__attribute__((target("sse2")))
+static int overlap_sse2(const BulletSet *set, float w, float h, float tx, float ty, float tr, float tb, int *hits) {
+    __m128 bw = _mm_set1_ps(w), bh = _mm_set1_ps(h);
+    __m128 left = _mm_set1_ps(tx), top = _mm_set1_ps(ty);
+    __m128 right = _mm_set1_ps(tr), bottom = _mm_set1_ps(tb);
+    int count = 0;
+    for (int i = 0; i < set->count; i += 4) {
+        __m128 x = _mm_load_ps(&set->x[i]);
+        __m128 y = _mm_load_ps(&set->y[i]);
+        __m128 in_x = _mm_and_ps(_mm_cmpgt_ps(_mm_add_ps(x, bw), left), _mm_cmplt_ps(x, right));
+        __m128 in_y = _mm_and_ps(_mm_cmpgt_ps(_mm_add_ps(y, bh), top), _mm_cmplt_ps(y, bottom));
+        int mask = _mm_movemask_ps(_mm_and_ps(in_x, in_y));
+        if (mask) count = push_lanes(mask, i, set->count - i < 4 ? set->count - i : 4, hits, count);
+    }
+    return count;
+}
+
+// Whole vectors only, so padding lanes never count; the rest is left to
+// bounds_scalar. Returns the index it stopped at.
+__attribute__((target("sse2")))
+static int bounds_sse2(const BulletSet *set, float *lo_x, float *lo_y, float *hi_x, float *hi_y) {
+    __m128 min_x = _mm_set1_ps(*lo_x), min_y = _mm_set1_ps(*lo_y);
+    __m128 max_x = _mm_set1_ps(*hi_x), max_y = _mm_set1_ps(*hi_y);
+    int i = 0;
+    for (; i + 4 <= set->count; i += 4) {
+        __m128 x = _mm_load_ps(&set->x[i]);
+        __m128 y = _mm_load_ps(&set->y[i]);
+        min_x = _mm_min_ps(min_x, x);
+        max_x = _mm_max_ps(max_x, x);
+        min_y = _mm_min_ps(min_y, y);
+        max_y = _mm_max_ps(max_y, y);
+    }
+
+    float lanes[4][4];
+    _mm_storeu_ps(lanes[0], min_x);
+    _mm_storeu_ps(lanes[1], min_y);
+    _mm_storeu_ps(lanes[2], max_x);
+    _mm_storeu_ps(lanes[3], max_y);
+    for (int k = 0; k < 4; k++) {
+        if (lanes[0][k] < *lo_x) *lo_x = lanes[0][k];
+        if (lanes[1][k] < *lo_y) *lo_y = lanes[1][k];
+        if (lanes[2][k] > *hi_x) *hi_x = lanes[2][k];
+        if (lanes[3][k] > *hi_y) *hi_y = lanes[3][k];
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+static void integrate_avx2(BulletSet *set, float dt) {
+    __m256 step = _mm256_set1_ps(dt);
+    for (int i = 0; i < set->count; i += 8) {
+        __m256 x = _mm256_add_ps(_mm256_load_ps(&set->x[i]), _mm256_mul_ps(_mm256_load_ps(&set->vx[i]), step));
+        __m256 y = _mm256_add_ps(_mm256_load_ps(&set->y[i]), _mm256_mul_ps(_mm256_load_ps(&set->vy[i]), step));
+        _mm256_store_ps(&set->x[i], x);
+        _mm256_store_ps(&set->y[i], y);
+    }
+}
+
+__attribute__((target("avx2")))
+static int outside_avx2(const BulletSet *set, float min_x, float min_y, float max_x, float max_y, int *out) {
+    __m256 lo_x = _mm256_set1_ps(min_x), lo_y = _mm256_set1_ps(min_y);
+    __m256 hi_x = _mm256_set1_ps(max_x), hi_y = _mm256_set1_ps(max_y);
+    int count = 0;
+    for (int i = 0; i < set->count; i += 8) {
+        __m256 x = _mm256_load_ps(&set->x[i]);
+        __m256 y = _mm256_load_ps(&set->y[i]);
+        __m256 out_x = _mm256_or_ps(_mm256_cmp_ps(x, lo_x, _CMP_LT_OQ), _mm256_cmp_ps(x, hi_x, _CMP_GT_OQ));
+        __m256 out_y = _mm256_or_ps(_mm256_cmp_ps(y, lo_y, _CMP_LT_OQ), _mm256_cmp_ps(y, hi_y, _CMP_GT_OQ));
+        int mask = _mm256_movemask_ps(_mm256_or_ps(out_x, out_y));
+        if (mask) count = push_lanes(mask, i, set->count - i < 8 ? set->count - i : 8, out, count);
+    }
+    return count;
+}
+
+__attribute__((target("avx2")))
+static int overlap_avx2(const BulletSet *set, float w, float h, float tx, float ty, float tr, float tb, int *hits) {
+    __m256 bw = _mm256_set1_ps(w), bh = _mm256_set1_ps(h);
+    __m256 left = _mm256_set1_ps(tx), top = _mm256_set1_ps(ty);
+    __m256 right = _mm256_set1_ps(tr), bottom = _mm256_set1_ps(tb);
+    int count = 0;
+    for (int i = 0; i < set->count; i += 8) {
+        __m256 x = _mm256_load_ps(&set->x[i]);
+        __m256 y = _mm256_load_ps(&set->y[i]);
+        __m256 in_x = _mm256_and_ps(_mm256_cmp_ps(_mm256_add_ps(x, bw), left, _CMP_GT_OQ),
+                                    _mm256_cmp_ps(x, right, _CMP_LT_OQ));
+        __m256 in_y = _mm256_and_ps(_mm256_cmp_ps(_mm256_add_ps(y, bh), top, _CMP_GT_OQ),
+                                    _mm256_cmp_ps(y, bottom, _CMP_LT_OQ));
+        int mask = _mm256_movemask_ps(_mm256_and_ps(in_x, in_y));
+        if (mask) count = push_lanes(mask, i, set->count - i < 8 ? set->count - i : 8, hits, count);
+    }
+    return count;
+}
+
+__attribute__((target("avx2")))
+static int bounds_avx2(const BulletSet *set, float *lo_x, float *lo_y, float *hi_x, float *hi_y) {
+    __m256 min_x = _mm256_set1_ps(*lo_x), min_y = _mm256_set1_ps(*lo_y);
+    __m256 max_x = _mm256_set1_ps(*hi_x), max_y = _mm256_set1_ps(*hi_y);
+    int i = 0;
+    for (; i + 8 <= set->count; i += 8) {
+        __m256 x = _mm256_load_ps(&set->x[i]);
+        __m256 y = _mm256_load_ps(&set->y[i]);
+        min_x = _mm256_min_ps(min_x, x);
+        max_x = _mm256_max_ps(max_x, x);
+        min_y = _mm256_min_ps(min_y, y);
+        max_y = _mm256_max_ps(max_y, y);
+    }
+
+    float lanes[4][8];
+    _mm256_storeu_ps(lanes[0], min_x);
+    _mm256_storeu_ps(lanes[1], min_y);
+    _mm256_storeu_ps(lanes[2], max_x);
+    _mm256_storeu_ps(lanes[3], max_y);
+    for (int k = 0; k < 8; k++) {
+        if (lanes[0][k] < *lo_x) *lo_x = lanes[0][k];
+        if (lanes[1][k] < *lo_y) *lo_y = lanes[1][k];
+        if (lanes[2][k] > *hi_x) *hi_x = lanes[2][k];
+        if (lanes[3][k] > *hi_y) *hi_y = lanes[3][k];
+    }
+    return i;
+}
+
+#endif // BULLETS_X86
+
+// ---------------------------------------------------------------------------
+// Dispatch
+// ---------------------------------------------------------------------------
+
+void bullets_integrate(BulletSet *set, float delta_time) {
+#ifdef BULLETS_X86
+    if (kernel == BULLET_KERNEL_AVX2) { integrate_avx2(set, delta_time); return; }
+    if (kernel == BULLET_KERNEL_SSE2) { integrate_sse2(set, delta_time); return; }
+#endif
+    integrate_scalar(set, delta_time);
+}
+
+int bullets_cull(BulletSet *set, float min_x, float min_y, float max_x, float max_y, int *removed) {
+    // Dense indices first, turned into slots in place as bullets go
+    int count;
+#ifdef BULLETS_X86
+    if (kernel == BULLET_KERNEL_AVX2) count = outside_avx2(set, min_x, min_y, max_x, max_y, removed);
+    else if (kernel == BULLET_KERNEL_SSE2) count = outside_sse2(set, min_x, min_y, max_x, max_y, removed);
+    else
+#endif
+    count = outside_scalar(set, min_x, min_y, max_x, max_y, removed);
+
+    // Highest index first: what moves into a freed index is never itself outside
+    for (int k = count - 1; k >= 0; k--) {
+        removed[k] = bullets_slot(set, removed[k]);
+        bullets_remove(set, removed[k]);
+    }
+    return count;
+}
+
+int bullets_overlap(const BulletSet *set, float w, float h, float tx, float ty, float tw, float th, int *hits) {
+    float tr = tx + tw;
+    float tb = ty + th;
+#ifdef BULLETS_X86
+    if (kernel == BULLET_KERNEL_AVX2) return overlap_avx2(set, w, h, tx, ty, tr, tb, hits);
+    if (kernel == BULLET_KERNEL_SSE2) return overlap_sse2(set, w, h, tx, ty, tr, tb, hits);
+#endif
+    return overlap_scalar(set, w, h, tx, ty, tr, tb, hits);
+}
+
+int bullets_bounds(const BulletSet *set, float *min_x, float *min_y, float *max_x, float *max_y) {
+    if (set->count == 0) return 0;
+
+    // Seeded with a real bullet, so min and max pick the same values in any order
+    *min_x = *max_x = set->x[0];
+    *min_y = *max_y = set->y[0];
+    int first = 1;
+#ifdef BULLETS_X86
+    if (kernel == BULLET_KERNEL_AVX2) first = bounds_avx2(set, min_x, min_y, max_x, max_y);
+    else if (kernel == BULLET_KERNEL_SSE2) first = bounds_sse2(set, min_x, min_y, max_x, max_y);
+#endif
+    bounds_scalar(set, first, min_x, min_y, max_x, max_y);
+    return 1;
+}
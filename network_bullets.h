@@ -0,0 +1,145 @@
+#ifndef NETWORK_BULLETS_H
+#define NETWORK_BULLETS_H
+
+#include "network_common.h"
+#include "network_pool.h"
+#include "network_arena.h"
+
+#define BULLET_LANES 8  // Widest vector (AVX2, 8 floats); arrays are padded to a multiple of it
+
+// Kernel implementations, best last
+typedef enum {
+    BULLET_KERNEL_SCALAR,
+    BULLET_KERNEL_SSE2,
+    BULLET_KERNEL_AVX2
+} BulletKernel;
+
+// Server-side projectiles of one owner as dense structure-of-arrays
+// Live bullets are packed at the front, so every pass touches only them
+// and runs a whole vector of bullets per step. Each bullet keeps the slot
+// number the wire protocol knows it by; the pool hands slots out and keeps
+// its dense order in step with these arrays, so removal swaps the last
+// bullet in.
+typedef struct {
+    float *x;                           // Arena storage, 32-byte aligned and
+    float *y;                           // padded to a multiple of BULLET_LANES
+    float *vx;
+    float *vy;
+    EntityPool pool;                    // Wire slots; pool.dense[i] is the slot of bullet i
+    int count;                          // Live bullets
+} BulletSet;
+
+/**
+ * Pick the kernels used by every BulletSet
+ * Falls back to the best the CPU supports if the requested one is not
+ *
+ * @param requested Preferred implementation
+ * @return Implementation in use
+ */
+BulletKernel bullets_select_kernel(BulletKernel requested);
+
+/**
+ * Name of a kernel implementation, for logs
+ *
+ * @param kernel Implementation
+ * @return Static string
+ */
+const char *bullets_kernel_name(BulletKernel kernel);
+
+/**
+ * Allocate an empty set
+ *
+ * @param set Pointer to BulletSet
+ * @param slots Wire slots available
+ * @param arena Arena the arrays are taken from
+ * @return 1 on success, 0 if allocation failed
+ */
+int bullets_init(BulletSet *set, int slots, Arena *arena);
+
+/**
+ * Remove every bullet
+ *
+ * @param set Pointer to BulletSet
+ */
+void bullets_clear(BulletSet *set);
+
+/**
+ * Add a bullet in a free slot
+ *
+ * @param set Pointer to BulletSet
+ * @param x Position
+ * @param y Position
+ * @param vx Velocity in pixels per second
+ * @param vy Velocity in pixels per second
+ * @return Slot used, or -1 if every slot is taken
+ */
+int bullets_spawn(BulletSet *set, float x, float y, float vx, float vy);
+
+/**
+ * Remove the bullet in a wire slot
+ * The last bullet moves into its dense position
+ *
+ * @param set Pointer to BulletSet
+ * @param slot Wire slot
+ * @return 1 if a bullet was removed, 0 if the slot was already free
+ */
+int bullets_remove(BulletSet *set, int slot);
+
+/**
+ * Wire slot of the bullet at a dense index
+ *
+ * @param set Pointer to BulletSet
+ * @param i Dense index, below count
+ * @return Slot number
+ */
+int bullets_slot(const BulletSet *set, int i);
+
+/**
+ * Advance every bullet by its velocity
+ *
+ * @param set Pointer to BulletSet
+ * @param delta_time Seconds
+ */
+void bullets_integrate(BulletSet *set, float delta_time);
+
+/**
+ * Remove bullets whose position left a rectangle
+ *
+ * @param set Pointer to BulletSet
+ * @param min_x Smallest x kept
+ * @param min_y Smallest y kept
+ * @param max_x Largest x kept
+ * @param max_y Largest y kept
+ * @param removed Receives the slots of removed bullets (pool.capacity entries)
+ * @return Number of bullets removed
+ */
+int bullets_cull(BulletSet *set, float min_x, float min_y, float max_x, float max_y, int *removed);
+
+/**
+ * Find the bullets whose boxes overlap a target box
+ *
+ * @param set Pointer to BulletSet
+ * @param w Bullet width
+ * @param h Bullet height
+ * @param tx Target left edge
+ * @param ty Target top edge
+ * @param tw Target width
+ * @param th Target height
+ * @param hits Receives dense indices in ascending order (pool.capacity entries)
+ * @return Number of overlapping bullets
+ */
+int bullets_overlap(const BulletSet *set, float w, float h, float tx, float ty, float tw, float th, int *hits);
+
+/**
+ * Smallest box holding the top-left corners of every bullet
+ *
+ * @param set Pointer to BulletSet
+ * @param min_x Receives the smallest x
+ * @param min_y Receives the smallest y
+ * @param max_x Receives the largest x
+ * @param max_y Receives the largest y
+ * @return 1 if the set has bullets, 0 if it is empty and nothing was written
+ */
+int bullets_bounds(const BulletSet *set, float *min_x, float *min_y, float *max_x, float *max_y);
+
+#endif // NETWORK_BULLETS_H
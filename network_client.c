@@ -2,6 +2,8 @@
 #include <string.h>
 #include <SDL2/SDL_net.h>
 #include "network_client.h"
+#include "network_codec.h"
+#include "network_compress.h"
 
 int client_init(NetworkClient *client, const char *host, int port) {
     if (SDLNet_Init() < 0) {
@@ -39,7 +41,30 @@ int client_init(NetworkClient *client, const char *host, int port) {
     // Initialize client state
     client->connected = 0;
     client->player_id = -1;
-    memset(&client->game_state, 0, sizeof(GameState));
+    arena_init(&client->arena, 0);
+    memset(&client->game_state, 0, sizeof(GameState));  // No entities until a room is joined
+    reassembly_init(&client->reassembly);
+    reliable_init(&client->reliable);
+    client->event_head = 0;
+    client->event_count = 0;
+    client->compression = COMPRESSION_RANGE;
+    client->compressed_bytes = 0;
+    client->decompressed_bytes = 0;
+    client->decompress_ticks = 0;
+    client->decompressed_count = 0;
+    compress_init();
+    client->acked_tick = 0;
+    client->ack_bits = 0;
+    client->input_sequence = 0;
+    client->input_accumulator = 0;
+    memset(client->input_history, 0, sizeof(client->input_history));
+    memset(&client->last_sent_input, 0, sizeof(PlayerInput));
+    client->ticks_since_send = 0;
+    client->acked_time = 0;
+    client->input_packets = 0;
+    client->tick_rate = TICK_RATE;
+    prediction_init(&client->prediction, client->tick_rate);
+    interpolation_init(&client->interpolation, client->tick_rate);
     client->last_update = SDL_GetTicks();
 
     printf("[CLIENT] Network initialized successfully\n");
@@ -48,6 +73,20 @@ int client_init(NetworkClient *client, const char *host, int port) {
     return 1;
 }
 
+// Size the game state, snapshot history and projectile table for the room
+static int init_room(NetworkClient *client, const RoomCapacity *capacity) {
+    arena_free(&client->arena);
+    if (!game_state_init(&client->game_state, capacity, 1, &client->arena) ||
+        !snapshot_ring_init(&client->snapshots, capacity, &client->arena) ||
+        !projectile_table_init(&client->projectiles, capacity, &client->arena) ||
+        !pool_init(&client->explosion_pool, capacity->explosions, &client->arena)) {
+        arena_free(&client->arena);
+        memset(&client->game_state, 0, sizeof(GameState));
+        return 0;
+    }
+    return 1;
+}
+
 int client_connect(NetworkClient *client) {
     if (!client->socket || !client->packet) {
         printf("[CLIENT ERROR] Client not initialized\n");
@@ -63,10 +102,10 @@ int client_connect(NetworkClient *client) {
     connect_pkt.header.sequence = 0;
     strncpy(connect_pkt.player_name, "Player", sizeof(connect_pkt.player_name) - 1);
     connect_pkt.player_name[sizeof(connect_pkt.player_name) - 1] = '\0';
+    connect_pkt.compression = client->compression;
 
-    // Copy packet data
-    memcpy(client->packet->data, &connect_pkt, sizeof(ConnectPacket));
-    client->packet->len = sizeof(ConnectPacket);
+    // Encode packet data
+    client->packet->len = codec_write_connect(client->packet->data, client->packet->maxlen, &connect_pkt);
     client->packet->address = client->server_address;
 
     // Send connection request
@@ -95,18 +134,33 @@ int client_connect(NetworkClient *client) {
 
         // Check for response
         if (SDLNet_UDP_Recv(client->socket, client->packet)) {
-            PacketHeader *header = (PacketHeader *)client->packet->data;
+            ConnectResponse response;
+            if (!codec_read_connect_response(client->packet->data, client->packet->len, &response)) {
+                continue;
+            }
             
-            if (header->type == PACKET_CONNECT) {
-                ConnectResponse *response = (ConnectResponse *)client->packet->data;
-                
-                if (response->success) {
-                    client->player_id = response->assigned_id;
+            if (response.header.type == PACKET_CONNECT) {
+                if (response.success) {
+                    if (!init_room(client, &response.capacity)) {
+                        printf("[CLIENT ERROR] Failed to allocate room state\n");
+                        return 0;
+                    }
+                    client->player_id = response.assigned_id;
+                    client->compression = response.compression;
+                    client->tick_rate = response.tick_rate > 0 ? response.tick_rate : TICK_RATE;
                     client->connected = 1;
                     client->last_update = SDL_GetTicks();
+                    client->last_input_time = client->last_update;
+                    client->input_accumulator = 1.0f / client->tick_rate;  // First input goes out immediately
+                    prediction_init(&client->prediction, client->tick_rate);
+                    interpolation_init(&client->interpolation, client->tick_rate);
                     
                     printf("[CLIENT SUCCESS] Connected to server!\n");
                     printf("[CLIENT] Assigned Player ID: %d\n", client->player_id);
+                    printf("[CLIENT] Server tick rate: %d Hz\n", client->tick_rate);
+                    printf("[CLIENT] Room: %d players | %d enemies | %d bullets per player | %d enemy bullets\n",
+                           response.capacity.players, response.capacity.enemies,
+                           response.capacity.bullets_per_player, response.capacity.enemy_bullets);
                     return 1;
                 } else {
                     printf("[CLIENT ERROR] Server rejected connection (server full?)\n");
@@ -128,30 +182,254 @@ int client_connect(NetworkClient *client) {
     return 0;
 }
 
-void client_send_input(NetworkClient *client, PlayerInput *input) {
-    if (!client->connected || !client->socket || !client->packet) {
-        return;
-    }
+static void send_input_packet(NetworkClient *client) {
+    Uint32 now = SDL_GetTicks();
 
-    // Prepare input packet
+    // Prepare input packet: the newest inputs, newest first
     InputPacket input_pkt;
     input_pkt.header.type = PACKET_INPUT;
     input_pkt.header.player_id = client->player_id;
-    input_pkt.header.sequence = SDL_GetTicks();
-    input_pkt.input = *input;
-    input_pkt.input.player_id = client->player_id; // Ensure consistency
+    input_pkt.header.sequence = client->input_sequence;
+    input_pkt.input_count = client->input_sequence < INPUT_REDUNDANCY ? (int)client->input_sequence : INPUT_REDUNDANCY;
+    for (int i = 0; i < input_pkt.input_count; i++) {
+        input_pkt.inputs[i] = client->input_history[(client->input_sequence - i) % INPUT_REDUNDANCY];
+    }
+    input_pkt.ack_tick = client->acked_tick;
+    input_pkt.ack_delay = client->acked_tick ? now - client->acked_time : 0;
+    input_pkt.ack_bits = client->ack_bits;
+    input_pkt.view_lag = 0;
+    if (client->interpolation.started && client->interpolation.render_tick < client->acked_tick) {
+        input_pkt.view_lag = (Uint32)((client->acked_tick - client->interpolation.render_tick) * 8.0);
+    }
+    reliable_collect(&client->reliable, now, &input_pkt.reliable);
 
-    // Copy packet data
-    memcpy(client->packet->data, &input_pkt, sizeof(InputPacket));
-    client->packet->len = sizeof(InputPacket);
+    // Encode packet data
+    client->packet->len = codec_write_input(client->packet->data, client->packet->maxlen, &input_pkt);
     client->packet->address = client->server_address;
 
+    client->last_sent_input = input_pkt.inputs[0];
+    client->ticks_since_send = 0;
+    client->input_packets++;
+
     // Send input (fire and forget - UDP)
     if (!SDLNet_UDP_Send(client->socket, -1, client->packet)) {
         printf("[CLIENT WARNING] Failed to send input packet: %s\n", SDLNet_GetError());
     }
 }
 
+// Show the local player where its own inputs have already taken it
+static void present_local_player(NetworkClient *client) {
+    GameState *state = &client->game_state;
+    if (client->player_id < 0 || client->player_id >= state->capacity.players) return;
+    prediction_present(&client->prediction, &state->players[client->player_id],
+                       game_state_player_bullets(state, client->player_id), state->capacity.bullets_per_player);
+}
+
+void client_send_input(NetworkClient *client, PlayerInput *input) {
+    if (!client->connected || !client->socket || !client->packet) {
+        return;
+    }
+
+    // The server applies one input per tick, so produce exactly that many
+    // regardless of frame rate; after a long stall, catch up a few ticks only
+    Uint32 now = SDL_GetTicks();
+    client->input_accumulator += (now - client->last_input_time) / 1000.0f;
+    client->last_input_time = now;
+    float tick_time = 1.0f / client->tick_rate;
+    if (client->input_accumulator > 5.0f * tick_time) client->input_accumulator = 5.0f * tick_time;
+
+    while (client->input_accumulator >= tick_time) {
+        client->input_accumulator -= tick_time;
+
+        PlayerInput *current = &client->input_history[++client->input_sequence % INPUT_REDUNDANCY];
+        *current = *input;
+        current->player_id = client->player_id; // Ensure consistency
+        client->ticks_since_send++;
+        prediction_apply(&client->prediction, client->input_sequence, current);
+
+        // The server repeats the last input it has, so unchanged ticks need no packet
+        if (client->input_sequence == 1 ||
+            !codec_same_input(current, &client->last_sent_input) ||
+            client->ticks_since_send >= INPUT_HEARTBEAT_TICKS ||
+            client->reliable.ack_pending) {
+            send_input_packet(client);
+        }
+    }
+
+    present_local_player(client);
+}
+
+// Decode one complete game state packet into the snapshot ring
+// Returns 1 if it produced a new current state
+static int handle_state_packet(NetworkClient *client, const Uint8 *data, int size) {
+    GameStatePacket state_pkt;
+    int payload_offset;
+    if (!codec_read_state_packet(data, size, &state_pkt, &payload_offset)) {
+        return 0;
+    }
+    if (state_pkt.header.type != PACKET_GAME_STATE) return 0;
+
+    // Reliable events ride on every snapshot, including ones too stale to decode
+    reliable_receive(&client->reliable, &state_pkt.reliable);
+
+    // Ignore duplicates and snapshots older than the one we have, but let
+    // the server know they arrived
+    if (state_pkt.tick <= client->acked_tick) {
+        Uint32 distance = client->acked_tick - state_pkt.tick;
+        if (distance >= 1 && distance <= 32) client->ack_bits |= 1u << (distance - 1);
+        return 0;
+    }
+
+    // Undo the range coder so the rest reads the plain payload
+    const Uint8 *payload = data + payload_offset;
+    int payload_size = size - payload_offset;
+    if (state_pkt.compressed) {
+        Uint64 start = SDL_GetPerformanceCounter();
+        int decoded_size = compress_decode(payload, payload_size, client->decompressed, MAX_MESSAGE_SIZE);
+        client->decompress_ticks += SDL_GetPerformanceCounter() - start;
+        if (decoded_size < 0) return 0;
+        client->compressed_bytes += payload_size;
+        client->decompressed_bytes += decoded_size;
+        client->decompressed_count++;
+        payload = client->decompressed;
+        payload_size = decoded_size;
+    }
+
+    // Deltas need their baseline; drop the packet if we no longer have it
+    const GameState *baseline = NULL;
+    if (state_pkt.baseline_tick != 0) {
+        baseline = snapshot_ring_find(&client->snapshots, state_pkt.baseline_tick);
+        if (!baseline) return 0;
+        if (state_pkt.baseline_tick % SNAPSHOT_RING_SIZE == state_pkt.tick % SNAPSHOT_RING_SIZE) return 0;
+    }
+
+    // Decode straight into the ring slot for this tick
+    GameState *decoded = snapshot_ring_claim(&client->snapshots, state_pkt.tick);
+    int state_size = codec_read_state(payload, payload_size, baseline, decoded);
+    if (state_size < 0) {
+        return 0;
+    }
+
+    // Projectile events the server has not seen us acknowledge follow the state
+    ProjectileResync resync;
+    Uint32 last_sequence;
+    int event_count = codec_read_projectile_events(payload + state_size,
+                                                   payload_size - state_size, state_pkt.tick,
+                                                   &resync, &last_sequence,
+                                                   client->event_batch, PROJECTILE_BATCH_MAX);
+    if (event_count < 0) {
+        return 0;
+    }
+    decoded->tick = state_pkt.tick;
+    snapshot_ring_commit(&client->snapshots, state_pkt.tick);
+    interpolation_on_snapshot(&client->interpolation, state_pkt.tick, SDL_GetTicks());
+
+    // A resync from slot 0 starts over; later ones replace their range once
+    // the logged events have caught the rest of the table up
+    int restart = resync.active && resync.first == 0;
+    if (restart) {
+        projectile_table_clear(&client->projectiles);
+    }
+    int logged = event_count - resync.spawns;
+    for (int i = 0; i < logged; i++) {
+        const ProjectileEvent *event = &client->event_batch[i];
+        if (event->sequence > client->projectiles.last_sequence) {
+            projectile_table_apply(&client->projectiles, event);
+        }
+    }
+    if (resync.active) {
+        projectile_table_clear_range(&client->projectiles, resync.first, resync.end);
+        for (int i = logged; i < event_count; i++) {
+            projectile_table_apply(&client->projectiles, &client->event_batch[i]);
+        }
+    }
+    if (restart || last_sequence > client->projectiles.last_sequence) {
+        client->projectiles.last_sequence = last_sequence;
+    }
+
+    // Newest state, with bullets simulated from their spawn events; the
+    // frame's view is rebuilt from the ring by update_view()
+    game_state_copy(&client->game_state, decoded);
+    projectile_table_fill(&client->projectiles, &client->game_state, state_pkt.tick, client->tick_rate);
+    Uint32 advance = state_pkt.tick - client->acked_tick;
+    if (client->acked_tick == 0 || advance > 32) {
+        client->ack_bits = 0;
+    } else {
+        client->ack_bits = (advance < 32 ? client->ack_bits << advance : 0) | 1u << (advance - 1);
+    }
+    client->acked_tick = state_pkt.tick;
+    client->last_update = SDL_GetTicks();
+    client->acked_time = client->last_update;
+
+    // Rewind the local player to the server's result and replay newer inputs
+    if (client->player_id >= 0 && client->player_id < client->game_state.capacity.players) {
+        prediction_reconcile(&client->prediction, &client->game_state.players[client->player_id], state_pkt.input_ack);
+        present_local_player(client);
+    }
+    return 1;
+}
+
+// Rebuild the displayed state for this frame: remote entities a little in
+// the past between two snapshots, the local player at its predicted present
+static void update_view(NetworkClient *client) {
+    double render_tick = interpolation_advance(&client->interpolation, SDL_GetTicks());
+    if (!interpolation_sample(&client->interpolation, &client->snapshots, &client->projectiles,
+                              render_tick, &client->game_state)) {
+        return;
+    }
+    present_local_player(client);
+}
+
+// Start an explosion animation in a free local slot (dropped if all are playing)
+static void start_explosion(NetworkClient *client, float x, float y) {
+    EntityId id = pool_alloc(&client->explosion_pool);
+    if (id == ENTITY_NONE) return;
+
+    NetworkExplosion *explosion = &client->game_state.explosions[ENTITY_INDEX(id)];
+    explosion->active = 1;
+    explosion->x = x;
+    explosion->y = y;
+    explosion->start_time = SDL_GetTicks();
+}
+
+// Move delivered reliable events into the application queue
+static void dispatch_events(NetworkClient *client) {
+    GameEvent event;
+    while (reliable_poll(&client->reliable, &event)) {
+        if (event.type == EVENT_EXPLOSION) {
+            start_explosion(client, event.x, event.y);
+        }
+
+        // Overwrite the oldest event if the application is not polling
+        if (client->event_count == CLIENT_EVENT_QUEUE) {
+            client->event_head = (client->event_head + 1) % CLIENT_EVENT_QUEUE;
+            client->event_count--;
+        }
+        client->events[(client->event_head + client->event_count) % CLIENT_EVENT_QUEUE] = event;
+        client->event_count++;
+    }
+
+    // Expire finished explosions
+    Uint32 now = SDL_GetTicks();
+    EntityPool *pool = &client->explosion_pool;
+    for (int k = pool->count - 1; k >= 0; k--) {
+        int i = pool->dense[k];
+        if (now - client->game_state.explosions[i].start_time > EXPLOSION_DURATION) {
+            client->game_state.explosions[i].active = 0;
+            pool_release(pool, pool_id(pool, i));
+        }
+    }
+}
+
+int client_poll_event(NetworkClient *client, GameEvent *event) {
+    if (client->event_count == 0) return 0;
+
+    *event = client->events[client->event_head];
+    client->event_head = (client->event_head + 1) % CLIENT_EVENT_QUEUE;
+    client->event_count--;
+    return 1;
+}
+
 int client_receive_state(NetworkClient *client) {
     if (!client->connected || !client->socket || !client->packet) {
         return 0;
@@ -162,20 +440,28 @@ int client_receive_state(NetworkClient *client) {
     
     // Process all available packets (drain the receive buffer)
     while (SDLNet_UDP_Recv(client->socket, client->packet)) {
-        PacketHeader *header = (PacketHeader *)client->packet->data;
+        PacketHeader header;
+        if (!codec_read_header(client->packet->data, client->packet->len, &header)) continue;
         
-        switch (header->type) {
-            case PACKET_GAME_STATE: {
-                GameStatePacket *state_pkt = (GameStatePacket *)client->packet->data;
-                
-                // Update game state
-                client->game_state = state_pkt->state;
-                client->last_update = SDL_GetTicks();
-                received = 1;
-                packets_this_frame++;
+        switch (header.type) {
+            case PACKET_GAME_STATE:
+                if (handle_state_packet(client, client->packet->data, client->packet->len)) {
+                    received = 1;
+                    packets_this_frame++;
+                }
+                break;
+
+            case PACKET_FRAGMENT: {
+                const Uint8 *message;
+                int size = reassembly_add(&client->reassembly, client->packet->data,
+                                          client->packet->len, &message);
+                if (size > 0 && handle_state_packet(client, message, size)) {
+                    received = 1;
+                    packets_this_frame++;
+                }
                 break;
             }
-            
+
             case PACKET_DISCONNECT: {
                 printf("[CLIENT] Server requested disconnect\n");
                 client->connected = 0;
@@ -188,6 +474,9 @@ int client_receive_state(NetworkClient *client) {
         }
     }
 
+    update_view(client);
+    dispatch_events(client);
+
     // Debug: Log if we received multiple state packets in one frame
     if (packets_this_frame > 1) {
         // This is normal for UDP - we might receive multiple buffered packets
@@ -216,8 +505,7 @@ void client_disconnect(NetworkClient *client) {
     disconnect_pkt.player_id = client->player_id;
     disconnect_pkt.sequence = SDL_GetTicks();
 
-    memcpy(client->packet->data, &disconnect_pkt, sizeof(PacketHeader));
-    client->packet->len = sizeof(PacketHeader);
+    client->packet->len = codec_write_header(client->packet->data, client->packet->maxlen, &disconnect_pkt);
     client->packet->address = client->server_address;
 
     // Send disconnect notification (try a few times)
@@ -252,6 +540,9 @@ void client_cleanup(NetworkClient *client) {
         client->socket = NULL;
     }
 
+    arena_free(&client->arena);
+    memset(&client->game_state, 0, sizeof(GameState));
+
     // Shutdown SDL_net
     SDLNet_Quit();
 
@@ -304,8 +595,27 @@ void client_print_stats(NetworkClient *client) {
     printf("  Enemies: %d\n", client->game_state.enemy_count);
     printf("  Enemy Bullets: %d\n", client->game_state.enemy_bullet_count);
     printf("  Server Tick: %u\n", client->game_state.tick);
+    printf("  Fragments: %u received | %u messages reassembled | %u dropped\n",
+           client->reassembly.fragments_received,
+           client->reassembly.messages_completed,
+           client->reassembly.messages_dropped);
+    printf("  Reliable Events: %u received\n", client->reliable.messages_received);
+    printf("  Interpolation: delay %.1f ticks (spacing %.1f, jitter %.2f) | %u frames | %u extrapolated | %u frozen | %u resyncs\n",
+           client->interpolation.delay, client->interpolation.spacing, client->interpolation.jitter,
+           client->interpolation.frames, client->interpolation.extrapolated,
+           client->interpolation.frozen, client->interpolation.resyncs);
+    printf("  Prediction: %u reconciliations | %u mispredicted | %u inputs replayed | last error %.1f px\n",
+           client->prediction.reconciled, client->prediction.mispredicted,
+           client->prediction.replayed, client->prediction.last_error);
+    if (client->decompressed_bytes > 0) {
+        printf("  Compression: %u -> %u payload bytes (%.1f%% saved) | Decode: %.2f us/snapshot\n",
+               client->decompressed_bytes,
+               client->compressed_bytes,
+               100.0 * (client->decompressed_bytes - client->compressed_bytes) / client->decompressed_bytes,
+               1e6 * client->decompress_ticks / SDL_GetPerformanceFrequency() / client->decompressed_count);
+    }
     
-    if (client->player_id >= 0 && client->player_id < MAX_PLAYERS) {
+    if (client->player_id >= 0 && client->player_id < client->game_state.capacity.players) {
         NetworkPlayer *p = &client->game_state.players[client->player_id];
         if (p->active) {
             printf("  Your Score: %d\n", p->score);
@@ -3,6 +3,17 @@
 
 #include <SDL2/SDL_net.h>
 #include "network_common.h"
+#include "network_delta.h"
+#include "network_fragment.h"
+#include "network_projectile.h"
+#include "network_reliable.h"
+#include "network_prediction.h"
+#include "network_interpolation.h"
+#include "network_pool.h"
+#include "network_arena.h"
+
+#define CLIENT_EVENT_QUEUE 64  // Reliable events waiting for client_poll_event()
+#define INPUT_HEARTBEAT_TICKS 4  // Longest gap between input packets while controls are unchanged
 
 typedef struct {
     UDPsocket socket;
@@ -10,7 +21,36 @@ typedef struct {
     IPaddress server_address;
     int player_id;
     int connected;
-    GameState game_state;
+    Arena arena;             // Everything sized by the room, allocated once connected
+    GameState game_state;    // What to draw: remote entities interpolated, local player predicted
+    SnapshotRing snapshots;  // Decoded states kept as delta baselines and for interpolation
+    Interpolator interpolation;
+    Uint32 acked_tick;       // Latest tick decoded, echoed back to the server
+    Uint32 ack_bits;         // Bit i: tick acked_tick - 1 - i also arrived
+    int tick_rate;           // Server simulation ticks per second, from the connect response
+    Uint32 input_sequence;   // Client input tick, one input per simulation tick
+    float input_accumulator; // Seconds of input time not yet turned into ticks
+    Uint32 last_input_time;
+    PlayerInput input_history[INPUT_REDUNDANCY];  // Indexed by input tick % INPUT_REDUNDANCY
+    PlayerInput last_sent_input;
+    int ticks_since_send;    // Input ticks since the last input packet
+    Uint32 acked_time;       // When acked_tick was decoded, for the ack delay
+    Uint32 input_packets;    // Input packets sent
+    Prediction prediction;   // Local player runs ahead of the snapshots
+    ReassemblyBuffer reassembly;  // Snapshots larger than NET_MTU arrive in fragments
+    ProjectileTable projectiles;  // Bullets simulated locally from spawn events
+    ProjectileEvent event_batch[PROJECTILE_BATCH_MAX];
+    ReliableEndpoint reliable;    // Joins, leaves, deaths, respawns and explosions
+    GameEvent events[CLIENT_EVENT_QUEUE];
+    int event_head;
+    int event_count;
+    EntityPool explosion_pool;    // Which game_state.explosions slots are playing
+    int compression;              // Requested before connecting, then what the server chose
+    Uint8 decompressed[MAX_MESSAGE_SIZE];
+    Uint32 compressed_bytes;      // Compressed payload bytes received
+    Uint32 decompressed_bytes;    // The same payloads after decoding
+    Uint64 decompress_ticks;      // Performance counter ticks spent decoding
+    Uint32 decompressed_count;    // Compressed snapshots decoded
     Uint32 last_update;
 } NetworkClient;
 
@@ -26,7 +66,8 @@ int client_init(NetworkClient *client, const char *host, int port);
 
 /**
  * Connect to server
- * Sends connection request and waits for response
+ * Sends connection request and waits for response, then allocates the
+ * game state and history for the capacities of the room joined
  * 
  * @param client Pointer to initialized NetworkClient
  * @return 1 on success, 0 on failure
@@ -35,7 +76,11 @@ int client_connect(NetworkClient *client);
 
 /**
  * Send player input to server
- * Called every frame with current input state
+ * Called every frame with current input state; the controls are sampled
+ * into one input per simulation tick, numbered by input_sequence. A packet
+ * goes out only when the controls change, every INPUT_HEARTBEAT_TICKS, or
+ * when reliable messages need acknowledging, and repeats the last
+ * INPUT_REDUNDANCY inputs so single losses cost nothing
  * 
  * @param client Pointer to connected NetworkClient
  * @param input Pointer to PlayerInput structure with current controls
@@ -45,12 +90,24 @@ void client_send_input(NetworkClient *client, PlayerInput *input);
 /**
  * Receive game state from server
  * Should be called every frame to get latest game state
+ * Snapshots arrive as deltas against the last acknowledged tick
  * 
  * @param client Pointer to connected NetworkClient
  * @return 1 if new state received, 0 otherwise
  */
 int client_receive_state(NetworkClient *client);
 
+/**
+ * Take the next reliable game event received from the server
+ * Events arrive exactly once and in the order the server raised them;
+ * explosions are also added to game_state.explosions automatically
+ *
+ * @param client Pointer to connected NetworkClient
+ * @param event Receives the event
+ * @return 1 if an event was returned, 0 if the queue is empty
+ */
+int client_poll_event(NetworkClient *client, GameEvent *event);
+
 /**
  * Disconnect from server
  * Sends disconnect notification and closes connection
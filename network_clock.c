@@ -0,0 +1,77 @@
+#ifdef __linux__
+#define _GNU_SOURCE  // clock_gettime
+#include <time.h>
+#endif
+#include <string.h>
+#include "network_clock.h"
+
+Uint64 clock_now_ns(void) {
+#ifdef __linux__
+    // SDL's counter may be CLOCK_MONOTONIC_RAW, which timers cannot be armed on
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (Uint64)now.tv_sec * 1000000000ull + (Uint64)now.tv_nsec;
+#else
+    static Uint64 frequency = 0;
+    if (!frequency) frequency = SDL_GetPerformanceFrequency();
+
+    Uint64 counter = SDL_GetPerformanceCounter();
+    if (frequency == 1000000000ull) return counter;
+    return (counter / frequency) * 1000000000ull + (counter % frequency) * 1000000000ull / frequency;
+#endif
+}
+
+void tick_scheduler_reset_stats(TickScheduler *scheduler) {
+    scheduler->stats_start_ns = clock_now_ns();
+    scheduler->ticks = 0;
+    scheduler->caught_up = 0;
+    scheduler->dropped = 0;
+    scheduler->lateness_sum_ns = 0;
+    scheduler->lateness_max_ns = 0;
+    scheduler->interval_min_ns = 0;
+    scheduler->interval_max_ns = 0;
+}
+
+void tick_scheduler_init(TickScheduler *scheduler, int rate_hz) {
+    memset(scheduler, 0, sizeof(TickScheduler));
+    scheduler->interval_ns = 1000000000ull / (Uint64)rate_hz;
+    scheduler->next_ns = clock_now_ns();
+    tick_scheduler_reset_stats(scheduler);
+}
+
+void tick_scheduler_restart(TickScheduler *scheduler) {
+    scheduler->next_ns = clock_now_ns();
+    scheduler->last_ns = 0;
+}
+
+int tick_scheduler_advance(TickScheduler *scheduler, Uint64 now) {
+    Uint64 lateness = now - scheduler->next_ns;
+    scheduler->lateness_sum_ns += lateness;
+    if (lateness > scheduler->lateness_max_ns) scheduler->lateness_max_ns = lateness;
+
+    if (scheduler->last_ns) {
+        Uint64 interval = now - scheduler->last_ns;
+        if (!scheduler->interval_min_ns || interval < scheduler->interval_min_ns) scheduler->interval_min_ns = interval;
+        if (interval > scheduler->interval_max_ns) scheduler->interval_max_ns = interval;
+    }
+    scheduler->last_ns = now;
+
+    // Every deadline that has passed is a tick owed
+    Uint64 due = 1 + lateness / scheduler->interval_ns;
+    if (due > MAX_CATCH_UP_TICKS) {
+        // Rebase so the ticks run now end at now, making the next one due an
+        // interval from now rather than MAX_CATCH_UP_TICKS intervals
+        scheduler->dropped += (Uint32)(due - MAX_CATCH_UP_TICKS);
+        due = MAX_CATCH_UP_TICKS;
+        scheduler->next_ns = now - (due - 1) * scheduler->interval_ns;
+    }
+    scheduler->next_ns += due * scheduler->interval_ns;
+    scheduler->ticks += (Uint32)due;
+    scheduler->caught_up += (Uint32)(due - 1);
+    return (int)due;
+}
+
+double tick_scheduler_rate(const TickScheduler *scheduler) {
+    Uint64 elapsed = clock_now_ns() - scheduler->stats_start_ns;
+    return elapsed ? scheduler->ticks * 1e9 / (double)elapsed : 0;
+}
@@ -0,0 +1,77 @@
+#ifndef NETWORK_CLOCK_H
+#define NETWORK_CLOCK_H
+
+#include "network_common.h"
+
+#define MAX_CATCH_UP_TICKS 4       // Ticks run back-to-back after an overrun before the backlog is dropped
+
+// Fixed-rate tick scheduler on a monotonic nanosecond clock
+// Deadlines advance by exactly one interval per tick, so rounding and
+// oversleeping never accumulate into drift. The scheduler only keeps
+// time; callers sleep until next_ns themselves (see network_reactor.h).
+typedef struct {
+    Uint64 interval_ns;
+    Uint64 next_ns;          // Deadline of the next tick
+    Uint64 last_ns;          // Start of the previous tick
+    Uint64 stats_start_ns;
+    Uint32 ticks;            // Stats since tick_scheduler_reset_stats()
+    Uint32 caught_up;        // Ticks run late, back-to-back
+    Uint32 dropped;          // Ticks skipped after falling too far behind
+    Uint64 lateness_sum_ns;  // Wake-up time past the deadline
+    Uint64 lateness_max_ns;
+    Uint64 interval_min_ns;  // Spacing between consecutive wake-ups
+    Uint64 interval_max_ns;
+} TickScheduler;
+
+/**
+ * Monotonic clock
+ * On Linux this is CLOCK_MONOTONIC, so its times can arm a timerfd
+ *
+ * @return Nanoseconds since an arbitrary fixed point
+ */
+Uint64 clock_now_ns(void);
+
+/**
+ * Start a scheduler whose first tick is due immediately
+ *
+ * @param scheduler Pointer to TickScheduler
+ * @param rate_hz Ticks per second
+ */
+void tick_scheduler_init(TickScheduler *scheduler, int rate_hz);
+
+/**
+ * Account for a wake-up at or after the next tick deadline
+ * After an overrun every missed tick is due, up to MAX_CATCH_UP_TICKS;
+ * anything beyond that is dropped and the next tick is due one interval
+ * from now.
+ *
+ * @param scheduler Pointer to TickScheduler
+ * @param now Wake-up time from clock_now_ns(), not before scheduler->next_ns
+ * @return Number of ticks to simulate now (at least 1)
+ */
+int tick_scheduler_advance(TickScheduler *scheduler, Uint64 now);
+
+/**
+ * Make the next tick due immediately, after a pause in ticking
+ * The pause counts neither as lateness nor as a tick interval.
+ *
+ * @param scheduler Pointer to TickScheduler
+ */
+void tick_scheduler_restart(TickScheduler *scheduler);
+
+/**
+ * Ticks per second achieved since the stats were last reset
+ *
+ * @param scheduler Pointer to TickScheduler
+ * @return Measured rate in Hz
+ */
+double tick_scheduler_rate(const TickScheduler *scheduler);
+
+/**
+ * Start a new stats window
+ *
+ * @param scheduler Pointer to TickScheduler
+ */
+void tick_scheduler_reset_stats(TickScheduler *scheduler);
+
+#endif // NETWORK_CLOCK_H
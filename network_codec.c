@@ -0,0 +1,750 @@
+#include <string.h>
+#include <math.h>
+#include "network_codec.h"
+
+// Positions: 1/8 pixel fixed point over [-1024, 3072)
+#define POS_BITS 15
+#define POS_SCALE 8.0f
+#define POS_OFFSET 1024.0f
+
+// Velocities: 1/2 pixel per second fixed point over [-2048, 2048)
+#define VEL_BITS 13
+#define VEL_SCALE 2.0f
+#define VEL_OFFSET 2048.0f
+
+#define PACKET_TYPE_BITS 4
+#define NAME_LENGTH_BITS 6
+#define FRAGMENT_BITS 5  // Enough for MAX_FRAGMENTS - 1
+#define INPUT_COUNT_BITS 3  // Enough for INPUT_REDUNDANCY - 1
+
+// ---------------------------------------------------------------------------
+// Wire schema
+//
+// Each entry is X(field, kind, arg). Kinds map to codec_put_<kind>,
+// codec_get_<kind> and codec_same_<kind> below:
+//   flag   1 bit
+//   bits   arg-bit unsigned integer
+//   uint   unsigned varint
+//   sint   zigzag varint
+//   pos    quantized coordinate
+//   vel    quantized velocity
+// Presence flags (active) are not listed; they travel as slot bitmasks.
+// Server-only bookkeeping (timers) is left off the wire. Bullets are
+// replicated as spawn/despawn events and explosions as reliable events
+// rather than per-tick state.
+// ---------------------------------------------------------------------------
+
+#define PACKET_HEADER_SCHEMA(X) \
+    X(type,      bits, PACKET_TYPE_BITS) \
+    X(player_id, sint, 0) \
+    X(sequence,  uint, 0)
+
+// Only the controls travel; the player comes from the packet header
+#define PLAYER_INPUT_SCHEMA(X) \
+    X(move_up,    flag, 0) \
+    X(move_down,  flag, 0) \
+    X(move_left,  flag, 0) \
+    X(move_right, flag, 0) \
+    X(shooting,   flag, 0)
+
+#define FRAGMENT_SCHEMA(X) \
+    X(fragment_index, bits, FRAGMENT_BITS) \
+    X(fragment_count, bits, FRAGMENT_BITS + 1)
+
+#define CONNECT_RESPONSE_SCHEMA(X) \
+    X(assigned_id, sint, 0) \
+    X(success,     flag, 0) \
+    X(compression, bits, 2) \
+    X(tick_rate,   bits, 8) \
+    X(capacity.players,            uint, 0) \
+    X(capacity.bullets_per_player, uint, 0) \
+    X(capacity.enemies,            uint, 0) \
+    X(capacity.enemy_bullets,      uint, 0) \
+    X(capacity.explosions,         uint, 0)
+
+#define NETWORK_PLAYER_SCHEMA(X) \
+    X(id,            sint, 0) \
+    X(x,             pos,  0) \
+    X(y,             pos,  0) \
+    X(health,        sint, 0) \
+    X(score,         sint, 0) \
+    X(alive,         flag, 0) \
+    X(bullets_fired, uint, 0) \
+    X(reloading,     flag, 0)
+
+#define NETWORK_ENEMY_SCHEMA(X) \
+    X(id,         uint, 0) \
+    X(x,          pos,  0) \
+    X(y,          pos,  0) \
+    X(texture_id, bits, 3) \
+    X(health,     sint, 0)
+
+#define PROJECTILE_EVENT_SCHEMA(X) \
+    X(type,  flag, 0) \
+    X(owner, sint, 0) \
+    X(slot,  uint, 0)
+
+#define PROJECTILE_SPAWN_SCHEMA(X) \
+    X(x,  pos, 0) \
+    X(y,  pos, 0) \
+    X(vx, vel, 0) \
+    X(vy, vel, 0)
+
+#define GAME_EVENT_SCHEMA(X) \
+    X(type,      bits, 3) \
+    X(player_id, sint, 0) \
+    X(x,         pos,  0) \
+    X(y,         pos,  0) \
+    X(value,     sint, 0)
+
+#define GAME_STATE_SCHEMA(X) \
+    X(player_count,       sint, 0) \
+    X(enemy_count,        sint, 0) \
+    X(enemy_bullet_count, sint, 0)
+
+// ---------------------------------------------------------------------------
+// Bit I/O
+// ---------------------------------------------------------------------------
+
+void bitwriter_init(BitWriter *w, Uint8 *data, int capacity) {
+    w->data = data;
+    w->capacity = capacity;
+    w->bit_pos = 0;
+    w->overflow = 0;
+}
+
+void bitwriter_put(BitWriter *w, Uint32 value, int bits) {
+    for (int i = 0; i < bits; i++) {
+        int byte = w->bit_pos >> 3;
+        int shift = w->bit_pos & 7;
+        if (byte >= w->capacity) {
+            w->overflow = 1;
+            return;
+        }
+        if (shift == 0) w->data[byte] = 0;
+        w->data[byte] |= ((value >> i) & 1) << shift;
+        w->bit_pos++;
+    }
+}
+
+void bitwriter_put_varint(BitWriter *w, Uint32 value) {
+    do {
+        Uint32 group = value & 0x7F;
+        value >>= 7;
+        bitwriter_put(w, group | (value ? 0x80 : 0), 8);
+    } while (value);
+}
+
+void bitwriter_align(BitWriter *w) {
+    w->bit_pos = (w->bit_pos + 7) & ~7;
+    if ((w->bit_pos >> 3) > w->capacity) w->overflow = 1;
+}
+
+int bitwriter_bytes(const BitWriter *w) {
+    return (w->bit_pos + 7) >> 3;
+}
+
+void bitreader_init(BitReader *r, const Uint8 *data, int size) {
+    r->data = data;
+    r->size = size;
+    r->bit_pos = 0;
+    r->overflow = 0;
+}
+
+Uint32 bitreader_get(BitReader *r, int bits) {
+    Uint32 value = 0;
+    for (int i = 0; i < bits; i++) {
+        int byte = r->bit_pos >> 3;
+        if (byte >= r->size) {
+            r->overflow = 1;
+            return 0;
+        }
+        value |= (Uint32)((r->data[byte] >> (r->bit_pos & 7)) & 1) << i;
+        r->bit_pos++;
+    }
+    return value;
+}
+
+Uint32 bitreader_get_varint(BitReader *r) {
+    Uint32 value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        Uint32 group = bitreader_get(r, 8);
+        value |= (group & 0x7F) << shift;
+        if (!(group & 0x80) || r->overflow) return value;
+    }
+    r->overflow = 1;
+    return 0;
+}
+
+void bitreader_align(BitReader *r) {
+    r->bit_pos = (r->bit_pos + 7) & ~7;
+}
+
+int bitreader_bytes(const BitReader *r) {
+    return (r->bit_pos + 7) >> 3;
+}
+
+// ---------------------------------------------------------------------------
+// Field kinds
+// ---------------------------------------------------------------------------
+
+static Uint32 quantize(float value, float scale, float offset, int bits) {
+    float q = floorf((value + offset) * scale + 0.5f);
+    float max = (float)((1u << bits) - 1);
+    if (q < 0) q = 0;
+    if (q > max) q = max;
+    return (Uint32)q;
+}
+
+static float dequantize(Uint32 q, float scale, float offset) {
+    return q / scale - offset;
+}
+
+static void codec_put_flag(BitWriter *w, int value, int arg) { (void)arg; bitwriter_put(w, value != 0, 1); }
+static int codec_get_flag(BitReader *r, int arg) { (void)arg; return (int)bitreader_get(r, 1); }
+static int codec_same_flag(int a, int b, int arg) { (void)arg; return (a != 0) == (b != 0); }
+
+static void codec_put_bits(BitWriter *w, Uint32 value, int bits) { bitwriter_put(w, value, bits); }
+static Uint32 codec_get_bits(BitReader *r, int bits) { return bitreader_get(r, bits); }
+static int codec_same_bits(Uint32 a, Uint32 b, int bits) {
+    Uint32 mask = bits >= 32 ? 0xFFFFFFFFu : ((1u << bits) - 1);
+    return (a & mask) == (b & mask);
+}
+
+static void codec_put_uint(BitWriter *w, Uint32 value, int arg) { (void)arg; bitwriter_put_varint(w, value); }
+static Uint32 codec_get_uint(BitReader *r, int arg) { (void)arg; return bitreader_get_varint(r); }
+static int codec_same_uint(Uint32 a, Uint32 b, int arg) { (void)arg; return a == b; }
+
+static void codec_put_sint(BitWriter *w, int value, int arg) {
+    (void)arg;
+    bitwriter_put_varint(w, ((Uint32)value << 1) ^ (Uint32)(value >> 31));
+}
+static int codec_get_sint(BitReader *r, int arg) {
+    (void)arg;
+    Uint32 zigzag = bitreader_get_varint(r);
+    return (int)(zigzag >> 1) ^ -(int)(zigzag & 1);
+}
+static int codec_same_sint(int a, int b, int arg) { (void)arg; return a == b; }
+
+static void codec_put_pos(BitWriter *w, float value, int arg) {
+    (void)arg;
+    bitwriter_put(w, quantize(value, POS_SCALE, POS_OFFSET, POS_BITS), POS_BITS);
+}
+static float codec_get_pos(BitReader *r, int arg) {
+    (void)arg;
+    return dequantize(bitreader_get(r, POS_BITS), POS_SCALE, POS_OFFSET);
+}
+static int codec_same_pos(float a, float b, int arg) {
+    (void)arg;
+    return quantize(a, POS_SCALE, POS_OFFSET, POS_BITS) == quantize(b, POS_SCALE, POS_OFFSET, POS_BITS);
+}
+
+static void codec_put_vel(BitWriter *w, float value, int arg) {
+    (void)arg;
+    bitwriter_put(w, quantize(value, VEL_SCALE, VEL_OFFSET, VEL_BITS), VEL_BITS);
+}
+static float codec_get_vel(BitReader *r, int arg) {
+    (void)arg;
+    return dequantize(bitreader_get(r, VEL_BITS), VEL_SCALE, VEL_OFFSET);
+}
+
+// ---------------------------------------------------------------------------
+// Generated struct codecs
+// ---------------------------------------------------------------------------
+
+#define WRITE_FIELD(name, kind, arg) codec_put_##kind(w, value->name, arg);
+#define READ_FIELD(name, kind, arg) value->name = codec_get_##kind(r, arg);
+#define SAME_FIELD(name, kind, arg) && codec_same_##kind(base->name, value->name, arg)
+#define WRITE_DELTA_FIELD(name, kind, arg) \
+    if (codec_same_##kind(base->name, value->name, arg)) { \
+        bitwriter_put(w, 0, 1); \
+    } else { \
+        bitwriter_put(w, 1, 1); \
+        codec_put_##kind(w, value->name, arg); \
+    }
+#define READ_DELTA_FIELD(name, kind, arg) \
+    if (bitreader_get(r, 1)) { \
+        value->name = codec_get_##kind(r, arg); \
+    } else { \
+        value->name = base->name; \
+    }
+
+// Full encoding of every field
+#define DEFINE_CODEC(type, schema) \
+    static void write_##type(BitWriter *w, const type *value) { schema(WRITE_FIELD) } \
+    static void read_##type(BitReader *r, type *value) { schema(READ_FIELD) }
+
+// Per-field change bits against a baseline of the same type
+#define DEFINE_DELTA_CODEC(type, schema) \
+    static void write_##type##_delta(BitWriter *w, const type *base, const type *value) { schema(WRITE_DELTA_FIELD) } \
+    static void read_##type##_delta(BitReader *r, const type *base, type *value) { schema(READ_DELTA_FIELD) }
+
+// Delta codec plus a whole-entity comparison for entries of slot arrays
+#define DEFINE_SLOT_CODEC(type, schema) \
+    DEFINE_DELTA_CODEC(type, schema) \
+    static int same_##type(const type *base, const type *value) { return 1 schema(SAME_FIELD); }
+
+DEFINE_CODEC(PacketHeader, PACKET_HEADER_SCHEMA)
+DEFINE_CODEC(PlayerInput, PLAYER_INPUT_SCHEMA)
+static int same_PlayerInput(const PlayerInput *base, const PlayerInput *value) { return 1 PLAYER_INPUT_SCHEMA(SAME_FIELD); }
+int codec_same_input(const PlayerInput *a, const PlayerInput *b) { return same_PlayerInput(a, b); }
+DEFINE_CODEC(ConnectResponse, CONNECT_RESPONSE_SCHEMA)
+DEFINE_CODEC(FragmentPacket, FRAGMENT_SCHEMA)
+DEFINE_CODEC(ProjectileEvent, PROJECTILE_EVENT_SCHEMA)
+DEFINE_CODEC(GameEvent, GAME_EVENT_SCHEMA)
+
+// Spawn payload shares the event struct, so it gets its own function names
+static void write_ProjectileSpawn(BitWriter *w, const ProjectileEvent *value) { PROJECTILE_SPAWN_SCHEMA(WRITE_FIELD) }
+static void read_ProjectileSpawn(BitReader *r, ProjectileEvent *value) { PROJECTILE_SPAWN_SCHEMA(READ_FIELD) }
+DEFINE_SLOT_CODEC(NetworkPlayer, NETWORK_PLAYER_SCHEMA)
+DEFINE_SLOT_CODEC(NetworkEnemy, NETWORK_ENEMY_SCHEMA)
+DEFINE_DELTA_CODEC(GameState, GAME_STATE_SCHEMA)
+
+// ---------------------------------------------------------------------------
+// Slot arrays
+//
+// Presence is sent as the list of slots whose active flag toggled since the
+// baseline, each as a varint gap from the previous one, so its size follows
+// the number of toggles rather than the room's capacity. Each active slot
+// then costs one bit when unchanged, or a field change mask plus the
+// changed fields. Inactive slots are never encoded.
+// ---------------------------------------------------------------------------
+
+#define PRESENCE_GAP_BITS 8  // One varint byte: the cost of a toggle less than 128 slots after the last
+#define MAX_SLOTS (MAX_PLAYERS > MAX_ENEMIES ? MAX_PLAYERS : MAX_ENEMIES)  // Longest slot array
+
+static void write_presence(BitWriter *w, const int *base_active, const int *cur_active, int count) {
+    int toggled = 0;
+    for (int i = 0; i < count; i++) {
+        if (base_active[i] != cur_active[i]) toggled++;
+    }
+
+    bitwriter_put(w, toggled != 0, 1);
+    if (!toggled) return;
+
+    bitwriter_put_varint(w, toggled);
+    int next = 0;  // Lowest slot the next toggle can be
+    for (int i = 0; i < count; i++) {
+        if (base_active[i] == cur_active[i]) continue;
+        bitwriter_put_varint(w, i - next);
+        next = i + 1;
+    }
+}
+
+// active holds the baseline's flags on entry and the current ones on return
+static void read_presence(BitReader *r, int *active, int count) {
+    if (!bitreader_get(r, 1)) return;
+
+    Uint32 toggled = bitreader_get_varint(r);
+    if (toggled > (Uint32)count) {
+        r->overflow = 1;
+        return;
+    }
+    Uint32 next = 0;
+    for (Uint32 i = 0; i < toggled; i++) {
+        Uint32 index = next + bitreader_get_varint(r);
+        if (index < next || index >= (Uint32)count) {
+            r->overflow = 1;
+            return;
+        }
+        active[index] = !active[index];
+        next = index + 1;
+    }
+}
+
+// Encodes one slot array; a NULL base array or inactive base slots count
+// as all-zero
+#define WRITE_SLOTS(w, type, base_array, cur_array, count) do { \
+    static const type zero_slot; \
+    int base_active[MAX_SLOTS], cur_active[MAX_SLOTS]; \
+    for (int i = 0; i < (count); i++) { \
+        base_active[i] = (base_array) && (base_array)[i].active != 0; \
+        cur_active[i] = (cur_array)[i].active != 0; \
+    } \
+    write_presence(w, base_active, cur_active, count); \
+    for (int i = 0; i < (count); i++) { \
+        if (!cur_active[i]) continue; \
+        const type *slot_base = base_active[i] ? &(base_array)[i] : &zero_slot; \
+        int changed = !same_##type(slot_base, &(cur_array)[i]); \
+        bitwriter_put(w, changed, 1); \
+        if (changed) write_##type##_delta(w, slot_base, &(cur_array)[i]); \
+    } \
+} while (0)
+
+#define READ_SLOTS(r, type, base_array, out_array, count) do { \
+    static const type zero_slot; \
+    int base_active[MAX_SLOTS], cur_active[MAX_SLOTS]; \
+    for (int i = 0; i < (count); i++) { \
+        base_active[i] = (base_array) && (base_array)[i].active != 0; \
+        cur_active[i] = base_active[i]; \
+    } \
+    read_presence(r, cur_active, count); \
+    for (int i = 0; i < (count); i++) { \
+        if (!cur_active[i]) { \
+            memset(&(out_array)[i], 0, sizeof(type)); \
+            continue; \
+        } \
+        const type *slot_base = base_active[i] ? &(base_array)[i] : &zero_slot; \
+        (out_array)[i] = *slot_base; \
+        if (bitreader_get(r, 1)) { \
+            read_##type##_delta(r, slot_base, &(out_array)[i]); \
+        } \
+        (out_array)[i].active = 1; \
+    } \
+} while (0)
+
+// Bits one slot adds to an encoded state when it differs from its baseline
+#define DEFINE_SLOT_COST(type, name) \
+    int codec_##name##_delta_bits(const type *base, const type *current) { \
+        static const type zero_slot; \
+        int base_active = base->active != 0, cur_active = current->active != 0; \
+        int bits = base_active != cur_active ? PRESENCE_GAP_BITS : 0; \
+        if (!cur_active) return bits; \
+        const type *slot_base = base_active ? base : &zero_slot; \
+        if (same_##type(slot_base, current)) return bits; \
+        Uint8 scratch[sizeof(type) * 2]; \
+        BitWriter w; \
+        bitwriter_init(&w, scratch, sizeof(scratch)); \
+        write_##type##_delta(&w, slot_base, current); \
+        return bits + w.bit_pos; \
+    }
+
+DEFINE_SLOT_COST(NetworkPlayer, player)
+DEFINE_SLOT_COST(NetworkEnemy, enemy)
+
+// ---------------------------------------------------------------------------
+// Game state
+// ---------------------------------------------------------------------------
+
+static const GameState zero_state;
+
+int codec_write_state(Uint8 *data, int max_size, const GameState *baseline, const GameState *current) {
+    const GameState *base = baseline ? baseline : &zero_state;
+    BitWriter writer;
+    BitWriter *w = &writer;
+    bitwriter_init(w, data, max_size);
+
+    write_GameState_delta(w, base, current);
+
+    WRITE_SLOTS(w, NetworkPlayer, base->players, current->players, current->capacity.players);
+    WRITE_SLOTS(w, NetworkEnemy, base->enemies, current->enemies, current->capacity.enemies);
+
+    bitwriter_align(w);
+    if (w->overflow) return -1;
+    return bitwriter_bytes(w);
+}
+
+int codec_read_state(const Uint8 *data, int size, const GameState *baseline, GameState *out) {
+    const GameState *base = baseline ? baseline : &zero_state;
+    BitReader reader;
+    BitReader *r = &reader;
+    bitreader_init(r, data, size);
+
+    read_GameState_delta(r, base, out);
+
+    READ_SLOTS(r, NetworkPlayer, base->players, out->players, out->capacity.players);
+    READ_SLOTS(r, NetworkEnemy, base->enemies, out->enemies, out->capacity.enemies);
+
+    bitreader_align(r);
+    return r->overflow ? -1 : bitreader_bytes(r);
+}
+
+static void write_projectile_list(BitWriter *w, Uint32 tick, const ProjectileEvent *events, int count) {
+    bitwriter_put_varint(w, count);
+    for (int i = 0; i < count; i++) {
+        const ProjectileEvent *event = &events[i];
+        write_ProjectileEvent(w, event);
+        // Event ticks never lie in the future, so send their age
+        bitwriter_put_varint(w, tick - event->tick);
+        if (event->type == PROJECTILE_SPAWN) {
+            write_ProjectileSpawn(w, event);
+        }
+    }
+}
+
+static void read_projectile_list(BitReader *r, Uint32 tick, ProjectileEvent *events, Uint32 count) {
+    for (Uint32 i = 0; i < count; i++) {
+        ProjectileEvent *event = &events[i];
+        memset(event, 0, sizeof(ProjectileEvent));
+        read_ProjectileEvent(r, event);
+        event->tick = tick - bitreader_get_varint(r);
+        if (event->type == PROJECTILE_SPAWN) {
+            read_ProjectileSpawn(r, event);
+        }
+    }
+}
+
+int codec_write_projectile_events(Uint8 *data, int max_size, Uint32 tick, const ProjectileResync *resync,
+                                  Uint32 last_sequence, const ProjectileEvent *events, int count) {
+    BitWriter writer;
+    BitWriter *w = &writer;
+    bitwriter_init(w, data, max_size);
+
+    int resyncing = resync && resync->active;
+    int spawns = resyncing ? resync->spawns : 0;
+    bitwriter_put(w, resyncing, 1);
+    bitwriter_put_varint(w, last_sequence);
+    write_projectile_list(w, tick, events, count - spawns);
+    if (resyncing) {
+        bitwriter_put_varint(w, resync->first);
+        bitwriter_put_varint(w, resync->end - resync->first);
+        write_projectile_list(w, tick, events + count - spawns, spawns);
+    }
+
+    bitwriter_align(w);
+    return w->overflow ? -1 : bitwriter_bytes(w);
+}
+
+int codec_read_projectile_events(const Uint8 *data, int size, Uint32 tick, ProjectileResync *resync,
+                                 Uint32 *last_sequence, ProjectileEvent *events, int max_events) {
+    BitReader reader;
+    BitReader *r = &reader;
+    bitreader_init(r, data, size);
+    memset(resync, 0, sizeof(ProjectileResync));
+
+    resync->active = (int)bitreader_get(r, 1);
+    *last_sequence = bitreader_get_varint(r);
+    Uint32 count = bitreader_get_varint(r);
+    if (r->overflow || count > (Uint32)max_events) return -1;
+    read_projectile_list(r, tick, events, count);
+
+    // Logged events are the contiguous run ending at last_sequence
+    for (Uint32 i = 0; i < count; i++) {
+        events[i].sequence = *last_sequence - count + 1 + i;
+    }
+
+    if (resync->active) {
+        resync->first = (int)bitreader_get_varint(r);
+        resync->end = resync->first + (int)bitreader_get_varint(r);
+        Uint32 spawns = bitreader_get_varint(r);
+        if (r->overflow || spawns > (Uint32)max_events - count) return -1;
+        read_projectile_list(r, tick, events + count, spawns);
+        resync->spawns = (int)spawns;
+        count += spawns;
+    }
+
+    return r->overflow ? -1 : (int)count;
+}
+
+// ---------------------------------------------------------------------------
+// Reliable block
+//
+// Acks are only present for channels that have received something, so an
+// idle channel costs one bit. Messages follow as a count and a list.
+// ---------------------------------------------------------------------------
+
+static void write_reliable(BitWriter *w, const ReliableBlock *block) {
+    for (int c = 0; c < RELIABLE_CHANNELS; c++) {
+        bitwriter_put(w, block->has_ack[c] != 0, 1);
+        if (!block->has_ack[c]) continue;
+        bitwriter_put_varint(w, block->ack[c]);
+        bitwriter_put(w, block->ack_bits[c] != 0, 1);
+        if (block->ack_bits[c]) bitwriter_put(w, block->ack_bits[c], 32);
+    }
+
+    bitwriter_put_varint(w, block->count);
+    for (int i = 0; i < block->count; i++) {
+        const ReliableMessage *message = &block->messages[i];
+        bitwriter_put(w, message->channel, 1);
+        bitwriter_put_varint(w, message->sequence);
+        write_GameEvent(w, &message->event);
+    }
+}
+
+static void read_reliable(BitReader *r, ReliableBlock *block) {
+    for (int c = 0; c < RELIABLE_CHANNELS; c++) {
+        block->has_ack[c] = (int)bitreader_get(r, 1);
+        block->ack[c] = 0;
+        block->ack_bits[c] = 0;
+        if (!block->has_ack[c]) continue;
+        block->ack[c] = bitreader_get_varint(r);
+        if (bitreader_get(r, 1)) block->ack_bits[c] = bitreader_get(r, 32);
+    }
+
+    Uint32 count = bitreader_get_varint(r);
+    if (count > MAX_RELIABLE_PER_PACKET) {
+        r->overflow = 1;
+        count = 0;
+    }
+    block->count = (int)count;
+    for (int i = 0; i < block->count; i++) {
+        ReliableMessage *message = &block->messages[i];
+        message->channel = (int)bitreader_get(r, 1);
+        message->sequence = bitreader_get_varint(r);
+        read_GameEvent(r, &message->event);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Packets
+// ---------------------------------------------------------------------------
+
+int codec_read_header(const Uint8 *data, int size, PacketHeader *header) {
+    BitReader reader;
+    bitreader_init(&reader, data, size);
+    read_PacketHeader(&reader, header);
+    return !reader.overflow;
+}
+
+int codec_write_header(Uint8 *data, int max_size, const PacketHeader *header) {
+    BitWriter writer;
+    bitwriter_init(&writer, data, max_size);
+    write_PacketHeader(&writer, header);
+    return writer.overflow ? -1 : bitwriter_bytes(&writer);
+}
+
+int codec_write_connect(Uint8 *data, int max_size, const ConnectPacket *pkt) {
+    BitWriter writer;
+    bitwriter_init(&writer, data, max_size);
+    write_PacketHeader(&writer, &pkt->header);
+
+    int length = 0;
+    while (length < (int)sizeof(pkt->player_name) - 1 && pkt->player_name[length]) length++;
+    bitwriter_put(&writer, length, NAME_LENGTH_BITS);
+    for (int i = 0; i < length; i++) {
+        bitwriter_put(&writer, (Uint8)pkt->player_name[i], 8);
+    }
+    bitwriter_put(&writer, pkt->compression, 2);
+    return writer.overflow ? -1 : bitwriter_bytes(&writer);
+}
+
+int codec_read_connect(const Uint8 *data, int size, ConnectPacket *pkt) {
+    BitReader reader;
+    bitreader_init(&reader, data, size);
+    read_PacketHeader(&reader, &pkt->header);
+
+    int length = (int)bitreader_get(&reader, NAME_LENGTH_BITS);
+    if (length > (int)sizeof(pkt->player_name) - 1) return 0;
+    for (int i = 0; i < length; i++) {
+        pkt->player_name[i] = (char)bitreader_get(&reader, 8);
+    }
+    pkt->player_name[length] = '\0';
+    pkt->compression = (int)bitreader_get(&reader, 2);
+    return !reader.overflow;
+}
+
+int codec_write_connect_response(Uint8 *data, int max_size, const ConnectResponse *pkt) {
+    BitWriter writer;
+    bitwriter_init(&writer, data, max_size);
+    write_PacketHeader(&writer, &pkt->header);
+    write_ConnectResponse(&writer, pkt);
+    return writer.overflow ? -1 : bitwriter_bytes(&writer);
+}
+
+int codec_read_connect_response(const Uint8 *data, int size, ConnectResponse *pkt) {
+    BitReader reader;
+    bitreader_init(&reader, data, size);
+    read_PacketHeader(&reader, &pkt->header);
+    read_ConnectResponse(&reader, pkt);
+    if (reader.overflow) return 0;
+
+    // Rooms beyond the protocol ceilings cannot be joined
+    const RoomCapacity *capacity = &pkt->capacity;
+    return !pkt->success ||
+           (capacity->players >= 1 && capacity->players <= MAX_PLAYERS &&
+            capacity->bullets_per_player >= 1 && capacity->bullets_per_player <= MAX_BULLETS_PER_PLAYER &&
+            capacity->enemies >= 1 && capacity->enemies <= MAX_ENEMIES &&
+            capacity->enemy_bullets >= 1 && capacity->enemy_bullets <= MAX_ENEMY_BULLETS &&
+            capacity->explosions >= 1 && capacity->explosions <= MAX_EXPLOSIONS);
+}
+
+// Redundant inputs: the newest in full, then each older one as a single
+// "same as the next newer" bit unless it differs
+int codec_write_input(Uint8 *data, int max_size, const InputPacket *pkt) {
+    BitWriter writer;
+    bitwriter_init(&writer, data, max_size);
+    write_PacketHeader(&writer, &pkt->header);
+    bitwriter_put(&writer, pkt->input_count - 1, INPUT_COUNT_BITS);
+    write_PlayerInput(&writer, &pkt->inputs[0]);
+    for (int i = 1; i < pkt->input_count; i++) {
+        int same = same_PlayerInput(&pkt->inputs[i - 1], &pkt->inputs[i]);
+        bitwriter_put(&writer, same, 1);
+        if (!same) write_PlayerInput(&writer, &pkt->inputs[i]);
+    }
+    bitwriter_put_varint(&writer, pkt->ack_tick);
+    bitwriter_put_varint(&writer, pkt->ack_delay);
+    bitwriter_put_varint(&writer, ~pkt->ack_bits);  // Mostly ones, so send the inverse
+    bitwriter_put_varint(&writer, pkt->view_lag);
+    write_reliable(&writer, &pkt->reliable);
+    return writer.overflow ? -1 : bitwriter_bytes(&writer);
+}
+
+int codec_read_input(const Uint8 *data, int size, InputPacket *pkt) {
+    BitReader reader;
+    bitreader_init(&reader, data, size);
+    read_PacketHeader(&reader, &pkt->header);
+    pkt->input_count = (int)bitreader_get(&reader, INPUT_COUNT_BITS) + 1;
+    if (pkt->input_count > INPUT_REDUNDANCY) return 0;
+    for (int i = 0; i < pkt->input_count; i++) {
+        PlayerInput *input = &pkt->inputs[i];
+        if (i == 0 || !bitreader_get(&reader, 1)) {
+            read_PlayerInput(&reader, input);
+        } else {
+            *input = pkt->inputs[i - 1];
+        }
+        input->player_id = pkt->header.player_id;
+        input->timestamp = 0;
+    }
+    pkt->ack_tick = bitreader_get_varint(&reader);
+    pkt->ack_delay = bitreader_get_varint(&reader);
+    pkt->ack_bits = ~bitreader_get_varint(&reader);
+    pkt->view_lag = bitreader_get_varint(&reader);
+    read_reliable(&reader, &pkt->reliable);
+    return !reader.overflow;
+}
+
+int codec_write_fragment(Uint8 *data, int max_size, const FragmentPacket *pkt) {
+    BitWriter writer;
+    bitwriter_init(&writer, data, max_size);
+    write_PacketHeader(&writer, &pkt->header);
+    write_FragmentPacket(&writer, pkt);
+    bitwriter_align(&writer);
+    return writer.overflow ? -1 : bitwriter_bytes(&writer);
+}
+
+int codec_read_fragment(const Uint8 *data, int size, FragmentPacket *pkt) {
+    BitReader reader;
+    bitreader_init(&reader, data, size);
+    read_PacketHeader(&reader, &pkt->header);
+    read_FragmentPacket(&reader, pkt);
+    bitreader_align(&reader);
+    return reader.overflow ? -1 : bitreader_bytes(&reader);
+}
+
+int codec_write_state_packet(Uint8 *data, int max_size, const GameStatePacket *pkt,
+                             const Uint8 *payload, int payload_size) {
+    BitWriter writer;
+    bitwriter_init(&writer, data, max_size);
+    write_PacketHeader(&writer, &pkt->header);
+    bitwriter_put_varint(&writer, pkt->tick);
+    // Baseline travels as a distance back from tick; 0 marks a keyframe
+    bitwriter_put_varint(&writer, pkt->baseline_tick ? pkt->tick - pkt->baseline_tick : 0);
+    bitwriter_put_varint(&writer, pkt->input_ack);
+    bitwriter_put(&writer, pkt->compressed != 0, 1);
+    write_reliable(&writer, &pkt->reliable);
+    bitwriter_align(&writer);
+    if (writer.overflow) return -1;
+
+    int offset = bitwriter_bytes(&writer);
+    if (offset + payload_size > max_size) return -1;
+    memcpy(data + offset, payload, payload_size);
+    return offset + payload_size;
+}
+
+int codec_read_state_packet(const Uint8 *data, int size, GameStatePacket *pkt, int *payload_offset) {
+    BitReader reader;
+    bitreader_init(&reader, data, size);
+    read_PacketHeader(&reader, &pkt->header);
+    pkt->tick = bitreader_get_varint(&reader);
+    Uint32 distance = bitreader_get_varint(&reader);
+    if (distance > pkt->tick) return 0;
+    pkt->baseline_tick = distance ? pkt->tick - distance : 0;
+    pkt->input_ack = bitreader_get_varint(&reader);
+    pkt->compressed = (int)bitreader_get(&reader, 1);
+    read_reliable(&reader, &pkt->reliable);
+    bitreader_align(&reader);
+    if (reader.overflow) return 0;
+
+    *payload_offset = bitreader_bytes(&reader);
+    return 1;
+}
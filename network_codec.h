@@ -0,0 +1,176 @@
+#ifndef NETWORK_CODEC_H
+#define NETWORK_CODEC_H
+
+#include "network_common.h"
+
+// Bit-level writer over a byte buffer (LSB-first, byte order independent)
+typedef struct {
+    Uint8 *data;
+    int capacity;    // Buffer size in bytes
+    int bit_pos;
+    int overflow;    // Set once a write ran past the end of the buffer
+} BitWriter;
+
+// Bit-level reader matching BitWriter
+typedef struct {
+    const Uint8 *data;
+    int size;        // Buffer size in bytes
+    int bit_pos;
+    int overflow;    // Set once a read ran past the end of the buffer
+} BitReader;
+
+void bitwriter_init(BitWriter *w, Uint8 *data, int capacity);
+void bitwriter_put(BitWriter *w, Uint32 value, int bits);
+void bitwriter_put_varint(BitWriter *w, Uint32 value);
+void bitwriter_align(BitWriter *w);
+int bitwriter_bytes(const BitWriter *w);
+
+void bitreader_init(BitReader *r, const Uint8 *data, int size);
+Uint32 bitreader_get(BitReader *r, int bits);
+Uint32 bitreader_get_varint(BitReader *r);
+void bitreader_align(BitReader *r);
+int bitreader_bytes(const BitReader *r);
+
+/**
+ * Decode only the packet header, used to dispatch on packet type
+ *
+ * @param data Received datagram
+ * @param size Datagram length in bytes
+ * @param header Receives the decoded header
+ * @return 1 on success, 0 if the datagram is malformed
+ */
+int codec_read_header(const Uint8 *data, int size, PacketHeader *header);
+int codec_write_header(Uint8 *data, int max_size, const PacketHeader *header);
+
+int codec_write_connect(Uint8 *data, int max_size, const ConnectPacket *pkt);
+int codec_read_connect(const Uint8 *data, int size, ConnectPacket *pkt);
+
+int codec_write_connect_response(Uint8 *data, int max_size, const ConnectResponse *pkt);
+int codec_read_connect_response(const Uint8 *data, int size, ConnectResponse *pkt);
+
+int codec_write_input(Uint8 *data, int max_size, const InputPacket *pkt);
+int codec_read_input(const Uint8 *data, int size, InputPacket *pkt);
+
+/**
+ * Compare the controls of two inputs, i.e. the fields that go on the wire
+ *
+ * @return 1 if they would encode identically
+ */
+int codec_same_input(const PlayerInput *a, const PlayerInput *b);
+
+/**
+ * Write a fragment header; the fragment bytes follow at the returned offset
+ *
+ * @param data Output buffer
+ * @param max_size Size of the output buffer in bytes
+ * @param pkt Fragment header
+ * @return Byte offset of the fragment payload, or -1 if the buffer is too small
+ */
+int codec_write_fragment(Uint8 *data, int max_size, const FragmentPacket *pkt);
+
+/**
+ * Read a fragment header
+ *
+ * @param data Received datagram
+ * @param size Datagram length in bytes
+ * @param pkt Receives the fragment header
+ * @return Byte offset of the fragment payload, or -1 if malformed
+ */
+int codec_read_fragment(const Uint8 *data, int size, FragmentPacket *pkt);
+
+/**
+ * Write a game state packet: header fields followed by an encoded state payload
+ *
+ * @param data Output buffer
+ * @param max_size Size of the output buffer in bytes
+ * @param pkt Packet header, tick, baseline tick and reliable block
+ * @param payload State bytes produced by codec_write_state()
+ * @param payload_size Size of the payload in bytes
+ * @return Number of bytes written, or -1 if the buffer is too small
+ */
+int codec_write_state_packet(Uint8 *data, int max_size, const GameStatePacket *pkt,
+                             const Uint8 *payload, int payload_size);
+
+/**
+ * Read the fields of a game state packet in front of the state payload
+ *
+ * @param data Received datagram
+ * @param size Datagram length in bytes
+ * @param pkt Receives header, tick, baseline tick and reliable block
+ * @param payload_offset Receives the byte offset of the state payload
+ * @return 1 on success, 0 if the datagram is malformed
+ */
+int codec_read_state_packet(const Uint8 *data, int size, GameStatePacket *pkt, int *payload_offset);
+
+/**
+ * Encode the quantized fields of current that differ from baseline
+ * Inactive slots are skipped; a NULL baseline encodes a keyframe
+ * Bullets are not part of the state; see codec_write_projectile_events()
+ *
+ * @param data Output buffer
+ * @param max_size Size of the output buffer in bytes
+ * @param baseline State the receiver already has, or NULL
+ * @param current State to encode
+ * @return Number of bytes written, or -1 if the buffer is too small
+ */
+int codec_write_state(Uint8 *data, int max_size, const GameState *baseline, const GameState *current);
+
+/**
+ * Estimate what one slot costs in codec_write_state() beyond the single
+ * "unchanged" bit every active slot pays
+ * Used to fit snapshots into a per-client byte budget
+ *
+ * @param base Slot as the receiver has it
+ * @param current Slot to send
+ * @return Extra bits, or 0 if the slot is unchanged
+ */
+int codec_player_delta_bits(const NetworkPlayer *base, const NetworkPlayer *current);
+int codec_enemy_delta_bits(const NetworkEnemy *base, const NetworkEnemy *current);
+
+/**
+ * Decode a state payload directly into its destination
+ *
+ * @param data Encoded state
+ * @param size Size of the encoded state in bytes
+ * @param baseline State the payload was encoded against, or NULL for a keyframe
+ * @param out Receives the decoded state (must not alias baseline); its
+ *            capacity must match the encoder's
+ * @return Number of bytes consumed, or -1 if the payload is malformed
+ */
+int codec_read_state(const Uint8 *data, int size, const GameState *baseline, GameState *out);
+
+/**
+ * Encode a batch of projectile events
+ * The batch is the contiguous run of logged events ending at
+ * last_sequence, optionally followed by a resync listing the live
+ * projectiles of a slot range as spawns
+ *
+ * @param data Output buffer
+ * @param max_size Size of the output buffer in bytes
+ * @param tick Tick of the snapshot carrying the batch
+ * @param resync Slot range the last resync->spawns events cover, or NULL
+ * @param last_sequence Sequence of the newest logged event the batch covers
+ * @param events Logged events, then the resync's spawns
+ * @param count Number of events of both kinds
+ * @return Number of bytes written, or -1 if the buffer is too small
+ */
+int codec_write_projectile_events(Uint8 *data, int max_size, Uint32 tick, const ProjectileResync *resync,
+                                  Uint32 last_sequence, const ProjectileEvent *events, int count);
+
+/**
+ * Decode a batch of projectile events
+ *
+ * @param data Encoded batch
+ * @param size Size of the encoded batch in bytes
+ * @param tick Tick of the snapshot carrying the batch
+ * @param resync Receives the resync range, inactive if the batch has none
+ * @param last_sequence Receives the newest sequence covered by the batch
+ * @param events Receives the events, logged ones with sequence numbers
+ *               filled in and the resync's spawns last
+ * @param max_events Capacity of the events array
+ * @return Number of events, or -1 if the batch is malformed
+ */
+int codec_read_projectile_events(const Uint8 *data, int size, Uint32 tick, ProjectileResync *resync,
+                                 Uint32 *last_sequence, ProjectileEvent *events, int max_events);
+
+#endif // NETWORK_CODEC_H
@@ -2,13 +2,44 @@
 #define NETWORK_COMMON_H
 #include <SDL2/SDL_net.h>
 
-#define MAX_PLAYERS 4
-#define MAX_BULLETS_PER_PLAYER 100
-#define MAX_ENEMIES 10
-#define MAX_ENEMY_BULLETS 50
+// Protocol ceilings; each room runs with the capacities in its RoomCapacity
+#define MAX_PLAYERS 256
+#define MAX_BULLETS_PER_PLAYER 1024
+#define MAX_ENEMIES 1024
+#define MAX_ENEMY_BULLETS 4096
+#define MAX_EXPLOSIONS 1024
+
+// Room capacities a server uses unless told otherwise
+#define DEFAULT_PLAYERS 4
+#define DEFAULT_BULLETS_PER_PLAYER 100
+#define DEFAULT_ENEMIES 10
+#define DEFAULT_ENEMY_BULLETS 50
+#define DEFAULT_EXPLOSIONS 20
+
 #define MAX_PACKET_SIZE 8192
+#define NET_MTU 1200  // Largest datagram sent without fragmenting
 #define SERVER_PORT 9999
-#define TICK_RATE 30  // Updates per second
+#define TICK_RATE 30  // Default simulation rate, ticks per second (server --tick-rate)
+#define MAX_TICK_RATE 128  // Highest simulation or snapshot rate a server may run
+#define TICK_TIME_MS(tick, rate) ((Uint32)((Uint64)(tick) * 1000 / (rate)))  // Simulation time of a tick
+
+// Wrap-safe sequence comparison
+// Sequences, ticks and message ids are Uint32 counters that wrap; a comes
+// before b when it is less than half the range behind it
+#define SEQUENCE_BEFORE(a, b) ((Sint32)((a) - (b)) < 0)
+#define EXPLOSION_DURATION 500  // Explosion lifetime in milliseconds
+
+// Entity limits of one room, fixed when the room is created
+// The server picks them at startup and sends them in the connect response;
+// both sides size every per-entity array from them, and slot numbers on
+// the wire are below them
+typedef struct {
+    int players;
+    int bullets_per_player;
+    int enemies;
+    int enemy_bullets;
+    int explosions;         // Explosion animations a client plays at once
+} RoomCapacity;
 
 // Player input structure
 typedef struct {
@@ -37,7 +68,6 @@ typedef struct {
     int active;
     int alive;
     int bullet_count;
-    NetworkBullet bullets[MAX_BULLETS_PER_PLAYER];
     int bullets_fired;
     int reloading;
     Uint32 reload_start_time;
@@ -47,6 +77,7 @@ typedef struct {
 
 // Enemy structure for network
 typedef struct {
+    Uint32 id;       // Generation-tagged id; changes whenever the slot gets a new enemy
     float x, y;
     int texture_id;  // 0-5 for different enemy textures
     int active;
@@ -68,24 +99,97 @@ typedef struct {
 } NetworkExplosion;
 
 // Complete game state
+// Arrays are sized by capacity and owned by whoever initialized the state
+// (see game_state_init()), so copy states with game_state_copy(). Bullets
+// and explosions are only filled in for display and are NULL elsewhere.
 typedef struct {
-    NetworkPlayer players[MAX_PLAYERS];
-    NetworkEnemy enemies[MAX_ENEMIES];
-    NetworkEnemyBullet enemy_bullets[MAX_ENEMY_BULLETS];
-    NetworkExplosion explosions[20];
+    RoomCapacity capacity;
+    NetworkPlayer *players;
+    NetworkEnemy *enemies;
+    NetworkBullet *player_bullets;      // capacity.bullets_per_player per player, or NULL
+    NetworkEnemyBullet *enemy_bullets;  // Or NULL
+    NetworkExplosion *explosions;       // Or NULL
     int player_count;
     int enemy_count;
     int enemy_bullet_count;
     Uint32 tick;
 } GameState;
 
+// Projectile replication events
+typedef enum {
+    PROJECTILE_SPAWN,
+    PROJECTILE_DESPAWN
+} ProjectileEventType;
+
+#define PROJECTILE_OWNER_ENEMY -1  // Owner id used for enemy bullets
+
+// Spawn or despawn of one bullet slot; clients simulate bullets from spawns
+typedef struct {
+    Uint32 sequence;
+    Uint32 tick;      // Tick the bullet spawned (origin time) or despawned
+    int type;         // ProjectileEventType
+    int owner;        // Player id, or PROJECTILE_OWNER_ENEMY
+    int slot;         // Index in the owner's bullet array
+    float x, y;       // Spawn origin
+    float vx, vy;     // Spawn velocity
+} ProjectileEvent;
+
+// Part of a projectile batch that resynchronises a range of slots
+// Slots are numbered flat: each player's bullets_per_player in turn, then
+// the enemy bullets. The receiver drops what it holds in [first, end) and
+// takes the listed spawns instead; a range starting at 0 drops everything.
+typedef struct {
+    int active;
+    int first;
+    int end;
+    int spawns;       // Trailing events of the batch listing the range's live bullets
+} ProjectileResync;
+
+// Discrete gameplay events delivered once, in order, over the reliable channel
+typedef enum {
+    EVENT_PLAYER_JOINED,
+    EVENT_PLAYER_LEFT,
+    EVENT_PLAYER_DIED,
+    EVENT_PLAYER_RESPAWNED,
+    EVENT_EXPLOSION
+} GameEventType;
+
+typedef struct {
+    int type;       // GameEventType
+    int player_id;  // Player involved, or -1
+    float x, y;     // Where it happened
+    int value;      // Score at death, otherwise 0
+} GameEvent;
+
+// Reliable channels, each with its own sequence numbers and ordering
+#define RELIABLE_CHANNEL_CONTROL 0   // Joins and leaves
+#define RELIABLE_CHANNEL_GAMEPLAY 1  // Deaths, respawns, explosions
+#define RELIABLE_CHANNELS 2
+#define MAX_RELIABLE_PER_PACKET 16
+
+typedef struct {
+    int channel;
+    Uint32 sequence;
+    GameEvent event;
+} ReliableMessage;
+
+// Reliable section piggybacked on input and game state packets
+typedef struct {
+    int has_ack[RELIABLE_CHANNELS];
+    Uint32 ack[RELIABLE_CHANNELS];       // Every sequence below this was received
+    Uint32 ack_bits[RELIABLE_CHANNELS];  // Bit i: ack + 1 + i was received
+    int count;
+    ReliableMessage messages[MAX_RELIABLE_PER_PACKET];
+} ReliableBlock;
+
 // Packet types
 typedef enum {
     PACKET_CONNECT,
     PACKET_DISCONNECT,
     PACKET_INPUT,
     PACKET_GAME_STATE,
-    PACKET_PING
+    PACKET_PING,
+    PACKET_FRAGMENT
 } PacketType;
 
 // Network packet header
@@ -95,10 +199,15 @@ typedef struct {
     Uint32 sequence;
 } PacketHeader;
 
+// Snapshot payload compression, negotiated on connect
+#define COMPRESSION_NONE 0
+#define COMPRESSION_RANGE 1  // Range coder with the static snapshot model
+
 // Connect request
 typedef struct {
     PacketHeader header;
     char player_name[32];
+    int compression;      // Best compression the client can decode
 } ConnectPacket;
 
 // Connect response
@@ -106,18 +215,41 @@ typedef struct {
     PacketHeader header;
     int assigned_id;
     int success;
+    int compression;      // Compression the server will use for this client
+    int tick_rate;        // Server simulation ticks per second; input and snapshot ticks count these
+    RoomCapacity capacity;  // Limits of the room joined
 } ConnectResponse;
 
+#define INPUT_REDUNDANCY 8   // Most recent inputs repeated in every input packet
+
 // Input packet
 typedef struct {
-    PacketHeader header;
-    PlayerInput input;
+    PacketHeader header;  // sequence: client input tick of inputs[0]
+    int input_count;
+    PlayerInput inputs[INPUT_REDUNDANCY];  // inputs[i] is for tick sequence - i
+    Uint32 ack_tick;      // Latest state tick the client decoded (0 = none yet)
+    Uint32 ack_delay;     // Milliseconds between decoding ack_tick and sending this packet
+    Uint32 ack_bits;      // Bit i: state tick ack_tick - 1 - i was received
+    Uint32 view_lag;      // Eighths of a tick the rendered world was behind ack_tick when inputs[0] was sampled
+    ReliableBlock reliable;
 } InputPacket;
 
-// Game state packet
+// Game state packet, followed on the wire by the encoded state
 typedef struct {
     PacketHeader header;
-    GameState state;
+    Uint32 tick;
+    Uint32 baseline_tick; // Tick the delta is based on (0 = keyframe)
+    Uint32 input_ack;     // Receiver's input tick applied last in this state (0 = own player not included)
+    int compressed;       // Payload is range coded (see network_compress.h)
+    ReliableBlock reliable;
 } GameStatePacket;
 
+// Fragment of a message larger than NET_MTU, followed on the wire by its bytes
+// header.sequence identifies the message all of its fragments belong to
+typedef struct {
+    PacketHeader header;
+    int fragment_index;
+    int fragment_count;
+} FragmentPacket;
+
 #endif // NETWORK_COMMON_H
\ No newline at end of file
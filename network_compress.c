@@ -0,0 +1,205 @@
+#include <string.h>
+#include "network_compress.h"
+
+// Range coder over bytes with a static order-1 model. The context is the
+// high nibble of the previous byte, which separates the runs of small
+// values (unchanged flags, short varints) from quantized coordinates.
+//
+// The model was trained on snapshot payloads recorded with
+// `./server --train-model`; every byte value keeps a nonzero weight so
+// any payload stays encodable.
+
+#define COMPRESS_TOTAL (1 << COMPRESS_TOTAL_BITS)
+#define RANGE_TOP (1u << 24)
+
+static const Uint8 model_weights[COMPRESS_CONTEXTS][256] = {
+#include "network_compress_model.h"
+};
+
+static Uint16 freq[COMPRESS_CONTEXTS][256];
+static Uint16 cum[COMPRESS_CONTEXTS][257];
+static Uint8 lookup[COMPRESS_CONTEXTS][COMPRESS_TOTAL];  // Cumulative count -> symbol
+static int initialized = 0;
+
+static Uint32 train_counts[COMPRESS_CONTEXTS][256];
+static Uint32 saved_counts[COMPRESS_CONTEXTS][256];  // What compress_print_model() writes
+
+void compress_init(void) {
+    if (initialized) return;
+
+    for (int c = 0; c < COMPRESS_CONTEXTS; c++) {
+        Uint32 sum = 0;
+        for (int s = 0; s < 256; s++) sum += model_weights[c][s];
+
+        // Scale to the fixed total, keeping every symbol codable
+        int total = 0, largest = 0;
+        for (int s = 0; s < 256; s++) {
+            int f = 1 + (int)((Uint32)model_weights[c][s] * (COMPRESS_TOTAL - 256) / sum);
+            freq[c][s] = (Uint16)f;
+            total += f;
+            if (freq[c][s] > freq[c][largest]) largest = s;
+        }
+        freq[c][largest] = (Uint16)(freq[c][largest] + COMPRESS_TOTAL - total);
+
+        cum[c][0] = 0;
+        for (int s = 0; s < 256; s++) {
+            cum[c][s + 1] = (Uint16)(cum[c][s] + freq[c][s]);
+            memset(&lookup[c][cum[c][s]], s, freq[c][s]);
+        }
+    }
+    initialized = 1;
+}
+
+// ---------------------------------------------------------------------------
+// Encoder
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    Uint8 *out;
+    int max_size;
+    int pos;
+    int overflow;
+    Uint64 low;
+    Uint32 range;
+} RangeEncoder;
+
+static void encoder_put(RangeEncoder *e, Uint8 byte) {
+    if (e->pos >= e->max_size) {
+        e->overflow = 1;
+        return;
+    }
+    e->out[e->pos++] = byte;
+}
+
+// Carries ripple back through bytes already written
+static void encoder_carry(RangeEncoder *e) {
+    int i = e->pos - 1;
+    while (i >= 0 && e->out[i] == 0xFF) e->out[i--] = 0;
+    if (i >= 0) e->out[i]++;
+    e->low &= 0xFFFFFFFFu;
+}
+
+static void encoder_symbol(RangeEncoder *e, int context, Uint8 symbol) {
+    Uint32 r = e->range >> COMPRESS_TOTAL_BITS;
+    e->low += (Uint64)r * cum[context][symbol];
+    e->range = r * freq[context][symbol];
+    if (e->low >> 32) encoder_carry(e);
+
+    while (e->range < RANGE_TOP) {
+        encoder_put(e, (Uint8)(e->low >> 24));
+        e->low = (e->low << 8) & 0xFFFFFFFFu;
+        e->range <<= 8;
+    }
+}
+
+int compress_encode(const Uint8 *data, int size, Uint8 *out, int max_size) {
+    RangeEncoder e;
+    e.out = out;
+    e.max_size = max_size < size ? max_size : size;  // No point going past the raw size
+    e.pos = 0;
+    e.overflow = 0;
+    e.low = 0;
+    e.range = 0xFFFFFFFFu;
+
+    // Original length as a plain varint
+    Uint32 length = (Uint32)size;
+    do {
+        encoder_put(&e, (Uint8)((length & 0x7F) | (length > 0x7F ? 0x80 : 0)));
+        length >>= 7;
+    } while (length);
+    int header_size = e.pos;
+
+    int context = 0;
+    for (int i = 0; i < size && !e.overflow; i++) {
+        encoder_symbol(&e, context, data[i]);
+        context = data[i] >> 4;
+    }
+
+    // One byte pins a value inside the final range; the decoder reads
+    // missing trailing bytes as zero, so those are dropped
+    e.low = (e.low + RANGE_TOP - 1) & ~(Uint64)(RANGE_TOP - 1);
+    if (e.low >> 32) encoder_carry(&e);
+    encoder_put(&e, (Uint8)(e.low >> 24));
+    while (e.pos > header_size && e.out[e.pos - 1] == 0) e.pos--;
+
+    if (e.overflow || e.pos >= size) return -1;
+    return e.pos;
+}
+
+// ---------------------------------------------------------------------------
+// Decoder
+// ---------------------------------------------------------------------------
+
+int compress_decode(const Uint8 *data, int size, Uint8 *out, int max_size) {
+    int pos = 0;
+    Uint32 length = 0;
+    for (int shift = 0; ; shift += 7) {
+        if (pos >= size || shift > 28) return -1;
+        Uint8 byte = data[pos++];
+        length |= (Uint32)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) break;
+    }
+    if (length > (Uint32)max_size) return -1;
+
+    Uint32 code = 0;
+    for (int i = 0; i < 4; i++) {
+        code = (code << 8) | (pos < size ? data[pos] : 0);
+        pos++;
+    }
+    Uint32 range = 0xFFFFFFFFu;
+
+    int context = 0;
+    for (Uint32 i = 0; i < length; i++) {
+        Uint32 r = range >> COMPRESS_TOTAL_BITS;
+        Uint32 count = code / r;
+        if (count >= COMPRESS_TOTAL) count = COMPRESS_TOTAL - 1;
+
+        Uint8 symbol = lookup[context][count];
+        code -= r * cum[context][symbol];
+        range = r * freq[context][symbol];
+        while (range < RANGE_TOP) {
+            code = (code << 8) | (pos < size ? data[pos] : 0);
+            pos++;
+            range <<= 8;
+        }
+
+        out[i] = symbol;
+        context = symbol >> 4;
+    }
+
+    return (int)length;
+}
+
+// ---------------------------------------------------------------------------
+// Training
+// ---------------------------------------------------------------------------
+
+void compress_train(const Uint8 *data, int size) {
+    int context = 0;
+    for (int i = 0; i < size; i++) {
+        train_counts[context][data[i]]++;
+        context = data[i] >> 4;
+    }
+}
+
+void compress_save_training(void) {
+    memcpy(saved_counts, train_counts, sizeof(train_counts));
+}
+
+void compress_print_model(FILE *out) {
+    fprintf(out, "// Generated by ./server --train-model from recorded snapshot payloads\n");
+    for (int c = 0; c < COMPRESS_CONTEXTS; c++) {
+        Uint32 largest = 0;
+        for (int s = 0; s < 256; s++) {
+            if (saved_counts[c][s] > largest) largest = saved_counts[c][s];
+        }
+
+        fprintf(out, "{\n");
+        for (int s = 0; s < 256; s++) {
+            Uint32 weight = largest ? (Uint32)(((Uint64)saved_counts[c][s] * 255 + largest / 2) / largest) : 1;
+            if (weight < 1) weight = 1;
+            fprintf(out, "%s%3u,%s", s % 16 == 0 ? "    " : "", weight, s % 16 == 15 ? "\n" : " ");
+        }
+        fprintf(out, "},\n");
+    }
+}
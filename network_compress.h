@@ -0,0 +1,60 @@
+#ifndef NETWORK_COMPRESS_H
+#define NETWORK_COMPRESS_H
+
+#include <stdio.h>
+#include "network_common.h"
+
+#define COMPRESS_CONTEXTS 16     // Model context: high nibble of the previous byte
+#define COMPRESS_TOTAL_BITS 12   // Frequencies of each context sum to 1 << 12
+
+/**
+ * Build the coder tables from the static model
+ * Must be called once before compress_encode() or compress_decode()
+ */
+void compress_init(void);
+
+/**
+ * Range-code a payload with the static snapshot model
+ *
+ * @param data Bytes to compress
+ * @param size Number of bytes
+ * @param out Output buffer
+ * @param max_size Size of the output buffer in bytes
+ * @return Compressed size, or -1 if it would not be smaller than the input
+ */
+int compress_encode(const Uint8 *data, int size, Uint8 *out, int max_size);
+
+/**
+ * Decode a payload produced by compress_encode()
+ *
+ * @param data Compressed bytes
+ * @param size Number of compressed bytes
+ * @param out Output buffer
+ * @param max_size Size of the output buffer in bytes
+ * @return Decompressed size, or -1 if the input is malformed
+ */
+int compress_decode(const Uint8 *data, int size, Uint8 *out, int max_size);
+
+/**
+ * Add a payload to the training histogram
+ *
+ * @param data Uncompressed payload as it would be sent
+ * @param size Number of bytes
+ */
+void compress_train(const Uint8 *data, int size);
+
+/**
+ * Keep a copy of the training histogram for compress_print_model()
+ * The copy lets another thread write the model while training goes on;
+ * the caller makes sure the two never run at once
+ */
+void compress_save_training(void);
+
+/**
+ * Write the histogram last saved as a model table for network_compress.c
+ *
+ * @param out Destination stream
+ */
+void compress_print_model(FILE *out);
+
+#endif // NETWORK_COMPRESS_H
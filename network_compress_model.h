@@ -0,0 +1,289 @@
+// Generated by ./server --train-model from recorded snapshot payloads
+{
+    255,  42,  72,   5,  50,   2,  22,   3,  91,   5,  33,   6,  17,   5,  10,   3,
+     57,   4,  15,   5,  15,   8,   5,  10,  15,   4,  13,   1,  15,   3,   4,   8,
+     43,   8,  11,   2,   9,   8,   9,   3,  31,   1,  18,   1,  15,   1,   7,   9,
+     11,   3,   5,   1,   3,   1,   4,   4,   9,   1,   2,   1,   3,   1,   3,   1,
+     65,   3,  14,   3,   8,   1,  10,   1,  21,   1,   8,   1,   9,   1,   6,   1,
+    173,   1,   5,   1,   6,   2,   4,   1,   8,   1,   4,   1,   4,   1,   4,   1,
+     15,   1,   9,   1,   5,   3,   7,   1,  13,   1,   7,   1,   8,   1,   6,   1,
+      7,   1,   2,   1,   3,   1,   3,   1,  12,   1,   2,   1,   4,  52,   3,   1,
+     24,  10,  11,   3,   7,   1,   7,   2,   7,   1,   6,   1,   9,   2,   6,   1,
+    158,   1,   3,   1,   4,   1,   4,   1,  11,   3,   3,   1,   5,   1,   7,   1,
+     16,  17,   4,   1,   6,   1,   5,   1,   8,   1,   4,   1,   6,   1,   4,   1,
+      8,   1,   4,   1,   3,   2,   4,   1,   6,   1,   3,   1,   4,   1,   4,   1,
+     22,   1,   4,   1,   7,   1,   5,   1,   4,   1,   5,   1,   6,   2,   4,   1,
+      6,   1,   4,   1,   3,   1,   3,   2,   7,   1,   3,   1,   3,   1,   2,   1,
+      5,   3,   8,   2,   5,   1,   5,   1,   4,   1,   2,   1,   8,   1,   3,   1,
+      8,   3,   3,   1,   2,   1,   5,   1,   4,   1,   3,   1,   4,   1,   3,   1,
+},
+{
+    219,   2,  38,   3,  29,   1,   9,   1,  11,   2,   3,   2,   6,   1,   1,   1,
+      5,   1,   1,   1,   7,   1,   6,   1,   1,   8,   1,   8,   5,   1,   5,   1,
+      8,   3,   1,   3,   9,   1,   2,   1,   8,   6,   1,   1,   4,   1,   5,   1,
+      6,   1,   1,   1,   5,   1,   1,   1,   2,   1,   1,   1,   4,   1,   1,   1,
+      5,   1,   5,   1,   4,   1,   1,   1,   5,   1,   1,   1,   4,   1,   1,   1,
+    255,   1,   1,   1,   5,   1,   1,   1,   1,   1,   1,   1,   4,   1,   1,   1,
+     23,   1,   1,   1,   4,   1,   1,   1,   1,   1,   1,   1,   3,   1,   1,   1,
+      3,   1,   1,   1,   4,   1,   1,   1,   1,   1,   1,   2,   4,   1,   1,   1,
+      2,   1,   1,   1,   5,   1,   1,   1,   1,   1,   1,   1,   4,   1,   1,   1,
+      9,   1,   1,   1,   3,   1,   1,   1,   1,   1,   1,   1,   3,   1,   1,   1,
+      7,  13,   1,   1,   2,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      2,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   2,   1,   1,   1,
+     15,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      2,   1,   1,   1,   1,   1,   1,   1,   1,   1,   3,   1,   1,   1,   1,   1,
+},
+{
+    160,   4,  13,   5,  14,   1,   3,   1,   5,   1,   1,   2,   6,   2,   1,   1,
+     23,   4,   1,   3,   5,   5,   1,   1,   7,   2,   7,   1,   4,   6,   1,   4,
+     20,   4,   2,   7,   3,   1,   1,   1,  10,   1,   2,   1,   4,   7,   1,   2,
+      9,   3,   4,   1,   4,   1,   1,   1,   1,   1,   1,   1,   4,   1,   1,   1,
+      4,   2,   1,   1,   3,   1,   1,   1,   1,   1,   1,   1,   3,   1,   1,   1,
+     15,   2,   1,   1,   5,   1,   1,   1,   1,   1,   1,   1,   5,   1,   1,   1,
+     25,   2,   1,   1,   4,   1,   1,   1,   1,   1,   1,   1,   4,   1,   1,   1,
+      4,   3,   1,   1,   4,   1,   1,   1,   1,   1,   1,   1,   4,   1,   1,   1,
+      4,   4,   1,   3,   5,   1,   1,   1,   1,   1,   1,   1,   3,   1,   1,   1,
+    255,   2,   1,   1,   3,   1,   1,   1,   1,   1,   1,   1,   4,   1,   1,   1,
+      6,   7,   1,   1,   3,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      1,   3,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      3,   2,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      1,   3,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+     16,   2,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      1,   3,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+},
+{
+    248,   9,  24,  24,  25,   6,  10,   7,  27,   8,   7,  10,   8,   2,   1,   6,
+     15,   7,   6,   5,  30,   4,   1,  53,   4,  75,   7,  10,  50,   7,  29,  10,
+     38,  27,  41,  19,  15,   1,   1,  43,   5,  10,   3,   1,  46,   1,  11,   1,
+      7,  49,   1,   7,   3,   1,   3,   1,   3,   1,   1,   2,   6,   1,   1,   1,
+      8,   4,   4,  21,   8,   4,   5,   4,   6,   1,   1,   1,   9,   1,   1,   1,
+     60,   3,   1,   1,   4,   2,   2,   1,   1,   2,   1,   4,   4,   1,   1,   1,
+     39,   1,   1,   1,   2,   3,   1,   1,   1,   1,   1,   1,   7,   1,   1,   1,
+      5,   2,   1,   1,   5,   1,   1,   1,   1,   2,   1,   1,   4,   1,   1,   1,
+     18,  15,   5,  16,  10,   3,   9,   1,   2,   1,   1,   1,   2,   1,   1,   1,
+    255,   1,   1,   1,   5,   1,   1,   1,   2,   1,   1,   2,   8,   1,   1,   1,
+     46,  26,   2,   1,   4,   1,   1,   1,   4,   1,   1,   1,   1,   1,   1,   1,
+      1,   1,   1,   1,   1,   1,   1,   1,   4,   1,   1,   1,   1,   1,   1,   1,
+      4,   2,   1,   5,   1,   1,   4,   1,   3,   1,   1,   1,   1,   1,   1,   1,
+      1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+     18,   1,   1,   1,   1,   1,   1,   1,   2,   1,   1,   1,   1,   1,   1,   1,
+      1,   1,   1,   1,   1,   1,   1,   1,   3,   1,   1,   1,   1,   1,   1,   1,
+},
+{
+    255,  10,  13,  16,   4,   2,   2,   2,  22,   6,   4,   5,   1,   1,   2,   2,
+     38,   8,   2,  15,   1,   6,  12,   3,  29,  11,   5,  19,   1,  17,   3,   3,
+     50,  18,   6,   8,   1,   1,  16,   1,   6,   1,   1,  18,   1,   4,   1,   1,
+     17,   1,   4,   1,   1,   1,   1,   1,   2,   1,   1,   2,   1,   1,   1,   1,
+      7,   1,   1,   4,   1,   1,   1,   1,   3,   1,   1,   1,   1,   1,   1,   1,
+     18,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      5,   1,   1,   1,   1,   1,   4,   1,   2,   1,   1,   1,   1,   1,   1,   1,
+      1,   4,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      8,   7,   3,   4,   4,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+     14,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,  40,
+      3,  11,   1,   1,   7,   1,   1,   1,   1,   3,   1,   1,   1,   1,   1,   1,
+      1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      8,   1,   1,   2,   1,   1,   1,   1,   1,   1,   1,   2,   1,   1,   1,   1,
+      1,   1,   1,   1,   1,   2,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      5,   1,   1,   1,   1,   1,   1,   1,  34,   1,   1,   1,   1,   1,   1,   1,
+      1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+},
+{
+    246,  15,   7,  26,  23,   8,   8,  13, 182,   4,   5,  11,   8,  22,   3,  14,
+    189,  12,  13,  13,   4,  76,   7,  84, 157,  14,  64,  14,  58,  21,   7,  45,
+    255,  36,  16,  11,   1,  65,   1,  17, 156,   1,  71,   4,  21,   1,   1,  73,
+    151,  18,   1,   1,   4,   1,   1,   1, 161,   5,   1,   1,   1,   1,   3,   3,
+    134,   5,   5,   9,   1,   3,   1,   1, 153,   1,   5,   1,   1,   1,   1,   2,
+    214,   1,   3,   1,   4,   1,   1,   1, 142,   4,   1,   1,   4,   1,   1,   1,
+    166,   3,   1,   2,   1,   3,   1,   1, 141,   1,   1,   1,   1,   1,   1,   1,
+    142,   1,   1,   1,   1,   1,   1,   1, 157,   3,   1,   1,   1,   1,   1,   1,
+    175,  28,   9,  12,  13,   6,   1,   1, 148,   1,   4,   1,   1,   1,   1,   1,
+    213,   1,   1,   1,   1,   1,   1,   1, 151,   1,   2,   1,   1,   1,   1,   1,
+    157,  45,   1,   1,   1,   3,   1,   1, 138,   1,   1,   1,   1,   1,   1,   1,
+    143,   1,   1,   1,   1,   1,   1,   1, 132,   1,   1,   1,   1,   1,   1,   1,
+    166,   2,   2,   4,   3,   1,   1,   1, 150,   1,   1,   1,   1,   1,   1,   1,
+    147,   1,   1,   1,   1,   1,   1,   1, 147,   1,   1,   1,   1,   1,   1,   1,
+    152,   1,   1,   1,  12,   1,   1,   1, 216,   1,   1,   1,   1,   1,   1,   1,
+    145,   1,   1,   1,   1,   1,   1,   1, 154,   1,   1,   1,   1,   1,   1,   1,
+},
+{
+    161,  28,  35,  63,  26,  14,  18,  33,  44,  34,   3,  30,  26,  95,   7,  20,
+    255,  43,   5,  17,  77,  19, 108,  47,  15, 158,   8, 156,  37,  36,  73,  18,
+    255,  49,   3,  58, 122,   6,  26,   1,   1, 134,   3,  33,   3,   6, 136,  12,
+     48,   5,  10,  22,   5,   9,   9,   6,   9,  18,  12,   1,   4,   1,   7,   3,
+     14,   4,  25,  18,   6,   6,   9,  15,   4,   5,  11,  26,   1,   6,   5,   4,
+    113,   8,   1,   6,   8,   8,  15,   6,  12,   8,  13,  15,   1,   6,   9,   6,
+     21,   2,   6,   3,   6,   2,   3,   5,   2,   8,   4,   4,   9,   5,   1,  11,
+      9,   1,   1,  21,  10,   3,   1,   3,   1,   2,   2,   5,   4,   4,   1,   6,
+     39,  25,  22,  42,  19,  16,   6,   5,  17,  22,   1,   6,   2,   6,   5,   3,
+    104,  13,   2,   1,   4,   6,   1,   4,   1,  14,   1,   2,   5,   2,   1,   8,
+      7,  85,   2,   6,   5,  11,   4,   1,   1,  12,  10,   2,   1,  16,   4,   4,
+      1,  37,   1,   3,   1,   6,   1,   4,   6,  10,   6,   6,   1,   6,   2,  16,
+     11,   6,  56,  17,   4,   1,   3,   4,   4,   1,   6,  13,   1,   6,   4,   1,
+      3,   4,   8,  11,   1,   4,   1,   3,   4,   1,   3,   1,   2,   2,   2,   6,
+     20,   3,   1,  13,   8,   1,   1,  12, 211,   1,   1,  11,   1,   1,   1,   2,
+      1,   5,   4,   6,   8,   5,   1,   4,   8,   8,   1,   8,  18,   7,   1,   1,
+},
+{
+     23,   6, 255,  10,   9,   7,   5,   6,  11,   6,   3,   9,  12,  11,   3,   6,
+     11,   3,   1,  23,   1,  42,   3,  15,  43,   6,  48,  12,   3,  32,   1,  21,
+      9,   6,  11,  49,   1,  11,   1,   1,  37,   1,   7,   1,   1,  40,   1,  10,
+      1,   1,  20,   1,   3,   1,   1,   3,   1,   1,   1,   1,   2,   5,   1,   1,
+      1,   3,   4,   1,   3,   2,   6,   1,   2,   1,   1,   1,   1,   1,   1,   1,
+     34,   1,   3,   1,   1,   1,   1,   1,   1,   1,   1,   1,   4,   1,   1,   1,
+      5,   5,   1,   1,   1,   1,   2,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+     11,  14,  12,  10,  11,   3,   3,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+     36,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      3,  26,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      1,   1,   1,   3,   3,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      4,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+},
+{
+    255,  18,   7,  16,   8,   6,   6,   9,   8,   7,  17,  11,   7,   8,   1,  18,
+     41,   5,  12,   6,  24,   7,   2,  43,   1,  49,   9,  11,  25,   5,  23,  11,
+     43,  13,  33,  15,   7,   1,   1,  33,   5,  10,   3,   3,  38,   5,   8,   1,
+      8,  28,   2,  21,   1,   1,   4,   2,   4,   1,   1,   2,   4,   8,   1,   1,
+      7,   4,   8,   6,   1,   3,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+     31,   2,   1,   1,   2,   3,   2,   1,   1,   1,   2,   2,   1,   1,   1,   2,
+      6,   1,   1,   1,   3,   1,   1,   5,   1,   2,   1,   1,   1,   1,   3,   1,
+      1,   1,   1,   2,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+     31,   8,   1,   3,   3,   1,   1,   1,   1,   1,   1,   2,   3,   1,   1,   1,
+     22,   2,   1,   1,   1,   1,   7,   1,   1,   1,   1,  12,   1,   1,   1,   1,
+      9,  22,   1,   1,   1,   6,   1,   1,   1,   1,   3,   1,   1,   1,   1,   1,
+      1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      4,   1,   4,   5,   1,   1,   1,   2,   1,   1,   1,   1,   1,   1,   1,   1,
+      1,   3,   1,   1,   1,   1,   1,   3,   6,   1,   1,   2,   1,   1,   1,   1,
+      2,   1,   1,   1,   1,   2,   1,   1,   1,   1,   2,   1,   1,   1,   1,   1,
+      1,   1,   1,   1,   1,   1,   1,   1,   1,   2,   1,   1,   1,   1,   1,   1,
+},
+{
+    255,  16,   9,   9,   2,  34,   3,   7,  43,   2,   4,  10,   4,   3,   2,   7,
+    116,   6,   2,  19,   2,   4,  37,   8,  87,  12,   4,  48,   2,  33,   9,  14,
+    175,  33,  13,  12,   1,   1,  32,   1,  44,   1,   1,  34,   1,   9,   1,   1,
+    184,   1,   9,   1,   1,   2,   1,   1,  39,   1,   1,   1,   1,   1,   1,   1,
+    140,   1,   3,   3,   2,   1,   1,   1,  37,   1,   1,   2,   1,   1,   1,   1,
+    169,   1,   1,   1,   1,   2,   2,   1,  41,   1,   3,   1,   1,   2,   1,   2,
+    124,   1,   1,   1,   1,   1,   1,   1,  31,   1,   1,   1,   1,   1,   1,   1,
+    135,   1,   1,   1,   1,   1,   1,   1,  33,   1,   1,   1,   1,   1,   1,   1,
+    160,   3,   2,   5,   1,   1,   1,   1,  34,   1,   1,   1,   1,   1,   1,   1,
+    162,   1,   1,   1,   1,   1,   1,   1,  35,   1,   1,   1,   1,   1,   1,   1,
+    145,  72,   1,   1,   1,   1,   1,   1,  40,   1,   1,   1,   1,   1,   1,   1,
+    113,   1,   1,   1,   1,   1,   1,   1,  39,   1,   1,   1,   1,   1,   1,   1,
+    134,   1,   1,   2,   1,   1,   1,   1,  34,   1,   1,   1,   1,   1,   1,   1,
+    131,   1,   1,   1,   1,   1,   1,   1,  36,   1,   1,   1,   1,   1,   1,   1,
+    162,   1,   5,   1,   1,   1,   1,   1,  43,   1,   1,   1,   1,   1,   1,   1,
+    144,   1,   1,   1,   1,   1,   1,   1,  37,   1,   1,   1,   1,   1,   1,   1,
+},
+{
+     13,   3,   3,   7,   1,   6,   3,   4,   4,   2,   2,   4,   3,   3,   1,   5,
+     28,   3,   5,   3,   1,  18,   1,  29,   3,   7,  23,   3,  19,   9,   2,  17,
+     25,   7,   6,   3,   1,  24,   1,   7,   2,   1,  23,   1,   5,   1,   1,  25,
+      9,   5,   1,   1,   3,   1,   1,   1,   6,   1,   1,   1,   1,   1,   1,   1,
+      7,   1,   8,   2,   1,   1,   1,   2,   1,   1,   1,   1,   1,   1,   1, 255,
+      8,   2,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      6,   1,   1,   1,   1,   2,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      5,   1,   1,   1,   1,   1,   1,   1,   2,   1,   1,   1,   1,   1,   1,   1,
+      6,   1,   1,   2,   1,   1,   1,   1,   1,   1,   1,   1,   2,   1,   1,   1,
+      5,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+     10,  40,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      6,   1,   1,   1,   1,   1,   1,   1,   4,   1,   1,   1,   1,   1,   1,   1,
+      9,   1,   3,   2,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      5,   1,   1,   1,   1,   1,   1,   1,   3,   1,   1,   1,   1,   1,   1,   1,
+      6,   2,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      6,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+},
+{
+     50,  18,  43,  59,  13,  31,   6,  15,  26,  24,   1,  30,  42,  18,   9,  64,
+     10,  46,   2,  32, 111,  27, 151,  46,  10, 255,  12, 190,  37,  44, 118,  46,
+     72,  27,   1,  60, 173,   1,  50,   1,   1, 161,   4,  46,   2,   1, 166,   4,
+     58,   1,   1,  19,   4,   1,   1,   1,  13,   7,   1,   1,   1,   6,   6,   1,
+     23,   7,  49,   7,   8,   1,   4,   8,   1,  10,   1,   4,   1,   1,   8,   1,
+      9,   1,   1,  10,  12,   1,   1,   1,  10,   1,   1,   9,   1,  11,   2,   1,
+      2,   2,  10,  24,   1,   1,   1,   5,   1,   4,   1,   1,   1,   1,   1,   1,
+      6,   1,   1,   1,   1,   2,   2,   1,   2,   1,   1,   1,   1,   1,   1,   1,
+      6,   1,  15,  16,   1,   1,   1,   1,   1,   1,   2,   3,   1,   1,   1,   1,
+      4,   1,   1,   1,   1,   1,   1,   1,   1,   2,   1,   1,   1,   1,   1,   1,
+     10,   1,   1,   1,   3,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      3,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      2,   1,  11,   8,   1,   1,   1,   2,   1,   1,   1,   1,   1,   1,   1,   1,
+     13,   1,   1,   1,   1,   1,   1,   1,   3,   1,   1,   1,   1,   1,   1,   1,
+     10,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   4,   1,   1,   1,   1,
+      9,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+},
+{
+     72,  33,  53,  51,  31,  32,  13,  36,  18,  38,  19,  37,  57,  29,  10,  41,
+    180,  31,  13, 109,   8, 220,   3,  33, 216,  81, 255,  59,  22, 174,  12, 101,
+    136,  21,  52, 208,   6,  40,   1,   1, 190,   9,  69,   1,   1, 198,  26,  45,
+     16,   1,  53,   1,   4,   7,   1,  11,  16,   1,   1,   1,   4,  13,   1,   3,
+     25,  13,  30,  10,   1,   3,  18,   9,   5,   9,  16,   1,   8,   5,   1,  11,
+      6,  15,  12,   1,  28,   2,   5,   4,   1,  13,   7,   8,   9,   2,   1,  10,
+     25,   9,   7,  14,   1,  10,   3,   1,   2,   1,   7,   1,   5,   2,   1,   5,
+      1,   1,  12,   1,  30,   1,   2,   1,   1,   4,   2,   1,   1,   1,   6,   1,
+      7,   1,  14,  28,   9,   1,   3,   6,  10,   1,   1,   1,   1,   7,   3,   1,
+     12,   2,   4,   1,   3,   1,   2,  15,   1,   3,   2,   1,  14,   1,   4,   1,
+     32,  26,   1,  17,   2,   4,  16,   1,   8,   3,  10,  85,   1,   1,   3,  15,
+      8,   4,   4,   4,   6,   1,   5,   1,   1,   1,   1,   4,   1,   1,   8,   1,
+     10,   6,  13,  42,   1,   1,   1,   1,   4,   2,   1,   1,   1,  24,   9,   1,
+     14,   1,   5,  10,   1,   1,   4,   7,   5,   1,   1,   4,   9,   1,   1,   1,
+     21,  11,   2,   1,   1,   1,  19,   1,   2,   1,   1,   6,   1,   1,   4,   1,
+      3,   1,   3,   1,   1,  15,   4,   1,   2,   1,  10,   2,   1,   1,   1,   5,
+},
+{
+     64,  19,  37,  22,   3,  32,  23,  35,  24,  36,  16,  38,  66,  11,  11,  37,
+     10,  37,  50,  26, 138,  16,  12, 207,   3, 255,  31,  49, 159,  46,  91,  68,
+     55,  87, 171,  62,  53,   1,   1, 185,   1,  42,   1,   3, 144,   1,  52,   6,
+      1, 140,   3,  19,   1,   1,   9,   1,   1,   1,   1,   5,   2,   1,   1,   1,
+     41,   5,  52,  31,   3,  14,   1,  14,   1,   1,   1,   1,   8,   1,   1,   1,
+      1,  13,   7,   1,  19,   1,  13,   2,   1,   1,   1,   4,   3,   1,   2,   1,
+     30,   1,   1,  18,   1,   8,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      3,   1,   3,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+     10,   1,  12,  28,   1,   1,   3,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      1,   1,   1,   1,   1,   1,   1,   1,   3,   1,   1,   1,   1,   1,   1,   1,
+     19,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      2,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   3,   1,   1,   2,   1,
+      7,   3,   9,  13,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      1,   1,   4,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+     21,   1,   1,   1,   1,   1,   3,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+},
+{
+     23,   9,  12,  15,   3,   9,   2,  31,   5,  15,   8,   7,  10,   4,   8,   7,
+     17,  24,   7, 255,   1,   9,  53,  14,  73,  12,   6,  48,   1,  39,  12,  12,
+     33,  46,  16,  22,   1,   1,  57,   1,  16,   1,   1,  54,   2,  15,   2,   3,
+     45,   1,  10,   2,   1,   4,   1,   1,   1,   1,   1,   2,   1,   2,   1,   2,
+      3,   2,  13,  10,   6,   2,   2,   1,   7,   1,   1,   2,   4,   1,   1,   1,
+      2,   1,   2,   2,   2,   3,   2,   1,   7,   2,   3,   1,   4,   6,   1,   2,
+      6,  10,   1,   1,   3,   1,  17,   1,   1,   1,   1,   1,   2,   1,   1,   1,
+      1,   4,   1,   1,   1,   1,   1,   1,   1,   1,   5,   1,   1,   2,   1,   1,
+      5,   1,  14,   9,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      1,   1,   2,   3,   1,   1,   2,   5,   1,   1,   9,   3,   1,   1,   1,   1,
+      8,   2,   1,   2,   1,   1,   1,   1,   1,   1,   2,   5,   1,   1,   1,   2,
+      2,   1,   1,   1,   1,   2,   1,   2,   2,   1,   1,   2,   1,   1,   1,   1,
+      1,   1,   8,   4,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      4,   2,   1,   1,   7,   2,   2,   1,   6,   1,   1,   1,   1,   1,   1,   1,
+     10,   1,   1,   1,   2,   3,   1,   1,   2,   9,   1,   1,   1,   1,   2,   1,
+      4,   1,   3,   1,   1,   2,   1,   1,   1,   2,   1,   1,   1,   1,   1,   2,
+},
+{
+     86,  44,  38,  69, 113,  17,   5,  32,  25,  73,  20,  23,  59,  29,   1,  29,
+     36,  89,  60,  14,  11, 178,   3, 255,  12,  34, 229,  43, 140,  53,  25,  88,
+    133,  68,  73,   1,   1, 192,   1,  42,   1,   1, 192,   4,  48,   1,   3, 228,
+      8,  42,   4,   1,  11,   1,   1,   1,   1,  19,   8,   1,   1,   1,   3,   3,
+     13,   1,  45,  15,   1,  14,   2,   1,   1,   1,  10,   1,   4,   1,   1,  21,
+     12,  11,   9,   1,   4,   1,   1,   1,   1,   6,   6,   1,   4,   1,  11,   5,
+      4,   1,   1,   8,   1,   1,   1,   1,   3,   1,  12,   1,   1,   1,   1,   1,
+      3,   1,   1,   1,   1,   5,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      2,   1,  29,  27,   1,   1,   1,   1,   6,   1,   1,   1,   1,   1,   1,   1,
+      1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   4,   1,   1,   1,
+     21,   2,   6,   1,   1,   3,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      6,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+     15,   1,  35,  10,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      1,   3,   1,   1,   1,   1,   1,   2,   1,   1,   1,   1,   1,   1,   1,   1,
+     10,   3,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      4,   1,   4,   1,   1,   1,   1,   4,   1,   1,   1,   1,   3,   1,   1,   1,
+},
@@ -0,0 +1,91 @@
+#include <string.h>
+#include "network_congestion.h"
+
+void congestion_init(CongestionControl *cc, int budget, float send_rate, int tick_rate, Uint32 now) {
+    memset(cc, 0, sizeof(CongestionControl));
+    cc->send_rate = send_rate;
+    cc->max_rate = send_rate;
+    cc->tick_rate = tick_rate;
+    cc->budget = budget;
+    cc->max_budget = budget;
+    cc->last_adjust = now;
+}
+
+int congestion_should_send(CongestionControl *cc, int ticks) {
+    cc->send_credit += cc->send_rate * ticks / cc->tick_rate;
+    if (cc->send_credit < 1.0f) return 0;
+
+    // One snapshot covers however many ticks ran; credit is not banked
+    cc->send_credit -= 1.0f;
+    if (cc->send_credit > 1.0f) cc->send_credit = 1.0f;
+    return 1;
+}
+
+void congestion_on_sent(CongestionControl *cc, Uint32 tick, Uint32 now) {
+    int index = tick % SNAPSHOT_RING_SIZE;
+
+    // A snapshot still unacknowledged a full ring later never arrived
+    if (cc->sent_tick[index] != 0) cc->lost++;
+
+    cc->sent_tick[index] = tick;
+    cc->sent_time[index] = now;
+}
+
+void congestion_on_ack(CongestionControl *cc, Uint32 ack_tick, Uint32 ack_bits, Uint32 ack_delay, Uint32 now) {
+    if (ack_tick == 0) return;
+
+    for (int i = 0; i < SNAPSHOT_RING_SIZE; i++) {
+        Uint32 tick = cc->sent_tick[i];
+        if (tick == 0 || tick > ack_tick) continue;
+
+        Uint32 distance = ack_tick - tick;
+        int received = distance == 0 || (distance <= 32 && (ack_bits & (1u << (distance - 1))));
+        if (received) {
+            cc->delivered++;
+            if (distance == 0) {
+                // Clients only send when input changes, so leave out the time the ack waited
+                Uint32 elapsed = now - cc->sent_time[i];
+                float sample = (float)(elapsed > ack_delay ? elapsed - ack_delay : 0);
+                cc->srtt = cc->srtt > 0 ? cc->srtt * 0.875f + sample * 0.125f : sample;
+                if (cc->min_rtt == 0 || sample < cc->min_rtt) cc->min_rtt = sample;
+            }
+        } else {
+            cc->lost++;
+        }
+        cc->sent_tick[i] = 0;
+    }
+}
+
+void congestion_update(CongestionControl *cc, Uint32 now) {
+    if (now - cc->last_adjust < RATE_ADJUST_INTERVAL) return;
+    cc->last_adjust = now;
+
+    Uint32 total = cc->delivered + cc->lost;
+    cc->loss = total ? (float)cc->lost / total : 0;
+    cc->delivered = 0;
+    cc->lost = 0;
+
+    int congested = (total > 0 && cc->loss > LOSS_THRESHOLD) ||
+                    (cc->srtt > 0 && cc->srtt > cc->min_rtt + RTT_TOLERANCE);
+
+    if (congested) {
+        // Multiplicative decrease: fewer snapshots first, then smaller ones
+        cc->decreases++;
+        if (cc->send_rate > MIN_SEND_RATE) {
+            cc->send_rate *= RATE_DECREASE;
+            if (cc->send_rate < MIN_SEND_RATE) cc->send_rate = MIN_SEND_RATE;
+        } else {
+            cc->budget = (int)(cc->budget * RATE_DECREASE);
+            if (cc->budget < MIN_SNAPSHOT_BUDGET) cc->budget = MIN_SNAPSHOT_BUDGET;
+        }
+    } else if (total > 0) {
+        // Additive increase: restore snapshot size first, then frequency
+        if (cc->budget < cc->max_budget) {
+            cc->budget += cc->max_budget / 10;
+            if (cc->budget > cc->max_budget) cc->budget = cc->max_budget;
+        } else {
+            cc->send_rate += RATE_INCREASE;
+            if (cc->send_rate > cc->max_rate) cc->send_rate = cc->max_rate;
+        }
+    }
+}
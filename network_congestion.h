@@ -0,0 +1,87 @@
+#ifndef NETWORK_CONGESTION_H
+#define NETWORK_CONGESTION_H
+
+#include "network_common.h"
+#include "network_delta.h"
+
+#define MIN_SEND_RATE 10.0f          // Snapshots per second on the worst links
+#define MIN_SNAPSHOT_BUDGET 200      // Smallest budget a congested client is cut down to
+#define RATE_ADJUST_INTERVAL 500     // Milliseconds between AIMD steps
+#define RATE_INCREASE 2.0f           // Additive increase in Hz per step
+#define RATE_DECREASE 0.75f          // Multiplicative decrease on congestion
+#define LOSS_THRESHOLD 0.05f         // Loss fraction treated as congestion
+#define RTT_TOLERANCE 50.0f          // Queueing delay (ms above min RTT) treated as congestion
+
+// Per-client send rate and snapshot size, adapted from acks, loss and RTT
+typedef struct {
+    float send_rate;      // Snapshots per second
+    float max_rate;       // Configured send rate the controller never exceeds
+    int tick_rate;        // Simulation ticks per second
+    float send_credit;    // Grows by send_rate / tick_rate each tick; a snapshot costs 1
+    int budget;           // Snapshot size limit in bytes
+    int max_budget;       // Configured budget the controller never exceeds
+    Uint32 sent_tick[SNAPSHOT_RING_SIZE];  // Tick sent in each slot (0 = none)
+    Uint32 sent_time[SNAPSHOT_RING_SIZE];  // When it was sent
+    float srtt;           // Smoothed round-trip time in ms (0 = no sample yet)
+    float min_rtt;        // Lowest RTT seen, the uncongested path delay
+    float loss;           // Loss fraction over the last adjustment window
+    Uint32 delivered;     // Snapshots acknowledged this window
+    Uint32 lost;          // Snapshots missing from acks this window
+    Uint32 last_adjust;
+    Uint32 decreases;     // Congestion responses since stats were last printed
+} CongestionControl;
+
+/**
+ * Start a controller at the configured rate and budget
+ *
+ * @param cc Pointer to CongestionControl
+ * @param budget Configured snapshot budget in bytes
+ * @param send_rate Configured snapshots per second, at most tick_rate
+ * @param tick_rate Simulation ticks per second
+ * @param now Current time in milliseconds
+ */
+void congestion_init(CongestionControl *cc, int budget, float send_rate, int tick_rate, Uint32 now);
+
+/**
+ * Decide whether the client gets a snapshot of the current tick
+ * Called once per send opportunity, with the ticks simulated since the last
+ *
+ * @param cc Pointer to CongestionControl
+ * @param ticks Simulation ticks since the previous call
+ * @return 1 if a snapshot is due
+ */
+int congestion_should_send(CongestionControl *cc, int ticks);
+
+/**
+ * Record that a snapshot for a tick went out
+ *
+ * @param cc Pointer to CongestionControl
+ * @param tick Snapshot tick
+ * @param now Current time in milliseconds
+ */
+void congestion_on_sent(CongestionControl *cc, Uint32 tick, Uint32 now);
+
+/**
+ * Process an acknowledgement from an input packet
+ * Takes RTT samples from newly acked snapshots and counts snapshots the
+ * ack window shows as missing as lost
+ *
+ * @param cc Pointer to CongestionControl
+ * @param ack_tick Latest snapshot tick the client decoded
+ * @param ack_bits Bit i set if tick ack_tick - 1 - i was received
+ * @param ack_delay Milliseconds the client held ack_tick before sending the ack
+ * @param now Current time in milliseconds
+ */
+void congestion_on_ack(CongestionControl *cc, Uint32 ack_tick, Uint32 ack_bits, Uint32 ack_delay, Uint32 now);
+
+/**
+ * Apply one AIMD step if the adjustment interval has elapsed
+ * Congestion (loss or queueing delay) cuts the rate first and then the
+ * budget; a clean window restores the budget first and then the rate
+ *
+ * @param cc Pointer to CongestionControl
+ * @param now Current time in milliseconds
+ */
+void congestion_update(CongestionControl *cc, Uint32 now);
+
+#endif // NETWORK_CONGESTION_H
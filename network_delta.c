@@ -0,0 +1,86 @@
+#include <string.h>
+#include "network_delta.h"
+
+int game_state_init(GameState *state, const RoomCapacity *capacity, int display, Arena *arena) {
+    memset(state, 0, sizeof(GameState));
+    state->capacity = *capacity;
+    state->players = arena_alloc(arena, sizeof(NetworkPlayer) * capacity->players);
+    state->enemies = arena_alloc(arena, sizeof(NetworkEnemy) * capacity->enemies);
+    if (!state->players || !state->enemies) return 0;
+    if (!display) return 1;
+
+    state->player_bullets = arena_alloc(arena, sizeof(NetworkBullet) * capacity->players * capacity->bullets_per_player);
+    state->enemy_bullets = arena_alloc(arena, sizeof(NetworkEnemyBullet) * capacity->enemy_bullets);
+    state->explosions = arena_alloc(arena, sizeof(NetworkExplosion) * capacity->explosions);
+    return state->player_bullets && state->enemy_bullets && state->explosions;
+}
+
+void game_state_copy(GameState *dst, const GameState *src) {
+    const RoomCapacity *capacity = &src->capacity;
+    memcpy(dst->players, src->players, sizeof(NetworkPlayer) * capacity->players);
+    memcpy(dst->enemies, src->enemies, sizeof(NetworkEnemy) * capacity->enemies);
+    if (dst->player_bullets && src->player_bullets) {
+        memcpy(dst->player_bullets, src->player_bullets,
+               sizeof(NetworkBullet) * capacity->players * capacity->bullets_per_player);
+        memcpy(dst->enemy_bullets, src->enemy_bullets, sizeof(NetworkEnemyBullet) * capacity->enemy_bullets);
+        memcpy(dst->explosions, src->explosions, sizeof(NetworkExplosion) * capacity->explosions);
+    }
+    dst->player_count = src->player_count;
+    dst->enemy_count = src->enemy_count;
+    dst->enemy_bullet_count = src->enemy_bullet_count;
+    dst->tick = src->tick;
+}
+
+NetworkBullet *game_state_player_bullets(const GameState *state, int player) {
+    return &state->player_bullets[player * state->capacity.bullets_per_player];
+}
+
+int snapshot_ring_init(SnapshotRing *ring, const RoomCapacity *capacity, Arena *arena) {
+    for (int i = 0; i < SNAPSHOT_RING_SIZE; i++) {
+        if (!game_state_init(&ring->slots[i].state, capacity, 0, arena)) return 0;
+    }
+    snapshot_ring_clear(ring);
+    return 1;
+}
+
+void snapshot_ring_clear(SnapshotRing *ring) {
+    for (int i = 0; i < SNAPSHOT_RING_SIZE; i++) {
+        ring->slots[i].valid = 0;
+    }
+}
+
+GameState *snapshot_ring_claim(SnapshotRing *ring, Uint32 tick) {
+    Snapshot *slot = &ring->slots[tick % SNAPSHOT_RING_SIZE];
+    slot->tick = tick;
+    slot->valid = 0;
+    return &slot->state;
+}
+
+void snapshot_ring_commit(SnapshotRing *ring, Uint32 tick) {
+    Snapshot *slot = &ring->slots[tick % SNAPSHOT_RING_SIZE];
+    if (slot->tick == tick) {
+        slot->valid = 1;
+    }
+}
+
+const GameState *snapshot_ring_find(const SnapshotRing *ring, Uint32 tick) {
+    const Snapshot *slot = &ring->slots[tick % SNAPSHOT_RING_SIZE];
+    if (!slot->valid || slot->tick != tick) {
+        return NULL;
+    }
+    return &slot->state;
+}
+
+void delta_canonicalize(GameState *state) {
+    for (int i = 0; i < state->capacity.players; i++) {
+        if (!state->players[i].active) {
+            memset(&state->players[i], 0, sizeof(NetworkPlayer));
+        }
+    }
+
+    for (int i = 0; i < state->capacity.enemies; i++) {
+        if (!state->enemies[i].active) {
+            memset(&state->enemies[i], 0, sizeof(NetworkEnemy));
+        }
+    }
+}
@@ -0,0 +1,103 @@
+#ifndef NETWORK_DELTA_H
+#define NETWORK_DELTA_H
+
+#include "network_common.h"
+#include "network_arena.h"
+
+#define SNAPSHOT_RING_SIZE 64  // Ticks of history kept for delta baselines (0.5 s at MAX_TICK_RATE)
+
+// One stored game state, keyed by its tick
+typedef struct {
+    Uint32 tick;
+    int valid;
+    GameState state;
+} Snapshot;
+
+// Ring of recent snapshots indexed by tick % SNAPSHOT_RING_SIZE
+typedef struct {
+    Snapshot slots[SNAPSHOT_RING_SIZE];
+} SnapshotRing;
+
+/**
+ * Allocate a state's arrays for a room
+ *
+ * @param state Pointer to GameState; every entity starts inactive
+ * @param capacity Room capacities
+ * @param display Also allocate the bullet and explosion arrays drawn by clients
+ * @param arena Arena the arrays are taken from
+ * @return 1 on success, 0 if allocation failed
+ */
+int game_state_init(GameState *state, const RoomCapacity *capacity, int display, Arena *arena);
+
+/**
+ * Copy one state into another of the same room
+ * Display arrays are copied only when both states have them; otherwise
+ * dst keeps its own
+ *
+ * @param dst State to overwrite
+ * @param src State to copy
+ */
+void game_state_copy(GameState *dst, const GameState *src);
+
+/**
+ * Bullets of one player in a display state
+ *
+ * @param state State with display arrays
+ * @param player Player slot
+ * @return capacity.bullets_per_player entries
+ */
+NetworkBullet *game_state_player_bullets(const GameState *state, int player);
+
+/**
+ * Allocate a state for every ring slot and invalidate them
+ *
+ * @param ring Pointer to SnapshotRing
+ * @param capacity Room capacities
+ * @param arena Arena the states are taken from
+ * @return 1 on success, 0 if allocation failed
+ */
+int snapshot_ring_init(SnapshotRing *ring, const RoomCapacity *capacity, Arena *arena);
+
+/**
+ * Invalidate every snapshot in the ring
+ *
+ * @param ring Pointer to SnapshotRing
+ */
+void snapshot_ring_clear(SnapshotRing *ring);
+
+/**
+ * Claim the ring slot for a tick so a state can be written into it
+ * The slot is marked invalid until snapshot_ring_commit() is called
+ *
+ * @param ring Pointer to SnapshotRing
+ * @param tick Tick the slot will hold
+ * @return Pointer to the slot's GameState
+ */
+GameState *snapshot_ring_claim(SnapshotRing *ring, Uint32 tick);
+
+/**
+ * Mark a previously claimed slot as holding a valid state
+ *
+ * @param ring Pointer to SnapshotRing
+ * @param tick Tick passed to snapshot_ring_claim()
+ */
+void snapshot_ring_commit(SnapshotRing *ring, Uint32 tick);
+
+/**
+ * Look up the snapshot for a tick
+ *
+ * @param ring Pointer to SnapshotRing
+ * @param tick Tick to find
+ * @return Pointer to the stored state, or NULL if it has been overwritten
+ */
+const GameState *snapshot_ring_find(const SnapshotRing *ring, Uint32 tick);
+
+/**
+ * Zero every inactive slot so stale data in dead entities
+ * never shows up as a change between snapshots
+ *
+ * @param state Pointer to GameState to clean up in place
+ */
+void delta_canonicalize(GameState *state);
+
+#endif // NETWORK_DELTA_H
@@ -0,0 +1,144 @@
+#include <string.h>
+#include "network_fragment.h"
+#include "network_codec.h"
+
+// Claim an outbox slot for the next datagram of a message
+// Space for the whole message was checked up front, so this cannot fail
+static NetDatagram *next_datagram(Ring *outbox, const IPaddress *address, Uint32 *position) {
+    NetDatagram *datagram = ring_claim(outbox, position);
+    datagram->address = *address;
+    return datagram;
+}
+
+int fragment_send(Ring *outbox, const IPaddress *address,
+                  int player_id, Uint32 message_id, const Uint8 *data, int size) {
+    Uint32 position;
+
+    if (size <= NET_MTU) {
+        if (!ring_has_space(outbox, 1)) return 0;
+        NetDatagram *datagram = next_datagram(outbox, address, &position);
+        memcpy(datagram->data, data, size);
+        datagram->len = size;
+        ring_publish(outbox, position);
+        return 1;
+    }
+
+    int count = (size + FRAGMENT_SIZE - 1) / FRAGMENT_SIZE;
+    if (count > MAX_FRAGMENTS || !ring_has_space(outbox, count)) return 0;
+
+    FragmentPacket fragment;
+    fragment.header.type = PACKET_FRAGMENT;
+    fragment.header.player_id = player_id;
+    fragment.header.sequence = message_id;
+    fragment.fragment_count = count;
+
+    for (int i = 0; i < count; i++) {
+        int offset = i * FRAGMENT_SIZE;
+        int length = size - offset < FRAGMENT_SIZE ? size - offset : FRAGMENT_SIZE;
+
+        NetDatagram *datagram = next_datagram(outbox, address, &position);
+        fragment.fragment_index = i;
+        int header_size = codec_write_fragment(datagram->data, NET_MTU, &fragment);
+        if (header_size < 0 || header_size + length > NET_MTU) {
+            // The slot is already claimed, so it is published empty and skipped
+            datagram->len = 0;
+            ring_publish(outbox, position);
+            return 0;
+        }
+
+        memcpy(datagram->data + header_size, data + offset, length);
+        datagram->len = header_size + length;
+        ring_publish(outbox, position);
+    }
+    return count;
+}
+
+void reassembly_init(ReassemblyBuffer *buffer) {
+    memset(buffer, 0, sizeof(ReassemblyBuffer));
+}
+
+static ReassemblySlot *find_slot(ReassemblyBuffer *buffer, Uint32 message_id) {
+    ReassemblySlot *free_slot = NULL;
+    ReassemblySlot *oldest = NULL;
+
+    for (int i = 0; i < REASSEMBLY_SLOTS; i++) {
+        ReassemblySlot *slot = &buffer->slots[i];
+        if (!slot->active) {
+            if (!free_slot) free_slot = slot;
+            continue;
+        }
+        if (slot->message_id == message_id) return slot;
+        if (!oldest || SEQUENCE_BEFORE(slot->message_id, oldest->message_id)) oldest = slot;
+    }
+
+    // Evict the oldest partial message when every slot is busy
+    ReassemblySlot *slot = free_slot;
+    if (!slot) {
+        if (SEQUENCE_BEFORE(message_id, oldest->message_id)) return NULL;
+        slot = oldest;
+        buffer->messages_dropped++;
+    }
+
+    slot->active = 1;
+    slot->message_id = message_id;
+    slot->fragment_count = 0;
+    slot->received_count = 0;
+    slot->received_mask = 0;
+    slot->size = 0;
+    return slot;
+}
+
+int reassembly_add(ReassemblyBuffer *buffer, const Uint8 *data, int size, const Uint8 **message) {
+    FragmentPacket fragment;
+    int header_size = codec_read_fragment(data, size, &fragment);
+    if (header_size < 0) return 0;
+
+    int length = size - header_size;
+    if (fragment.fragment_count < 1 || fragment.fragment_count > MAX_FRAGMENTS) return 0;
+    if (fragment.fragment_index < 0 || fragment.fragment_index >= fragment.fragment_count) return 0;
+    if (length <= 0 || length > FRAGMENT_SIZE) return 0;
+
+    // Fragments of messages at or before the newest completed one are stale
+    if (buffer->has_completed && !SEQUENCE_BEFORE(buffer->last_completed, fragment.header.sequence)) return 0;
+
+    buffer->fragments_received++;
+
+    ReassemblySlot *slot = find_slot(buffer, fragment.header.sequence);
+    if (!slot) return 0;
+
+    if (slot->fragment_count == 0) {
+        slot->fragment_count = fragment.fragment_count;
+    } else if (slot->fragment_count != fragment.fragment_count) {
+        return 0;
+    }
+
+    // Every fragment but the last is exactly FRAGMENT_SIZE bytes
+    int is_last = fragment.fragment_index == fragment.fragment_count - 1;
+    if (!is_last && length != FRAGMENT_SIZE) return 0;
+
+    Uint32 bit = 1u << fragment.fragment_index;
+    if (slot->received_mask & bit) return 0;
+
+    memcpy(slot->data + fragment.fragment_index * FRAGMENT_SIZE, data + header_size, length);
+    slot->received_mask |= bit;
+    slot->received_count++;
+    if (is_last) slot->size = fragment.fragment_index * FRAGMENT_SIZE + length;
+
+    if (slot->received_count < slot->fragment_count) return 0;
+
+    // Message complete: anything older still in flight is now useless
+    buffer->last_completed = slot->message_id;
+    buffer->has_completed = 1;
+    buffer->messages_completed++;
+    for (int i = 0; i < REASSEMBLY_SLOTS; i++) {
+        ReassemblySlot *other = &buffer->slots[i];
+        if (other != slot && other->active && SEQUENCE_BEFORE(other->message_id, slot->message_id)) {
+            other->active = 0;
+            buffer->messages_dropped++;
+        }
+    }
+
+    slot->active = 0;
+    *message = slot->data;
+    return slot->size;
+}
@@ -0,0 +1,71 @@
+#ifndef NETWORK_FRAGMENT_H
+#define NETWORK_FRAGMENT_H
+
+#include <SDL2/SDL_net.h>
+#include "network_common.h"
+#include "network_socket.h"
+#include "network_ring.h"
+
+#define FRAGMENT_SIZE 1024                               // Payload bytes per fragment datagram
+#define MAX_FRAGMENTS 32
+#define MAX_MESSAGE_SIZE (FRAGMENT_SIZE * MAX_FRAGMENTS) // Largest payload that can be split
+#define REASSEMBLY_SLOTS 4                               // Messages reassembled concurrently
+
+// One message being put back together from its fragments
+typedef struct {
+    int active;
+    Uint32 message_id;
+    int fragment_count;
+    int received_count;
+    Uint32 received_mask;
+    int size;
+    Uint8 data[MAX_MESSAGE_SIZE];
+} ReassemblySlot;
+
+// Bounded reassembly state for one sender
+typedef struct {
+    ReassemblySlot slots[REASSEMBLY_SLOTS];
+    Uint32 last_completed;  // message_id of the newest completed message
+    int has_completed;
+    Uint32 fragments_received;
+    Uint32 messages_completed;
+    Uint32 messages_dropped;  // Partials discarded as stale or evicted
+} ReassemblyBuffer;
+
+/**
+ * Queue a message for sending, splitting it into MTU-sized fragments if needed
+ * Messages that fit in NET_MTU go out unchanged as a single datagram. Either
+ * every datagram of the message is queued or none is.
+ *
+ * @param outbox Single-producer ring of NetDatagrams, drained by a shard thread
+ * @param address Destination address
+ * @param player_id Player id written into fragment headers
+ * @param message_id Increasing id for the message, sent as the header sequence
+ * @param data Encoded message
+ * @param size Message size in bytes
+ * @return Number of datagrams queued, or 0 if the message does not fit the outbox
+ */
+int fragment_send(Ring *outbox, const IPaddress *address,
+                  int player_id, Uint32 message_id, const Uint8 *data, int size);
+
+/**
+ * Reset a reassembly buffer
+ *
+ * @param buffer Pointer to ReassemblyBuffer
+ */
+void reassembly_init(ReassemblyBuffer *buffer);
+
+/**
+ * Add a received PACKET_FRAGMENT datagram
+ * Completing a message drops every older partial message
+ *
+ * @param buffer Pointer to ReassemblyBuffer
+ * @param data Received datagram
+ * @param size Datagram length in bytes
+ * @param message Set to the reassembled message when one completes;
+ *                valid until the next call
+ * @return Size of the completed message, or 0 if none completed
+ */
+int reassembly_add(ReassemblyBuffer *buffer, const Uint8 *data, int size, const Uint8 **message);
+
+#endif // NETWORK_FRAGMENT_H
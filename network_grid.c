@@ -0,0 +1,149 @@
+#include <string.h>
+#include "network_grid.h"
+
+static int clamp_cell(float v, int count) {
+    int cell = (int)(v / GRID_CELL_SIZE);
+    if (v < 0) cell = 0;
+    if (cell >= count) cell = count - 1;
+    return cell;
+}
+
+static GridSpan span_of(const SpatialGrid *grid, float x, float y, float w, float h) {
+    GridSpan span;
+    span.x0 = (Sint16)clamp_cell(x, grid->cols);
+    span.y0 = (Sint16)clamp_cell(y, grid->rows);
+    span.x1 = (Sint16)clamp_cell(x + w, grid->cols);
+    span.y1 = (Sint16)clamp_cell(y + h, grid->rows);
+    return span;
+}
+
+int grid_init(SpatialGrid *grid, float width, float height, int capacity, Arena *arena) {
+    memset(grid, 0, sizeof(SpatialGrid));
+    grid->cols = (int)(width / GRID_CELL_SIZE) + 1;
+    grid->rows = (int)(height / GRID_CELL_SIZE) + 1;
+    grid->capacity = capacity;
+
+    grid->cells = arena_alloc(arena, sizeof(int) * grid->cols * grid->rows);
+    grid->nodes = arena_alloc(arena, sizeof(GridNode) * capacity * GRID_SPAN * GRID_SPAN);
+    grid->spans = arena_alloc(arena, sizeof(GridSpan) * capacity);
+    grid->stamps = arena_alloc(arena, sizeof(Uint32) * capacity);
+    grid->row_heads = arena_alloc(arena, sizeof(int) * grid->rows);
+    grid->row_nodes = arena_alloc(arena, sizeof(GridNode) * capacity);
+    if (!grid->cells || !grid->nodes || !grid->spans || !grid->stamps || !grid->row_heads || !grid->row_nodes) {
+        return 0;
+    }
+
+    for (int i = 0; i < grid->cols * grid->rows; i++) grid->cells[i] = GRID_NONE;
+    for (int i = 0; i < grid->rows; i++) grid->row_heads[i] = GRID_NONE;
+    for (int i = 0; i < capacity; i++) grid->spans[i].x0 = GRID_NONE;
+    return 1;
+}
+
+// Node of entry id for the cell at (cx, cy) inside its span
+static int node_index(int id, const GridSpan *span, int cx, int cy) {
+    return id * GRID_SPAN * GRID_SPAN + (cy - span->y0) * GRID_SPAN + (cx - span->x0);
+}
+
+static void unlink_span(SpatialGrid *grid, int id) {
+    const GridSpan *span = &grid->spans[id];
+    for (int cy = span->y0; cy <= span->y1; cy++) {
+        for (int cx = span->x0; cx <= span->x1; cx++) {
+            int n = node_index(id, span, cx, cy);
+            GridNode *node = &grid->nodes[n];
+            if (node->prev != GRID_NONE) grid->nodes[node->prev].next = node->next;
+            else grid->cells[cy * grid->cols + cx] = node->next;
+            if (node->next != GRID_NONE) grid->nodes[node->next].prev = node->prev;
+        }
+    }
+
+    GridNode *row = &grid->row_nodes[id];
+    if (row->prev != GRID_NONE) grid->row_nodes[row->prev].next = row->next;
+    else grid->row_heads[span->y0] = row->next;
+    if (row->next != GRID_NONE) grid->row_nodes[row->next].prev = row->prev;
+    grid->spans[id].x0 = GRID_NONE;
+}
+
+static void link_span(SpatialGrid *grid, int id, GridSpan span) {
+    grid->spans[id] = span;
+    for (int cy = span.y0; cy <= span.y1; cy++) {
+        for (int cx = span.x0; cx <= span.x1; cx++) {
+            int n = node_index(id, &span, cx, cy);
+            int *head = &grid->cells[cy * grid->cols + cx];
+            grid->nodes[n].prev = GRID_NONE;
+            grid->nodes[n].next = *head;
+            if (*head != GRID_NONE) grid->nodes[*head].prev = n;
+            *head = n;
+        }
+    }
+
+    // Band queries find entries through the row their span starts on
+    int *head = &grid->row_heads[span.y0];
+    grid->row_nodes[id].prev = GRID_NONE;
+    grid->row_nodes[id].next = *head;
+    if (*head != GRID_NONE) grid->row_nodes[*head].prev = id;
+    *head = id;
+    if (span.y1 - span.y0 > grid->tallest) grid->tallest = span.y1 - span.y0;
+}
+
+void grid_update(SpatialGrid *grid, int id, float x, float y, float w, float h) {
+    GridSpan span = span_of(grid, x, y, w, h);
+    GridSpan *current = &grid->spans[id];
+    if (current->x0 == span.x0 && current->y0 == span.y0 &&
+        current->x1 == span.x1 && current->y1 == span.y1) {
+        return;
+    }
+
+    if (current->x0 != GRID_NONE) unlink_span(grid, id);
+    link_span(grid, id, span);
+    grid->relinks++;
+}
+
+void grid_remove(SpatialGrid *grid, int id) {
+    if (grid->spans[id].x0 != GRID_NONE) unlink_span(grid, id);
+}
+
+int grid_query(SpatialGrid *grid, float x, float y, float w, float h, int *out, int max_out) {
+    GridSpan span = span_of(grid, x, y, w, h);
+    int count = 0;
+
+    // Entries spanning several cells are met once per cell; the stamp
+    // reports each only the first time
+    if (++grid->stamp == 0) {
+        memset(grid->stamps, 0, sizeof(Uint32) * grid->capacity);
+        grid->stamp = 1;
+    }
+
+    for (int cy = span.y0; cy <= span.y1; cy++) {
+        for (int cx = span.x0; cx <= span.x1; cx++) {
+            for (int n = grid->cells[cy * grid->cols + cx]; n != GRID_NONE; n = grid->nodes[n].next) {
+                int id = n / (GRID_SPAN * GRID_SPAN);
+                if (grid->stamps[id] == grid->stamp) continue;
+                grid->stamps[id] = grid->stamp;
+                if (count < max_out) out[count++] = id;
+            }
+        }
+    }
+
+    grid->queries++;
+    grid->candidates += count;
+    return count;
+}
+
+int grid_query_band(SpatialGrid *grid, float x, float y, float w, float h, int *out, int max_out) {
+    GridSpan span = span_of(grid, x, y, w, h);
+    int count = 0;
+
+    // Entries overlapping the box start at most tallest rows above it
+    int first = span.y0 - grid->tallest;
+    for (int cy = first > 0 ? first : 0; cy <= span.y1; cy++) {
+        for (int id = grid->row_heads[cy]; id != GRID_NONE; id = grid->row_nodes[id].next) {
+            const GridSpan *entry = &grid->spans[id];
+            if (entry->y1 < span.y0 || entry->x1 < span.x0 || entry->x0 > span.x1) continue;
+            if (count < max_out) out[count++] = id;
+        }
+    }
+
+    grid->queries++;
+    grid->candidates += count;
+    return count;
+}
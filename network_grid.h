@@ -0,0 +1,113 @@
+#ifndef NETWORK_GRID_H
+#define NETWORK_GRID_H
+
+#include "network_common.h"
+#include "network_arena.h"
+
+#define GRID_CELL_SIZE 64.0f   // Pixels; about a third of an enemy, so queries see few bystanders
+#define GRID_SPAN 5            // Cells an entry can touch along each axis
+#define GRID_NONE -1
+
+// Cell range an entry occupies (x0 = GRID_NONE when it is not in the grid)
+typedef struct {
+    Sint16 x0, y0, x1, y1;
+} GridSpan;
+
+// Link of one entry in one cell's list
+typedef struct {
+    int next;
+    int prev;
+} GridNode;
+
+// Uniform grid broadphase over the arena
+// Each entry is linked into every cell its box touches through a fixed set
+// of intrusive nodes (GRID_SPAN * GRID_SPAN per entry), so moving an entry
+// costs nothing unless it crosses a cell border, and then only relinks the
+// cells involved. Boxes outside the arena are clamped to the border cells,
+// which keeps off-screen entries findable by queries clamped the same way.
+// Entries are also listed once under the row their span starts on, for
+// queries too wide for cell lists to pay off.
+typedef struct {
+    int cols;
+    int rows;
+    int capacity;           // Entry ids are 0 .. capacity - 1
+    int *cells;             // Head node of each cell, GRID_NONE if empty
+    GridNode *nodes;        // capacity * GRID_SPAN * GRID_SPAN
+    GridSpan *spans;        // Per entry
+    Uint32 *stamps;         // Query that last reported each entry
+    Uint32 stamp;
+    int *row_heads;         // First entry whose span starts on each row, GRID_NONE if none
+    GridNode *row_nodes;    // Per entry, its links in that row's list
+    int tallest;            // Most rows any entry has spanned, minus one
+    Uint32 relinks;         // Stats since last reset: entries that changed cells
+    Uint32 queries;
+    Uint32 candidates;      // Entries returned by queries
+} SpatialGrid;
+
+/**
+ * Allocate an empty grid covering an area
+ *
+ * @param grid Pointer to SpatialGrid
+ * @param width Area width in pixels
+ * @param height Area height in pixels
+ * @param capacity Number of entry ids
+ * @param arena Arena the cells and nodes are taken from
+ * @return 1 on success, 0 if allocation failed
+ */
+int grid_init(SpatialGrid *grid, float width, float height, int capacity, Arena *arena);
+
+/**
+ * Insert an entry or move it to a new box
+ * Only relinks the entry when its cell range changes
+ *
+ * @param grid Pointer to SpatialGrid
+ * @param id Entry id
+ * @param x Left edge
+ * @param y Top edge
+ * @param w Width, at most (GRID_SPAN - 1) * GRID_CELL_SIZE
+ * @param h Height, at most (GRID_SPAN - 1) * GRID_CELL_SIZE
+ */
+void grid_update(SpatialGrid *grid, int id, float x, float y, float w, float h);
+
+/**
+ * Take an entry out of the grid (no effect if it is not in it)
+ *
+ * @param grid Pointer to SpatialGrid
+ * @param id Entry id
+ */
+void grid_remove(SpatialGrid *grid, int id);
+
+/**
+ * Find the entries whose cells overlap a box
+ * Every entry overlapping the box is returned, each once, plus possibly
+ * some that are merely near it; callers still run the exact test
+ *
+ * @param grid Pointer to SpatialGrid
+ * @param x Left edge
+ * @param y Top edge
+ * @param w Width
+ * @param h Height
+ * @param out Receives entry ids
+ * @param max_out Size of out
+ * @return Number of ids written
+ */
+int grid_query(SpatialGrid *grid, float x, float y, float w, float h, int *out, int max_out);
+
+/**
+ * Find the entries whose cells overlap a box many cells wide
+ * Same result as grid_query, but walks the row lists, meeting each entry
+ * near the box's rows once instead of once per cell it covers. Cheaper
+ * when the box spans much of the grid's width.
+ *
+ * @param grid Pointer to SpatialGrid
+ * @param x Left edge
+ * @param y Top edge
+ * @param w Width
+ * @param h Height
+ * @param out Receives entry ids
+ * @param max_out Size of out
+ * @return Number of ids written
+ */
+int grid_query_band(SpatialGrid *grid, float x, float y, float w, float h, int *out, int max_out);
+
+#endif // NETWORK_GRID_H
@@ -0,0 +1,111 @@
+#include <string.h>
+#include "network_input.h"
+
+void input_buffer_init(InputBuffer *buffer, int tick_rate) {
+    memset(buffer, 0, sizeof(InputBuffer));
+    buffer->tick_ms = 1000.0f / tick_rate;
+    buffer->target_depth = 1;
+}
+
+int input_buffer_lead(const InputBuffer *buffer, Uint32 now) {
+    if (!buffer->started) return 0;
+
+    // The client produces one input per tick, sent or not
+    Uint32 elapsed = (Uint32)((now - buffer->last_arrival) / buffer->tick_ms);
+    return (Sint32)(buffer->newest_sequence + elapsed - buffer->next_sequence);
+}
+
+void input_buffer_push(InputBuffer *buffer, Uint32 sequence, const PlayerInput *inputs, int count,
+                       double view_tick, Uint32 now) {
+    if (!buffer->started) {
+        buffer->started = 1;
+        buffer->next_sequence = sequence;
+        buffer->newest_sequence = sequence;
+        buffer->last_arrival = now;
+    }
+
+    if (SEQUENCE_BEFORE(sequence, buffer->next_sequence)) {
+        buffer->late++;
+        return;
+    }
+
+    // Too far ahead to fit: the client jumped (e.g. after a stall), so resync on it
+    if (sequence - buffer->next_sequence >= INPUT_BUFFER_SIZE) {
+        memset(buffer->valid, 0, sizeof(buffer->valid));
+        buffer->next_sequence = sequence;
+        buffer->newest_sequence = sequence;
+        buffer->last_arrival = now;
+    }
+
+    for (int i = 0; i < count; i++) {
+        Uint32 input_sequence = sequence - i;
+        if (SEQUENCE_BEFORE(input_sequence, buffer->next_sequence)) break;
+
+        int index = input_sequence % INPUT_BUFFER_SIZE;
+        if (buffer->valid[index] && buffer->sequences[index] == input_sequence) {
+            buffer->duplicates++;
+            continue;
+        }
+        buffer->valid[index] = 1;
+        buffer->sequences[index] = input_sequence;
+        buffer->inputs[index] = inputs[i];
+        buffer->view_ticks[index] = view_tick - i;  // The client's view advances a tick per input
+    }
+
+    // Jitter: how far arrival spacing strays from the spacing of the input ticks
+    if (SEQUENCE_BEFORE(buffer->newest_sequence, sequence)) {
+        float expected = (sequence - buffer->newest_sequence) * buffer->tick_ms;
+        float deviation = (float)(now - buffer->last_arrival) - expected;
+        if (deviation < 0) deviation = -deviation;
+        buffer->jitter = buffer->jitter * 0.9f + deviation * 0.1f;
+
+        buffer->target_depth = 1 + (int)(2.0f * buffer->jitter / buffer->tick_ms);
+        if (buffer->target_depth > INPUT_MAX_DEPTH) buffer->target_depth = INPUT_MAX_DEPTH;
+
+        buffer->newest_sequence = sequence;
+        buffer->last_arrival = now;
+    }
+}
+
+int input_buffer_pop(InputBuffer *buffer, Uint32 now, PlayerInput *input) {
+    *input = buffer->last_input;
+    if (!buffer->started) return 0;
+
+    int lead = input_buffer_lead(buffer, now);
+    if (lead < buffer->target_depth) {
+        // Too close to the client's clock (or it runs slow): let it get ahead
+        buffer->held++;
+        return 0;
+    }
+
+    // Too far behind only adds latency; skip to the target
+    while (lead > buffer->target_depth + INPUT_SLACK) {
+        int index = buffer->next_sequence % INPUT_BUFFER_SIZE;
+        if (buffer->valid[index] && buffer->sequences[index] == buffer->next_sequence) {
+            buffer->last_input = buffer->inputs[index];
+            buffer->applied_view_tick = buffer->view_ticks[index];
+            buffer->valid[index] = 0;
+        } else {
+            buffer->applied_view_tick++;
+        }
+        buffer->next_sequence++;
+        buffer->trimmed++;
+        lead--;
+    }
+
+    int index = buffer->next_sequence % INPUT_BUFFER_SIZE;
+    if (buffer->valid[index] && buffer->sequences[index] == buffer->next_sequence) {
+        buffer->last_input = buffer->inputs[index];
+        buffer->applied_view_tick = buffer->view_ticks[index];
+        buffer->valid[index] = 0;
+        buffer->applied++;
+    } else {
+        // Unchanged since the last one sent, or lost beyond redundancy
+        buffer->repeated++;
+        buffer->applied_view_tick++;
+    }
+    buffer->applied_sequence = buffer->next_sequence++;
+
+    *input = buffer->last_input;
+    return 1;
+}
@@ -0,0 +1,83 @@
+#ifndef NETWORK_INPUT_H
+#define NETWORK_INPUT_H
+
+#include "network_common.h"
+
+#define INPUT_BUFFER_SIZE 32   // Inputs a client can be ahead of the server
+#define INPUT_MAX_DEPTH 6      // Upper bound on the adaptive target depth
+#define INPUT_SLACK 2          // Extra inputs tolerated above the target before trimming
+
+// Per-client queue of inputs keyed by the client's input tick (header.sequence)
+// The server applies exactly one input per simulation tick, running a fixed
+// number of ticks behind its estimate of the client's input clock. Clients
+// only send when their input changes or on a heartbeat, so a missing input
+// usually means "unchanged" and the previous one is repeated.
+typedef struct {
+    PlayerInput inputs[INPUT_BUFFER_SIZE];  // Indexed by sequence % INPUT_BUFFER_SIZE
+    Uint32 sequences[INPUT_BUFFER_SIZE];
+    int valid[INPUT_BUFFER_SIZE];
+    int started;
+    float tick_ms;           // Length of one input tick
+    Uint32 next_sequence;    // Input to apply on the next tick
+    Uint32 applied_sequence; // Input tick applied last, reported back for reconciliation
+    double view_ticks[INPUT_BUFFER_SIZE];  // Server tick the client was rendering at each input
+    double applied_view_tick; // View of the input applied last, for lag compensation
+    Uint32 newest_sequence;  // Highest sequence received
+    PlayerInput last_input;  // Repeated when the next input is missing
+    Uint32 last_arrival;     // When newest_sequence arrived, anchors the client clock estimate
+    float jitter;            // Smoothed arrival jitter in milliseconds
+    int target_depth;        // Ticks to stay behind the client to ride out the jitter
+    Uint32 applied;          // Stats since last reset
+    Uint32 repeated;
+    Uint32 late;             // Packets whose every input was already past
+    Uint32 duplicates;       // Redundant copies of inputs already queued
+    Uint32 trimmed;
+    Uint32 held;
+} InputBuffer;
+
+/**
+ * Reset an input buffer
+ *
+ * @param buffer Pointer to InputBuffer
+ * @param tick_rate Simulation ticks per second, one input each
+ */
+void input_buffer_init(InputBuffer *buffer, int tick_rate);
+
+/**
+ * Queue the inputs of one received packet
+ * Inputs already queued (redundant copies) or already past are ignored
+ *
+ * @param buffer Pointer to InputBuffer
+ * @param sequence Client input tick of inputs[0]
+ * @param inputs Inputs, inputs[i] being for tick sequence - i
+ * @param count Number of inputs
+ * @param view_tick Server tick the client was rendering when it sampled inputs[0]
+ * @param now Arrival time in milliseconds
+ */
+void input_buffer_push(InputBuffer *buffer, Uint32 sequence, const PlayerInput *inputs, int count,
+                       double view_tick, Uint32 now);
+
+/**
+ * Take the input for this simulation tick
+ * Repeats the previous input when the next one is missing. Holds or
+ * trims to stay target_depth ticks behind the client's input clock
+ *
+ * @param buffer Pointer to InputBuffer
+ * @param now Current time in milliseconds
+ * @param input Receives the input to apply
+ * @return 1 if an input tick was consumed (see applied_sequence), 0 when
+ *         holding, in which case the player should not be stepped
+ */
+int input_buffer_pop(InputBuffer *buffer, Uint32 now, PlayerInput *input);
+
+/**
+ * Estimated number of ticks between the client's input clock and the
+ * input applied next
+ *
+ * @param buffer Pointer to InputBuffer
+ * @param now Current time in milliseconds
+ * @return Lead in ticks (negative if the server is ahead of the client)
+ */
+int input_buffer_lead(const InputBuffer *buffer, Uint32 now);
+
+#endif // NETWORK_INPUT_H
@@ -0,0 +1,151 @@
+#include <math.h>
+#include <string.h>
+#include "network_interpolation.h"
+
+// Milliseconds to server ticks
+#define MS_TO_TICKS(interp, ms) ((ms) * (interp)->tick_rate / 1000.0f)
+
+void interpolation_init(Interpolator *interp, int tick_rate) {
+    memset(interp, 0, sizeof(Interpolator));
+    interp->tick_rate = tick_rate;
+}
+
+void interpolation_on_snapshot(Interpolator *interp, Uint32 tick, Uint32 now) {
+    // How many ticks the local clock is ahead of the server tick on arrival
+    double arrival = now * (double)interp->tick_rate / 1000.0 - tick;
+
+    if (!interp->started) {
+        interp->started = 1;
+        interp->clock_offset = arrival;
+        interp->spacing = 0;
+        interp->delay = INTERP_MIN_DELAY + 1;
+        interp->render_tick = (double)tick - interp->delay;
+        interp->newest_tick = tick;
+        interp->last_time = now;
+        return;
+    }
+    if (!SEQUENCE_BEFORE(interp->newest_tick, tick)) return;
+
+    // The first gap seeds the estimate; at high tick rates it is several ticks
+    float gap = (float)(tick - interp->newest_tick);
+    interp->spacing = interp->spacing > 0 ? interp->spacing * 0.9f + gap * 0.1f : gap;
+    interp->newest_tick = tick;
+
+    // The earliest arrival is the least delayed one; drift slowly upward
+    // so a changed path or clock drift is picked up again
+    if (arrival < interp->clock_offset) {
+        interp->clock_offset = arrival;
+    } else {
+        interp->clock_offset += (arrival - interp->clock_offset) * 0.01;
+    }
+    interp->jitter = interp->jitter * 0.9f + (float)(arrival - interp->clock_offset) * 0.1f;
+
+    // One snapshot interval to have the next one in hand, plus margin for lateness
+    interp->delay = interp->spacing + 2.0f * interp->jitter;
+    if (interp->delay < INTERP_MIN_DELAY) interp->delay = INTERP_MIN_DELAY;
+    float max_delay = MS_TO_TICKS(interp, INTERP_MAX_DELAY_MS);
+    if (interp->delay > max_delay) interp->delay = max_delay;
+}
+
+double interpolation_advance(Interpolator *interp, Uint32 now) {
+    if (!interp->started) return 0;
+
+    double step = (now - interp->last_time) * (double)interp->tick_rate / 1000.0;
+    interp->last_time = now;
+
+    double target = now * (double)interp->tick_rate / 1000.0 - interp->clock_offset - interp->delay;
+    double error = target - (interp->render_tick + step);
+    if (fabs(error) > MS_TO_TICKS(interp, INTERP_RESYNC_MS)) {
+        interp->render_tick = target;
+        interp->resyncs++;
+    } else {
+        double slew = error * 0.1;
+        if (slew > INTERP_MAX_SLEW) slew = INTERP_MAX_SLEW;
+        if (slew < -INTERP_MAX_SLEW) slew = -INTERP_MAX_SLEW;
+        interp->render_tick += step * (1.0 + slew);
+    }
+    return interp->render_tick;
+}
+
+static void blend(float *x, float *y, float x0, float y0, float x1, float y1, float t) {
+    float dx = x1 - x0;
+    float dy = y1 - y0;
+    if (dx * dx + dy * dy > INTERP_SNAP_DISTANCE * INTERP_SNAP_DISTANCE) return;  // Respawned or slot reused
+    *x = x0 + dx * t;
+    *y = y0 + dy * t;
+}
+
+int interpolation_sample(Interpolator *interp, const SnapshotRing *ring, const ProjectileTable *projectiles,
+                         double render_tick, GameState *out) {
+    if (!interp->started) return 0;
+    interp->frames++;
+
+    Uint32 newest = interp->newest_tick;
+    const GameState *from = NULL;
+    const GameState *to = NULL;
+    Uint32 from_tick = 0;
+    Uint32 to_tick = 0;
+    double tick = render_tick;
+
+    if (tick >= newest) {
+        // Out of data: continue from the last two snapshots, for a while
+        double ahead = tick - newest;
+        double max_ahead = MS_TO_TICKS(interp, INTERP_MAX_EXTRAPOLATION_MS);
+        if (ahead > max_ahead) {
+            ahead = max_ahead;
+            interp->frozen++;
+        } else if (ahead > 0) {
+            interp->extrapolated++;
+        }
+        tick = newest + ahead;
+
+        to = snapshot_ring_find(ring, newest);
+        to_tick = newest;
+        for (Uint32 back = 1; back < SNAPSHOT_RING_SIZE && back < newest && !from; back++) {
+            from = snapshot_ring_find(ring, newest - back);
+            from_tick = newest - back;
+        }
+    } else {
+        Uint32 base = tick > 0 ? (Uint32)tick : 0;
+        for (Uint32 back = 0; back < SNAPSHOT_RING_SIZE && back <= base && !from; back++) {
+            from = snapshot_ring_find(ring, base - back);
+            from_tick = base - back;
+        }
+        for (Uint32 ahead = 1; !SEQUENCE_BEFORE(newest, base + ahead) && !to; ahead++) {
+            to = snapshot_ring_find(ring, base + ahead);
+            to_tick = base + ahead;
+        }
+    }
+
+    // Only one side available (start of stream, or history overwritten)
+    if (!from && !to) return 0;
+    if (!from || !to) {
+        game_state_copy(out, from ? from : to);
+        projectile_table_fill(projectiles, out, tick, interp->tick_rate);
+        return 1;
+    }
+
+    // Only the offset from from_tick is small enough for a float
+    float t = (float)((tick - from_tick) / (double)(to_tick - from_tick));
+    if (t < 0) t = 0;
+    const GameState *discrete = t >= 1 ? to : from;
+    game_state_copy(out, discrete);
+
+    for (int p = 0; p < out->capacity.players; p++) {
+        const NetworkPlayer *a = &from->players[p];
+        const NetworkPlayer *b = &to->players[p];
+        if (a->active && b->active && a->alive && b->alive) {
+            blend(&out->players[p].x, &out->players[p].y, a->x, a->y, b->x, b->y, t);
+        }
+    }
+    for (int e = 0; e < out->capacity.enemies; e++) {
+        const NetworkEnemy *a = &from->enemies[e];
+        const NetworkEnemy *b = &to->enemies[e];
+        if (a->active && b->active && a->id == b->id) {
+            blend(&out->enemies[e].x, &out->enemies[e].y, a->x, a->y, b->x, b->y, t);
+        }
+    }
+
+    projectile_table_fill(projectiles, out, tick, interp->tick_rate);
+    return 1;
+}
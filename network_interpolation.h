@@ -0,0 +1,82 @@
+#ifndef NETWORK_INTERPOLATION_H
+#define NETWORK_INTERPOLATION_H
+
+#include "network_common.h"
+#include "network_delta.h"
+#include "network_projectile.h"
+
+#define INTERP_MIN_DELAY 1.0f          // Ticks; never render closer to the newest snapshot
+#define INTERP_MAX_DELAY_MS 330.0f     // Well inside the snapshot ring at any tick rate
+#define INTERP_MAX_EXTRAPOLATION_MS 100.0f  // Past the newest snapshot before motion freezes
+#define INTERP_RESYNC_MS 250.0f        // Clock error that jumps instead of slewing
+#define INTERP_MAX_SLEW 0.1f           // Largest playback speed change while catching up
+#define INTERP_SNAP_DISTANCE 200.0f    // Moves longer than this between snapshots are not blended
+
+// Playback clock for rendering remote entities a little in the past
+// The delay adapts to the snapshot spacing (which follows the server's
+// send rate) and the arrival jitter, so there is normally a snapshot on
+// each side of the render time.
+typedef struct {
+    int started;
+    int tick_rate;           // Server ticks per second
+    double clock_offset;     // Local clock minus server tick at the earliest arrival, in ticks
+    float jitter;            // Smoothed lateness over the earliest arrival, in ticks
+    float spacing;           // Smoothed ticks between received snapshots
+    float delay;             // Target distance behind the newest snapshot, in ticks
+    double render_tick;      // Server tick being displayed
+    Uint32 newest_tick;
+    Uint32 last_time;
+    Uint32 frames;           // Stats since last reset
+    Uint32 extrapolated;
+    Uint32 frozen;
+    Uint32 resyncs;
+} Interpolator;
+
+/**
+ * Reset the playback clock
+ *
+ * @param interp Pointer to Interpolator
+ * @param tick_rate Server simulation ticks per second
+ */
+void interpolation_init(Interpolator *interp, int tick_rate);
+
+/**
+ * Feed the arrival of a newer snapshot to the clock and delay estimates
+ *
+ * @param interp Pointer to Interpolator
+ * @param tick Snapshot tick
+ * @param now Arrival time in milliseconds
+ */
+void interpolation_on_snapshot(Interpolator *interp, Uint32 tick, Uint32 now);
+
+/**
+ * Advance the playback clock to the current frame
+ * The clock runs at up to INTERP_MAX_SLEW faster or slower than real time
+ * to settle at the target delay without visible jumps. Render ticks are
+ * doubles because room ticks never reset: past 2^22 a float could only
+ * step by half a tick.
+ *
+ * @param interp Pointer to Interpolator
+ * @param now Current time in milliseconds
+ * @return Server tick to render (fractional)
+ */
+double interpolation_advance(Interpolator *interp, Uint32 now);
+
+/**
+ * Build the state to display at a render tick from the snapshots around it
+ * Positions are blended between the two snapshots surrounding the tick, or
+ * extrapolated from the last two for at most INTERP_MAX_EXTRAPOLATION_MS
+ * when newer data is missing; everything else comes from the snapshot at
+ * or before the tick. Bullets are evaluated from their spawn events.
+ *
+ * @param interp Pointer to Interpolator
+ * @param ring Decoded snapshots
+ * @param projectiles Replicated projectiles
+ * @param render_tick Tick from interpolation_advance()
+ * @param out Receives the display state
+ * @return 1 if a state was produced, 0 if no snapshot is old enough yet
+ */
+int interpolation_sample(Interpolator *interp, const SnapshotRing *ring, const ProjectileTable *projectiles,
+                         double render_tick, GameState *out);
+
+#endif // NETWORK_INTERPOLATION_H
@@ -0,0 +1,48 @@
+#include "network_movement.h"
+
+void movement_apply(NetworkPlayer *player, const PlayerInput *input, float delta_time) {
+    float x_vel = 0, y_vel = 0;
+    if (input->move_up && !input->move_down) y_vel = -PLAYER_SPEED;
+    if (input->move_down && !input->move_up) y_vel = PLAYER_SPEED;
+    if (input->move_left && !input->move_right) x_vel = -PLAYER_SPEED;
+    if (input->move_right && !input->move_left) x_vel = PLAYER_SPEED;
+
+    player->x += x_vel * delta_time;
+    player->y += y_vel * delta_time;
+
+    // Clamp position
+    if (player->x < 0) player->x = 0;
+    if (player->y < 0) player->y = 0;
+    if (player->x > ARENA_WIDTH - PLAYER_WIDTH) player->x = ARENA_WIDTH - PLAYER_WIDTH;
+    if (player->y > ARENA_HEIGHT - PLAYER_HEIGHT) player->y = ARENA_HEIGHT - PLAYER_HEIGHT;
+}
+
+void movement_update_reload(NetworkPlayer *player, Uint32 now) {
+    if (player->reloading && now >= player->reload_start_time + RELOAD_TIME) {
+        player->reloading = 0;
+        player->bullets_fired = 0;
+    }
+}
+
+int movement_can_shoot(const NetworkPlayer *player, const PlayerInput *input, Uint32 now) {
+    return input->shooting && !player->reloading &&
+           player->bullets_fired < MAX_BULLETS_BEFORE_RELOAD &&
+           now >= player->last_shoot_time + PLAYER_SHOOT_INTERVAL;
+}
+
+void movement_on_shot(NetworkPlayer *player, Uint32 now) {
+    player->bullets_fired++;
+    player->last_shoot_time = now;
+
+    if (player->bullets_fired >= MAX_BULLETS_BEFORE_RELOAD) {
+        player->reloading = 1;
+        player->reload_start_time = now;
+    }
+}
+
+void movement_shot_origin(const NetworkPlayer *player, NetworkBullet *bullet) {
+    bullet->x = player->x + PLAYER_WIDTH;
+    bullet->y = player->y + (PLAYER_HEIGHT / 2);
+    bullet->vx = PLAYER_BULLET_SPEED;
+    bullet->vy = 0;
+}
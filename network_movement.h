@@ -0,0 +1,67 @@
+#ifndef NETWORK_MOVEMENT_H
+#define NETWORK_MOVEMENT_H
+
+#include "network_common.h"
+
+// Player movement and shooting rules, shared by the server simulation and
+// client-side prediction so both produce the same result from one input
+
+#define ARENA_WIDTH 1280
+#define ARENA_HEIGHT 720
+#define PLAYER_WIDTH 192
+#define PLAYER_HEIGHT 65
+#define PLAYER_SPEED 300             // Pixels per second
+#define PLAYER_BULLET_SPEED 500      // Pixels per second
+#define PLAYER_SHOOT_INTERVAL 200    // Milliseconds between shots
+#define MAX_BULLETS_BEFORE_RELOAD 20
+#define RELOAD_TIME 2000             // Milliseconds
+
+// Time on the input clock: input tick n happens at n * 1000 / tick_rate ms.
+// Shooting and reload timers use this clock on both sides.
+#define INPUT_TICK_TIME(sequence, rate) TICK_TIME_MS(sequence, rate)
+
+/**
+ * Move a player by one input and keep it inside the arena
+ *
+ * @param player Pointer to NetworkPlayer
+ * @param input Controls for this step
+ * @param delta_time Step length in seconds
+ */
+void movement_apply(NetworkPlayer *player, const PlayerInput *input, float delta_time);
+
+/**
+ * Finish a reload whose time is up
+ *
+ * @param player Pointer to NetworkPlayer
+ * @param now Input clock time in milliseconds
+ */
+void movement_update_reload(NetworkPlayer *player, Uint32 now);
+
+/**
+ * Check whether an input fires a shot: trigger held, not reloading,
+ * ammunition left and the shot interval elapsed
+ *
+ * @param player Pointer to NetworkPlayer
+ * @param input Controls for this step
+ * @param now Input clock time in milliseconds
+ * @return 1 if a shot is fired
+ */
+int movement_can_shoot(const NetworkPlayer *player, const PlayerInput *input, Uint32 now);
+
+/**
+ * Account for a fired shot, starting a reload when the magazine is empty
+ *
+ * @param player Pointer to NetworkPlayer
+ * @param now Input clock time in milliseconds
+ */
+void movement_on_shot(NetworkPlayer *player, Uint32 now);
+
+/**
+ * Spawn position and velocity of a shot fired from the player's position
+ *
+ * @param player Pointer to NetworkPlayer
+ * @param bullet Receives origin and velocity
+ */
+void movement_shot_origin(const NetworkPlayer *player, NetworkBullet *bullet);
+
+#endif // NETWORK_MOVEMENT_H
@@ -0,0 +1,73 @@
+#include <string.h>
+#include "network_pool.h"
+
+// Free slots store their successor as -2 - next, which is -1 for the end
+// of the list and never collides with a dense position (>= 0)
+#define FREE_LINK(next) (-2 - (next))
+
+int pool_init(EntityPool *pool, int capacity, Arena *arena) {
+    memset(pool, 0, sizeof(EntityPool));
+    if (capacity > POOL_MAX_CAPACITY) capacity = POOL_MAX_CAPACITY;
+
+    pool->dense = arena_alloc(arena, sizeof(int) * capacity);
+    pool->sparse = arena_alloc(arena, sizeof(int) * capacity);
+    pool->generations = arena_alloc(arena, sizeof(Uint16) * capacity);
+    if (!pool->dense || !pool->sparse || !pool->generations) return 0;
+    pool->capacity = capacity;
+
+    for (int i = 0; i < capacity; i++) pool->generations[i] = 1;
+    pool_clear(pool);
+    return 1;
+}
+
+static void bump_generation(EntityPool *pool, int slot) {
+    if (++pool->generations[slot] == 0) pool->generations[slot] = 1;
+}
+
+void pool_clear(EntityPool *pool) {
+    for (int i = 0; i < pool->count; i++) bump_generation(pool, pool->dense[i]);
+    pool->count = 0;
+
+    // Ascending free list, so a fresh pool fills from slot 0
+    for (int i = 0; i < pool->capacity; i++) {
+        pool->sparse[i] = FREE_LINK(i + 1 < pool->capacity ? i + 1 : -1);
+    }
+    pool->free_head = pool->capacity > 0 ? 0 : -1;
+}
+
+EntityId pool_alloc(EntityPool *pool) {
+    int slot = pool->free_head;
+    if (slot < 0) return ENTITY_NONE;
+
+    pool->free_head = FREE_LINK(pool->sparse[slot]);
+    pool->dense[pool->count] = slot;
+    pool->sparse[slot] = pool->count++;
+    return ((EntityId)pool->generations[slot] << 16) | (EntityId)slot;
+}
+
+int pool_release(EntityPool *pool, EntityId id) {
+    int slot = pool_slot(pool, id);
+    if (slot < 0) return -1;
+
+    int position = pool->sparse[slot];
+    int last = pool->dense[--pool->count];
+    pool->dense[position] = last;
+    pool->sparse[last] = position;
+
+    pool->sparse[slot] = FREE_LINK(pool->free_head);
+    pool->free_head = slot;
+    bump_generation(pool, slot);
+    return position;
+}
+
+int pool_slot(const EntityPool *pool, EntityId id) {
+    int slot = ENTITY_INDEX(id);
+    if (id == ENTITY_NONE || slot >= pool->capacity) return -1;
+    if (pool->sparse[slot] < 0 || pool->generations[slot] != ENTITY_GENERATION(id)) return -1;
+    return slot;
+}
+
+EntityId pool_id(const EntityPool *pool, int slot) {
+    if (slot < 0 || slot >= pool->capacity || pool->sparse[slot] < 0) return ENTITY_NONE;
+    return ((EntityId)pool->generations[slot] << 16) | (EntityId)slot;
+}
@@ -0,0 +1,87 @@
+#ifndef NETWORK_POOL_H
+#define NETWORK_POOL_H
+
+#include "network_common.h"
+#include "network_arena.h"
+
+#define ENTITY_NONE 0                   // Never a live id: generations start at 1
+#define POOL_MAX_CAPACITY 0xFFFF        // Slot numbers fit the low 16 bits of an id
+#define ENTITY_INDEX(id) ((int)((id) & 0xFFFF))
+#define ENTITY_GENERATION(id) ((Uint16)((id) >> 16))
+
+// Generation-tagged entity id: slot in the low 16 bits, the slot's
+// generation in the high 16. Every release bumps the generation, so an id
+// kept past its entity's death no longer matches the slot's next occupant.
+typedef Uint32 EntityId;
+
+// Slot allocator with an intrusive free list and a dense live list
+// Free slots link to the next free slot through their own sparse entry, so
+// allocation and release are O(1) with no scan. Live slots are packed at
+// the front of dense, so iteration touches only live entities. Release
+// swaps the last live entity into the freed dense position; callers that
+// keep per-entity data in dense order move theirs the same way.
+typedef struct {
+    int capacity;
+    int count;              // Live entities; dense[0 .. count - 1] are their slots
+    int free_head;          // First free slot, -1 when full
+    int *dense;             // Slot of each live entity
+    int *sparse;            // Dense position of a live slot; -2 - next free slot for a free one
+    Uint16 *generations;    // Current generation of each slot
+} EntityPool;
+
+/**
+ * Allocate an empty pool
+ * The first allocations hand out slots in ascending order
+ *
+ * @param pool Pointer to EntityPool
+ * @param capacity Number of slots, at most POOL_MAX_CAPACITY
+ * @param arena Arena the slot arrays are taken from; they live as long as it does
+ * @return 1 on success, 0 if allocation failed
+ */
+int pool_init(EntityPool *pool, int capacity, Arena *arena);
+
+/**
+ * Release every live entity at once
+ * Outstanding ids all become stale
+ *
+ * @param pool Pointer to EntityPool
+ */
+void pool_clear(EntityPool *pool);
+
+/**
+ * Take a free slot
+ *
+ * @param pool Pointer to EntityPool
+ * @return Id of the new entity, or ENTITY_NONE if the pool is full
+ */
+EntityId pool_alloc(EntityPool *pool);
+
+/**
+ * Release an entity
+ * The entity that was last in dense order moves to the returned position
+ *
+ * @param pool Pointer to EntityPool
+ * @param id Entity id
+ * @return Dense position the entity had, or -1 if the id was stale
+ */
+int pool_release(EntityPool *pool, EntityId id);
+
+/**
+ * Slot of a live entity
+ *
+ * @param pool Pointer to EntityPool
+ * @param id Entity id
+ * @return Slot, or -1 if the id is stale
+ */
+int pool_slot(const EntityPool *pool, EntityId id);
+
+/**
+ * Id of the entity in a slot
+ *
+ * @param pool Pointer to EntityPool
+ * @param slot Slot number
+ * @return Id, or ENTITY_NONE if the slot is free
+ */
+EntityId pool_id(const EntityPool *pool, int slot);
+
+#endif // NETWORK_POOL_H
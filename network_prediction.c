@@ -0,0 +1,105 @@
+#include <math.h>
+#include <string.h>
+#include "network_prediction.h"
+#include "network_movement.h"
+
+void prediction_init(Prediction *prediction, int tick_rate) {
+    memset(prediction, 0, sizeof(Prediction));
+    prediction->tick_rate = tick_rate;
+}
+
+// Same steps as the server's process_player_input(), minus the bullet slots
+static int step(NetworkPlayer *player, const PlayerInput *input, Uint32 sequence, int tick_rate) {
+    Uint32 now = INPUT_TICK_TIME(sequence, tick_rate);
+    movement_update_reload(player, now);
+    movement_apply(player, input, 1.0f / tick_rate);
+    if (!movement_can_shoot(player, input, now)) return 0;
+    movement_on_shot(player, now);
+    return 1;
+}
+
+void prediction_apply(Prediction *prediction, Uint32 sequence, const PlayerInput *input) {
+    PredictedInput *entry = &prediction->history[sequence % PREDICTION_HISTORY];
+    entry->sequence = sequence;
+    entry->input = *input;
+    entry->fired = prediction->active ? step(&prediction->player, input, sequence, prediction->tick_rate) : 0;
+    entry->state = prediction->player;
+    prediction->newest_sequence = sequence;
+}
+
+void prediction_reconcile(Prediction *prediction, const NetworkPlayer *server_player, Uint32 input_ack) {
+    prediction->server = *server_player;
+
+    // Nothing to predict while dead; restart from the server once respawned
+    if (!server_player->active || !server_player->alive) {
+        prediction->active = 0;
+        return;
+    }
+    if (input_ack == 0 || SEQUENCE_BEFORE(input_ack, prediction->acked_sequence)) return;
+    prediction->acked_sequence = input_ack;
+
+    // Timers are not replicated, so keep the ones predicted for that tick
+    NetworkPlayer base = *server_player;
+    PredictedInput *entry = &prediction->history[input_ack % PREDICTION_HISTORY];
+    const NetworkPlayer *timers = entry->sequence == input_ack ? &entry->state : &prediction->player;
+    base.last_shoot_time = timers->last_shoot_time;
+    base.reload_start_time = timers->reload_start_time;
+    if (base.reloading && !timers->reloading) base.reload_start_time = INPUT_TICK_TIME(input_ack, prediction->tick_rate);
+
+    if (prediction->active && entry->sequence == input_ack) {
+        float dx = base.x - entry->state.x;
+        float dy = base.y - entry->state.y;
+        prediction->last_error = sqrtf(dx * dx + dy * dy);
+        if (prediction->last_error > PREDICTION_TOLERANCE ||
+            base.bullets_fired != entry->state.bullets_fired ||
+            base.reloading != entry->state.reloading) {
+            prediction->mispredicted++;
+        }
+    }
+    prediction->reconciled++;
+    prediction->active = 1;
+    if (entry->sequence == input_ack) entry->state = base;
+
+    // Replay everything the server has not applied yet
+    if (prediction->newest_sequence - input_ack < PREDICTION_HISTORY) {
+        for (Uint32 sequence = input_ack + 1; !SEQUENCE_BEFORE(prediction->newest_sequence, sequence); sequence++) {
+            PredictedInput *pending = &prediction->history[sequence % PREDICTION_HISTORY];
+            if (pending->sequence != sequence) break;
+            pending->fired = step(&base, &pending->input, sequence, prediction->tick_rate);
+            pending->state = base;
+            prediction->replayed++;
+        }
+    }
+    prediction->player = base;
+}
+
+void prediction_present(const Prediction *prediction, NetworkPlayer *out, NetworkBullet *bullets, int bullet_slots) {
+    *out = prediction->server;
+    if (!prediction->active) return;
+
+    out->x = prediction->player.x;
+    out->y = prediction->player.y;
+    out->bullets_fired = prediction->player.bullets_fired;
+    out->reloading = prediction->player.reloading;
+
+    // Shots the server has not seen yet, flown forward to the present
+    int slot = 0;
+    Uint32 newest = prediction->newest_sequence;
+    if (newest - prediction->acked_sequence >= PREDICTION_HISTORY) return;
+    for (Uint32 sequence = prediction->acked_sequence + 1; !SEQUENCE_BEFORE(newest, sequence); sequence++) {
+        const PredictedInput *pending = &prediction->history[sequence % PREDICTION_HISTORY];
+        if (pending->sequence != sequence || !pending->fired) continue;
+
+        NetworkBullet bullet;
+        movement_shot_origin(&pending->state, &bullet);
+        float age = (float)(newest - sequence) / prediction->tick_rate;
+        bullet.x += bullet.vx * age;
+        bullet.y += bullet.vy * age;
+        if (bullet.x > ARENA_WIDTH) continue;
+
+        while (slot < bullet_slots && bullets[slot].active) slot++;
+        if (slot == bullet_slots) break;
+        bullet.active = 1;
+        bullets[slot] = bullet;
+    }
+}
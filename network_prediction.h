@@ -0,0 +1,73 @@
+#ifndef NETWORK_PREDICTION_H
+#define NETWORK_PREDICTION_H
+
+#include "network_common.h"
+
+#define PREDICTION_HISTORY 128       // Unacknowledged inputs kept for replay (1 s at MAX_TICK_RATE)
+#define PREDICTION_TOLERANCE 0.5f    // Position error in pixels not counted as a misprediction
+
+// One input the client applied locally, with the state it produced
+typedef struct {
+    Uint32 sequence;     // Input tick (0 = unused)
+    PlayerInput input;
+    NetworkPlayer state; // Local player after this input
+    int fired;           // This input fired a shot
+} PredictedInput;
+
+// Client-side prediction of the local player
+// Inputs are applied immediately with the server's movement rules. When a
+// snapshot acknowledges an input tick, the player is reset to the server's
+// result for that tick and the later inputs are replayed on top of it.
+typedef struct {
+    PredictedInput history[PREDICTION_HISTORY];  // Indexed by sequence % PREDICTION_HISTORY
+    int active;               // Predicting (local player alive and seen in a snapshot)
+    int tick_rate;            // Input ticks per second, the server's simulation rate
+    NetworkPlayer player;     // Predicted local player after newest_sequence
+    NetworkPlayer server;     // Last authoritative copy, with bullets from the projectile table
+    Uint32 newest_sequence;   // Newest input applied
+    Uint32 acked_sequence;    // Newest input the server reported applied
+    float last_error;         // Position error found by the last reconciliation
+    Uint32 reconciled;        // Stats since last reset
+    Uint32 mispredicted;
+    Uint32 replayed;
+} Prediction;
+
+/**
+ * Reset prediction state
+ *
+ * @param prediction Pointer to Prediction
+ * @param tick_rate Server simulation ticks per second
+ */
+void prediction_init(Prediction *prediction, int tick_rate);
+
+/**
+ * Apply one input locally, recording it for replay
+ *
+ * @param prediction Pointer to Prediction
+ * @param sequence Input tick
+ * @param input Controls for that tick
+ */
+void prediction_apply(Prediction *prediction, Uint32 sequence, const PlayerInput *input);
+
+/**
+ * Rewind to an authoritative state and replay the inputs after it
+ *
+ * @param prediction Pointer to Prediction
+ * @param server_player Local player as decoded from the snapshot
+ * @param input_ack Input tick that state includes (0 = not known, keep predicting)
+ */
+void prediction_reconcile(Prediction *prediction, const NetworkPlayer *server_player, Uint32 input_ack);
+
+/**
+ * Write the predicted local player for rendering: the authoritative copy
+ * with the predicted position and firing state, plus bullets fired by
+ * inputs the server has not applied yet
+ *
+ * @param prediction Pointer to Prediction
+ * @param out Local player slot of the displayed game state
+ * @param bullets The local player's bullets in the displayed game state
+ * @param bullet_slots Entries in bullets
+ */
+void prediction_present(const Prediction *prediction, NetworkPlayer *out, NetworkBullet *bullets, int bullet_slots);
+
+#endif // NETWORK_PREDICTION_H
@@ -0,0 +1,114 @@
+#include <string.h>
+#include "network_projectile.h"
+
+void projectile_log_init(ProjectileLog *log) {
+    memset(log, 0, sizeof(ProjectileLog));
+}
+
+Uint32 projectile_log_push(ProjectileLog *log, const ProjectileEvent *event) {
+    log->sequence++;
+    ProjectileEvent *slot = &log->events[log->sequence % PROJECTILE_LOG_SIZE];
+    *slot = *event;
+    slot->sequence = log->sequence;
+    return log->sequence;
+}
+
+const ProjectileEvent *projectile_log_get(const ProjectileLog *log, Uint32 sequence) {
+    const ProjectileEvent *event = &log->events[sequence % PROJECTILE_LOG_SIZE];
+    if (sequence == 0 || event->sequence != sequence) {
+        return NULL;
+    }
+    return event;
+}
+
+int projectile_table_init(ProjectileTable *table, const RoomCapacity *capacity, Arena *arena) {
+    memset(table, 0, sizeof(ProjectileTable));
+    table->capacity = *capacity;
+    table->player_bullets = arena_alloc(arena, sizeof(ReplicatedProjectile) *
+                                               capacity->players * capacity->bullets_per_player);
+    table->enemy_bullets = arena_alloc(arena, sizeof(ReplicatedProjectile) * capacity->enemy_bullets);
+    return table->player_bullets && table->enemy_bullets;
+}
+
+void projectile_table_clear(ProjectileTable *table) {
+    const RoomCapacity *capacity = &table->capacity;
+    memset(table->player_bullets, 0, sizeof(ReplicatedProjectile) * capacity->players * capacity->bullets_per_player);
+    memset(table->enemy_bullets, 0, sizeof(ReplicatedProjectile) * capacity->enemy_bullets);
+    table->last_sequence = 0;
+}
+
+void projectile_table_clear_range(ProjectileTable *table, int first, int end) {
+    // Player rows and then the enemy row are exactly the flat numbering
+    int player_slots = table->capacity.players * table->capacity.bullets_per_player;
+    int total = player_slots + table->capacity.enemy_bullets;
+    if (first < 0) first = 0;
+    if (end > total) end = total;
+
+    for (int slot = first; slot < end; slot++) {
+        ReplicatedProjectile *projectile = slot < player_slots ? &table->player_bullets[slot]
+                                                               : &table->enemy_bullets[slot - player_slots];
+        memset(projectile, 0, sizeof(ReplicatedProjectile));
+    }
+}
+
+static ReplicatedProjectile *table_slot(ProjectileTable *table, int owner, int slot) {
+    const RoomCapacity *capacity = &table->capacity;
+    if (owner >= 0 && owner < capacity->players && slot >= 0 && slot < capacity->bullets_per_player) {
+        return &table->player_bullets[owner * capacity->bullets_per_player + slot];
+    }
+    if (owner == PROJECTILE_OWNER_ENEMY && slot >= 0 && slot < capacity->enemy_bullets) {
+        return &table->enemy_bullets[slot];
+    }
+    return NULL;
+}
+
+void projectile_table_apply(ProjectileTable *table, const ProjectileEvent *event) {
+    ReplicatedProjectile *projectile = table_slot(table, event->owner, event->slot);
+    if (!projectile) return;
+
+    if (event->type == PROJECTILE_SPAWN) {
+        projectile->active = 1;
+        projectile->x = event->x;
+        projectile->y = event->y;
+        projectile->vx = event->vx;
+        projectile->vy = event->vy;
+        projectile->spawn_tick = event->tick;
+        projectile->despawn_tick = 0;
+    } else if (projectile->active && projectile->despawn_tick == 0) {
+        projectile->despawn_tick = event->tick ? event->tick : 1;
+    }
+}
+
+static int live_at(const ReplicatedProjectile *projectile, double tick) {
+    if (!projectile->active || tick < projectile->spawn_tick) return 0;
+    return projectile->despawn_tick == 0 || tick < projectile->despawn_tick;
+}
+
+static void fill_bullet(const ReplicatedProjectile *projectile, double tick, int tick_rate,
+                        float *x, float *y, float *vx, float *vy) {
+    float age = (float)((tick - projectile->spawn_tick) / tick_rate);
+    *x = projectile->x + projectile->vx * age;
+    *y = projectile->y + projectile->vy * age;
+    *vx = projectile->vx;
+    *vy = projectile->vy;
+}
+
+void projectile_table_fill(const ProjectileTable *table, GameState *state, double tick, int tick_rate) {
+    // Player rows are laid out alike in both, so one flat pass covers them
+    int player_bullets = table->capacity.players * table->capacity.bullets_per_player;
+    for (int i = 0; i < player_bullets; i++) {
+        const ReplicatedProjectile *projectile = &table->player_bullets[i];
+        NetworkBullet *bullet = &state->player_bullets[i];
+        bullet->active = live_at(projectile, tick);
+        if (!bullet->active) continue;
+        fill_bullet(projectile, tick, tick_rate, &bullet->x, &bullet->y, &bullet->vx, &bullet->vy);
+    }
+
+    for (int i = 0; i < table->capacity.enemy_bullets; i++) {
+        const ReplicatedProjectile *projectile = &table->enemy_bullets[i];
+        NetworkEnemyBullet *bullet = &state->enemy_bullets[i];
+        bullet->active = live_at(projectile, tick);
+        if (!bullet->active) continue;
+        fill_bullet(projectile, tick, tick_rate, &bullet->x, &bullet->y, &bullet->vx, &bullet->vy);
+    }
+}
@@ -0,0 +1,107 @@
+#ifndef NETWORK_PROJECTILE_H
+#define NETWORK_PROJECTILE_H
+
+#include "network_common.h"
+#include "network_arena.h"
+
+#define PROJECTILE_LOG_SIZE 1024  // Events kept for redelivery until acknowledged
+#define PROJECTILE_RESYNC_CHUNK 128  // Live bullets listed per snapshot while a client resynchronises
+#define PROJECTILE_BATCH_MAX (PROJECTILE_LOG_SIZE + PROJECTILE_RESYNC_CHUNK)  // Most events in one snapshot
+
+// Client-side copy of one replicated projectile, simulated from its spawn event
+typedef struct {
+    int active;
+    float x, y;       // Origin at spawn_tick
+    float vx, vy;
+    Uint32 spawn_tick;
+    Uint32 despawn_tick;  // Tick it was removed (0 = still live); kept for delayed rendering
+} ReplicatedProjectile;
+
+// Every projectile slot the client knows about
+typedef struct {
+    RoomCapacity capacity;
+    ReplicatedProjectile *player_bullets;  // capacity.bullets_per_player per player
+    ReplicatedProjectile *enemy_bullets;
+    Uint32 last_sequence;  // Newest event applied
+} ProjectileTable;
+
+// Server-side ring of recent spawn and despawn events
+typedef struct {
+    ProjectileEvent events[PROJECTILE_LOG_SIZE];
+    Uint32 sequence;  // Sequence of the newest event (0 = none yet)
+} ProjectileLog;
+
+/**
+ * Reset the event log
+ *
+ * @param log Pointer to ProjectileLog
+ */
+void projectile_log_init(ProjectileLog *log);
+
+/**
+ * Append an event and assign it the next sequence number
+ *
+ * @param log Pointer to ProjectileLog
+ * @param event Event to record (sequence is filled in)
+ * @return Sequence number assigned to the event
+ */
+Uint32 projectile_log_push(ProjectileLog *log, const ProjectileEvent *event);
+
+/**
+ * Look up an event by sequence number
+ *
+ * @param log Pointer to ProjectileLog
+ * @param sequence Sequence to find
+ * @return Pointer to the event, or NULL if it has been overwritten
+ */
+const ProjectileEvent *projectile_log_get(const ProjectileLog *log, Uint32 sequence);
+
+/**
+ * Allocate an empty table for a room
+ *
+ * @param table Pointer to ProjectileTable
+ * @param capacity Room capacities
+ * @param arena Arena the slots are taken from
+ * @return 1 on success, 0 if allocation failed
+ */
+int projectile_table_init(ProjectileTable *table, const RoomCapacity *capacity, Arena *arena);
+
+/**
+ * Forget every projectile
+ *
+ * @param table Pointer to ProjectileTable
+ */
+void projectile_table_clear(ProjectileTable *table);
+
+/**
+ * Forget the projectiles in a range of flat slots
+ * Slots are numbered as in ProjectileResync
+ *
+ * @param table Pointer to ProjectileTable
+ * @param first First slot dropped
+ * @param end Slot after the last one dropped
+ */
+void projectile_table_clear_range(ProjectileTable *table, int first, int end);
+
+/**
+ * Apply a spawn or despawn event to the table
+ *
+ * @param table Pointer to ProjectileTable
+ * @param event Event received from the server
+ */
+void projectile_table_apply(ProjectileTable *table, const ProjectileEvent *event);
+
+/**
+ * Write the simulated position of every projectile live at a tick into a
+ * game state. Projectiles travel in straight lines, so position is
+ * origin + velocity * age; ticks before the spawn or from the despawn on
+ * leave the slot inactive, which lets the client render in the past
+ *
+ * @param table Pointer to ProjectileTable
+ * @param state Display state whose bullet arrays are overwritten
+ * @param tick Tick to evaluate positions at (may be fractional)
+ * @param tick_rate Server simulation ticks per second
+ */
+void projectile_table_fill(const ProjectileTable *table, GameState *state, double tick, int tick_rate);
+
+#endif // NETWORK_PROJECTILE_H
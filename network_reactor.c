@@ -0,0 +1,145 @@
+#ifdef __linux__
+#define _GNU_SOURCE  // timerfd, eventfd, PR_SET_TIMERSLACK
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
+#include <sys/prctl.h>
+#endif
+#include "network_reactor.h"
+#include "network_clock.h"
+
+#define REACTOR_TIMER_SLACK_NS 1000  // How late the kernel may fire a deadline to batch wake-ups
+
+#ifdef __linux__
+
+static int watch(Reactor *reactor, int fd, int event) {
+    struct epoll_event watched;
+    watched.events = EPOLLIN;
+    watched.data.u32 = (Uint32)event;
+    return epoll_ctl(reactor->epoll_fd, EPOLL_CTL_ADD, fd, &watched) == 0;
+}
+
+int reactor_init(Reactor *reactor, NetSocket *socket) {
+    reactor->socket = socket;
+    reactor->wake_sem = NULL;
+    reactor->deadline_ns = 0;
+    reactor->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    reactor->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    reactor->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (reactor->epoll_fd < 0 || reactor->timer_fd < 0 || reactor->wake_fd < 0 ||
+        !watch(reactor, reactor->timer_fd, REACTOR_TIMER) ||
+        !watch(reactor, reactor->wake_fd, REACTOR_WAKE) ||
+        (socket && !watch(reactor, socket->fd, REACTOR_READABLE))) {
+        reactor_close(reactor);
+        return 0;
+    }
+
+    // The default 50 us slack would show up as tick lateness
+    prctl(PR_SET_TIMERSLACK, REACTOR_TIMER_SLACK_NS);
+    return 1;
+}
+
+void reactor_arm(Reactor *reactor, Uint64 deadline_ns) {
+    if (deadline_ns == reactor->deadline_ns) return;
+    reactor->deadline_ns = deadline_ns;
+
+    // clock_now_ns is CLOCK_MONOTONIC, so deadlines are absolute times of the
+    // timerfd's clock; a zero value disarms it
+    struct itimerspec timer = {{0, 0}, {0, 0}};
+    timer.it_value.tv_sec = (time_t)(deadline_ns / 1000000000ull);
+    timer.it_value.tv_nsec = (long)(deadline_ns % 1000000000ull);
+    timerfd_settime(reactor->timer_fd, TFD_TIMER_ABSTIME, &timer, NULL);
+}
+
+int reactor_wait(Reactor *reactor) {
+    struct epoll_event ready[3];
+    int count = epoll_wait(reactor->epoll_fd, ready, 3, -1);
+    if (count < 0) return 0;
+
+    int events = 0;
+    for (int i = 0; i < count; i++) events |= (int)ready[i].data.u32;
+
+    // Reading resets the timer's expiry count and the wake-up counter
+    Uint64 value;
+    if (events & REACTOR_TIMER) {
+        if (read(reactor->timer_fd, &value, sizeof(value)) < 0) events &= ~REACTOR_TIMER;
+        reactor->deadline_ns = 0;
+    }
+    if (events & REACTOR_WAKE) {
+        if (read(reactor->wake_fd, &value, sizeof(value)) < 0) events &= ~REACTOR_WAKE;
+    }
+    return events;
+}
+
+void reactor_wake(Reactor *reactor) {
+    Uint64 one = 1;
+    if (write(reactor->wake_fd, &one, sizeof(one)) < 0) {
+        // The counter is saturated, so the sleeper is already due to wake
+    }
+}
+
+void reactor_close(Reactor *reactor) {
+    if (reactor->epoll_fd >= 0) close(reactor->epoll_fd);
+    if (reactor->timer_fd >= 0) close(reactor->timer_fd);
+    if (reactor->wake_fd >= 0) close(reactor->wake_fd);
+    reactor->epoll_fd = -1;
+    reactor->timer_fd = -1;
+    reactor->wake_fd = -1;
+}
+
+#else  // SDL semaphores and socket sets, millisecond timeouts
+
+int reactor_init(Reactor *reactor, NetSocket *socket) {
+    reactor->epoll_fd = -1;
+    reactor->timer_fd = -1;
+    reactor->wake_fd = -1;
+    reactor->socket = socket;
+    reactor->deadline_ns = 0;
+    reactor->wake_sem = SDL_CreateSemaphore(0);
+    return reactor->wake_sem != NULL;
+}
+
+void reactor_arm(Reactor *reactor, Uint64 deadline_ns) {
+    reactor->deadline_ns = deadline_ns;
+}
+
+int reactor_wait(Reactor *reactor) {
+    Uint32 timeout = SDL_MUTEX_MAXWAIT;
+    if (reactor->deadline_ns) {
+        Uint64 now = clock_now_ns();
+        timeout = now < reactor->deadline_ns ? (Uint32)((reactor->deadline_ns - now + 999999) / 1000000) : 0;
+    }
+
+    // A socket set cannot also wait on the semaphore, so wake-ups are
+    // noticed within REACTOR_FALLBACK_MS
+    int events = 0;
+    if (reactor->socket) {
+        if (timeout > REACTOR_FALLBACK_MS) timeout = REACTOR_FALLBACK_MS;
+        if (net_socket_wait(reactor->socket, (int)timeout) > 0) events |= REACTOR_READABLE;
+        if (SDL_SemTryWait(reactor->wake_sem) == 0) events |= REACTOR_WAKE;
+    } else if (SDL_SemWaitTimeout(reactor->wake_sem, timeout) == 0) {
+        events |= REACTOR_WAKE;
+    }
+    while ((events & REACTOR_WAKE) && SDL_SemTryWait(reactor->wake_sem) == 0) {
+        // Fold queued wake-ups into this one
+    }
+
+    if (reactor->deadline_ns && clock_now_ns() >= reactor->deadline_ns) {
+        events |= REACTOR_TIMER;
+        reactor->deadline_ns = 0;
+    }
+    return events;
+}
+
+void reactor_wake(Reactor *reactor) {
+    SDL_SemPost(reactor->wake_sem);
+}
+
+void reactor_close(Reactor *reactor) {
+    if (reactor->wake_sem) SDL_DestroySemaphore(reactor->wake_sem);
+    reactor->wake_sem = NULL;
+}
+
+#endif
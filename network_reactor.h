@@ -0,0 +1,74 @@
+#ifndef NETWORK_REACTOR_H
+#define NETWORK_REACTOR_H
+
+#include "network_common.h"
+#include "network_socket.h"
+
+// What ended a reactor_wait, as a bit mask
+#define REACTOR_TIMER 1       // The armed deadline passed
+#define REACTOR_WAKE 2        // Another thread called reactor_wake
+#define REACTOR_READABLE 4    // The watched socket has datagrams
+
+#define REACTOR_FALLBACK_MS 10  // Longest sleep without epoll while a socket is watched
+
+// Everything one thread sleeps on, with a single wait for all of it
+// On Linux an epoll set holds a timerfd for the thread's next deadline, an
+// eventfd other threads write to wake it, and optionally a socket. A
+// thread with no deadline and nothing to read uses no CPU at all.
+// Elsewhere waits fall back to SDL semaphores and socket sets, with
+// millisecond timeouts rounded up, so deadlines are met late rather than
+// early and never by spinning.
+typedef struct {
+    int epoll_fd;           // -1 without epoll
+    int timer_fd;
+    int wake_fd;
+    NetSocket *socket;      // Watched socket, or NULL
+    SDL_sem *wake_sem;      // Fallback wake-up
+    Uint64 deadline_ns;     // Armed deadline on the clock_now_ns clock, 0 for none
+} Reactor;
+
+/**
+ * Set up a reactor
+ * On Linux this also narrows the calling thread's timer slack, which
+ * threads it starts afterwards inherit, so deadlines are met within
+ * microseconds without spinning.
+ *
+ * @param reactor Pointer to Reactor
+ * @param socket Socket to watch for datagrams, or NULL
+ * @return 1 on success, 0 on failure
+ */
+int reactor_init(Reactor *reactor, NetSocket *socket);
+
+/**
+ * Set the deadline the next waits end at
+ *
+ * @param reactor Pointer to Reactor
+ * @param deadline_ns Time on the clock_now_ns clock; 0 waits with no deadline
+ */
+void reactor_arm(Reactor *reactor, Uint64 deadline_ns);
+
+/**
+ * Sleep until the deadline passes, a wake-up arrives or the socket is readable
+ * A passed deadline stays disarmed until reactor_arm is called again.
+ *
+ * @param reactor Pointer to Reactor
+ * @return REACTOR_* bits, 0 if interrupted
+ */
+int reactor_wait(Reactor *reactor);
+
+/**
+ * Wake a thread sleeping in reactor_wait, or make its next wait return at once
+ * Safe to call from any thread
+ *
+ * @param reactor Pointer to Reactor
+ */
+void reactor_wake(Reactor *reactor);
+
+/**
+ * Release a reactor; the watched socket stays open
+ *
+ * @param reactor Pointer to Reactor
+ */
+void reactor_close(Reactor *reactor);
+
+#endif // NETWORK_REACTOR_H
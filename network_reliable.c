@@ -0,0 +1,159 @@
+#include <string.h>
+#include "network_reliable.h"
+
+void reliable_init(ReliableEndpoint *endpoint) {
+    GameEvent *backlogs[RELIABLE_CHANNELS];
+    int capacities[RELIABLE_CHANNELS];
+    for (int c = 0; c < RELIABLE_CHANNELS; c++) {
+        backlogs[c] = endpoint->channels[c].backlog;
+        capacities[c] = endpoint->channels[c].backlog_capacity;
+    }
+
+    memset(endpoint, 0, sizeof(ReliableEndpoint));
+    for (int c = 0; c < RELIABLE_CHANNELS; c++) {
+        endpoint->channels[c].backlog = backlogs[c];
+        endpoint->channels[c].backlog_capacity = capacities[c];
+    }
+}
+
+int reliable_backlog_init(ReliableEndpoint *endpoint, int capacity, Arena *arena) {
+    for (int c = 0; c < RELIABLE_CHANNELS; c++) {
+        ReliableChannel *ch = &endpoint->channels[c];
+        ch->backlog = arena_alloc(arena, sizeof(GameEvent) * capacity);
+        if (!ch->backlog) return 0;
+        ch->backlog_capacity = capacity;
+        ch->backlog_head = 0;
+        ch->backlog_count = 0;
+    }
+    return 1;
+}
+
+// Put a message in the window if its slot is free
+static int enter_window(ReliableChannel *ch, const GameEvent *event) {
+    PendingMessage *message = &ch->pending[ch->next_send_sequence % RELIABLE_WINDOW];
+    if (message->in_use) return 0;
+
+    message->in_use = 1;
+    message->sequence = ch->next_send_sequence++;
+    message->event = *event;
+    message->last_sent = 0;
+    return 1;
+}
+
+// Move backlogged sends into the window as far as acks have freed it
+static void refill_window(ReliableChannel *ch) {
+    while (ch->backlog_count > 0 && enter_window(ch, &ch->backlog[ch->backlog_head])) {
+        ch->backlog_head = (ch->backlog_head + 1) % ch->backlog_capacity;
+        ch->backlog_count--;
+    }
+}
+
+int reliable_send(ReliableEndpoint *endpoint, int channel, const GameEvent *event) {
+    if (channel < 0 || channel >= RELIABLE_CHANNELS) return 0;
+
+    // Earlier sends still waiting go first, so order holds
+    ReliableChannel *ch = &endpoint->channels[channel];
+    if (ch->backlog_count == 0 && enter_window(ch, event)) return 1;
+    if (ch->backlog_count == ch->backlog_capacity) return 0;
+
+    ch->backlog[(ch->backlog_head + ch->backlog_count) % ch->backlog_capacity] = *event;
+    ch->backlog_count++;
+    return 1;
+}
+
+void reliable_collect(ReliableEndpoint *endpoint, Uint32 now, ReliableBlock *block) {
+    block->count = 0;
+    endpoint->ack_pending = 0;
+
+    for (int c = 0; c < RELIABLE_CHANNELS; c++) {
+        ReliableChannel *ch = &endpoint->channels[c];
+
+        // Ack: everything below next_receive_sequence, plus a bitfield of later arrivals
+        block->has_ack[c] = ch->has_received;
+        block->ack[c] = ch->next_receive_sequence;
+        block->ack_bits[c] = 0;
+        for (int i = 0; i < 32 && i + 1 < RELIABLE_WINDOW; i++) {
+            Uint32 sequence = ch->next_receive_sequence + 1 + i;
+            if (ch->received[sequence % RELIABLE_WINDOW]) block->ack_bits[c] |= 1u << i;
+        }
+
+        // Oldest first so retransmissions are not starved by new messages
+        Uint32 first = ch->next_send_sequence - RELIABLE_WINDOW;
+        for (int i = 0; i < RELIABLE_WINDOW && block->count < MAX_RELIABLE_PER_PACKET; i++) {
+            PendingMessage *message = &ch->pending[(first + i) % RELIABLE_WINDOW];
+            if (!message->in_use) continue;
+            if (message->last_sent != 0 && now - message->last_sent < RELIABLE_RESEND_MS) continue;
+
+            if (message->last_sent != 0) {
+                endpoint->messages_resent++;
+            } else {
+                endpoint->messages_sent++;
+            }
+            message->last_sent = now ? now : 1;
+
+            ReliableMessage *out = &block->messages[block->count++];
+            out->channel = c;
+            out->sequence = message->sequence;
+            out->event = message->event;
+        }
+    }
+}
+
+static void acknowledge(ReliableChannel *ch, Uint32 sequence) {
+    PendingMessage *message = &ch->pending[sequence % RELIABLE_WINDOW];
+    if (message->in_use && message->sequence == sequence) {
+        message->in_use = 0;
+    }
+}
+
+void reliable_receive(ReliableEndpoint *endpoint, const ReliableBlock *block) {
+    for (int c = 0; c < RELIABLE_CHANNELS; c++) {
+        if (!block->has_ack[c]) continue;
+        ReliableChannel *ch = &endpoint->channels[c];
+
+        for (int i = 0; i < RELIABLE_WINDOW; i++) {
+            PendingMessage *message = &ch->pending[i];
+            if (message->in_use && SEQUENCE_BEFORE(message->sequence, block->ack[c])) {
+                message->in_use = 0;
+            }
+        }
+        for (int i = 0; i < 32; i++) {
+            if (block->ack_bits[c] & (1u << i)) acknowledge(ch, block->ack[c] + 1 + i);
+        }
+        refill_window(ch);
+    }
+
+    for (int i = 0; i < block->count; i++) {
+        const ReliableMessage *message = &block->messages[i];
+        if (message->channel < 0 || message->channel >= RELIABLE_CHANNELS) continue;
+        ReliableChannel *ch = &endpoint->channels[message->channel];
+
+        // Duplicates of delivered messages only need the ack refreshed
+        ch->has_received = 1;
+        endpoint->ack_pending = 1;
+        if (SEQUENCE_BEFORE(message->sequence, ch->next_receive_sequence)) continue;
+        if (message->sequence - ch->next_receive_sequence >= RELIABLE_WINDOW) continue;
+
+        int index = message->sequence % RELIABLE_WINDOW;
+        if (ch->received[index]) continue;
+        ch->received[index] = 1;
+        ch->received_events[index] = message->event;
+    }
+}
+
+int reliable_poll(ReliableEndpoint *endpoint, GameEvent *event) {
+    for (int i = 0; i < RELIABLE_CHANNELS; i++) {
+        int c = (endpoint->poll_channel + i) % RELIABLE_CHANNELS;
+        ReliableChannel *ch = &endpoint->channels[c];
+        int index = ch->next_receive_sequence % RELIABLE_WINDOW;
+        if (!ch->received[index]) continue;
+
+        *event = ch->received_events[index];
+        ch->received[index] = 0;
+        ch->next_receive_sequence++;
+        endpoint->messages_received++;
+        endpoint->poll_channel = (c + 1) % RELIABLE_CHANNELS;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,101 @@
+#ifndef NETWORK_RELIABLE_H
+#define NETWORK_RELIABLE_H
+
+#include "network_common.h"
+#include "network_arena.h"
+
+#define RELIABLE_WINDOW 64       // Messages in flight per channel
+#define RELIABLE_RESEND_MS 100   // Retransmit an unacknowledged message after this long
+
+// Outgoing message waiting for acknowledgement
+typedef struct {
+    int in_use;
+    Uint32 sequence;
+    GameEvent event;
+    Uint32 last_sent;  // 0 = never sent
+} PendingMessage;
+
+// One ordered stream in each direction
+typedef struct {
+    Uint32 next_send_sequence;
+    PendingMessage pending[RELIABLE_WINDOW];  // Indexed by sequence % RELIABLE_WINDOW
+    Uint32 next_receive_sequence;             // Everything below this was delivered
+    int received[RELIABLE_WINDOW];            // Out-of-order arrivals awaiting delivery
+    GameEvent received_events[RELIABLE_WINDOW];
+    int has_received;                         // Anything arrived yet (acks are sent after that)
+    GameEvent *backlog;                       // Sends waiting for room in the window, a ring
+    int backlog_capacity;
+    int backlog_head;                         // Oldest waiting send
+    int backlog_count;
+} ReliableChannel;
+
+// Reliable, ordered message state for one peer
+typedef struct {
+    ReliableChannel channels[RELIABLE_CHANNELS];
+    int poll_channel;  // Round-robin start for reliable_poll()
+    int ack_pending;   // Messages arrived since the last reliable_collect()
+    Uint32 messages_sent;
+    Uint32 messages_resent;
+    Uint32 messages_received;
+} ReliableEndpoint;
+
+/**
+ * Reset an endpoint
+ * Backlog storage given by reliable_backlog_init is kept, emptied
+ *
+ * @param endpoint Pointer to ReliableEndpoint
+ */
+void reliable_init(ReliableEndpoint *endpoint);
+
+/**
+ * Let each channel queue sends behind a full window
+ * Queued sends enter the window in order as acks free it. Without a
+ * backlog, sends fail as soon as the window is full.
+ *
+ * @param endpoint Pointer to ReliableEndpoint
+ * @param capacity Sends each channel can queue
+ * @param arena Arena the queues are taken from
+ * @return 1 on success, 0 if allocation failed
+ */
+int reliable_backlog_init(ReliableEndpoint *endpoint, int capacity, Arena *arena);
+
+/**
+ * Queue a message for reliable, ordered delivery
+ *
+ * @param endpoint Pointer to ReliableEndpoint
+ * @param channel Channel index (RELIABLE_CHANNEL_*)
+ * @param event Message to deliver
+ * @return 1 if queued, 0 if the channel's window and backlog are both full
+ */
+int reliable_send(ReliableEndpoint *endpoint, int channel, const GameEvent *event);
+
+/**
+ * Fill the reliable block carried by the next outgoing packet
+ * Includes acknowledgements for received messages and every message that
+ * is new or due for retransmission, up to MAX_RELIABLE_PER_PACKET
+ *
+ * @param endpoint Pointer to ReliableEndpoint
+ * @param now Current time in milliseconds
+ * @param block Receives acks and messages
+ */
+void reliable_collect(ReliableEndpoint *endpoint, Uint32 now, ReliableBlock *block);
+
+/**
+ * Process the reliable block of a received packet
+ * Frees acknowledged messages and buffers new ones for reliable_poll()
+ *
+ * @param endpoint Pointer to ReliableEndpoint
+ * @param block Block decoded from the packet
+ */
+void reliable_receive(ReliableEndpoint *endpoint, const ReliableBlock *block);
+
+/**
+ * Take the next message that is ready for in-order delivery
+ *
+ * @param endpoint Pointer to ReliableEndpoint
+ * @param event Receives the message
+ * @return 1 if a message was returned, 0 if none is ready
+ */
+int reliable_poll(ReliableEndpoint *endpoint, GameEvent *event);
+
+#endif // NETWORK_RELIABLE_H
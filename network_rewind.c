@@ -0,0 +1,70 @@
+#include <string.h>
+#include "network_rewind.h"
+
+#define ACTIVE_WORDS(enemies) (((enemies) + 31) / 32)
+#define ACTIVE_BIT(enemy) (1u << ((enemy) & 31))
+
+int rewind_init(RewindHistory *history, int enemies, Arena *arena) {
+    memset(history, 0, sizeof(RewindHistory));
+    history->enemies = enemies;
+    history->spawn_tick = arena_alloc(arena, sizeof(Uint32) * enemies);
+    if (!history->spawn_tick) return 0;
+
+    for (int i = 0; i < REWIND_HISTORY; i++) {
+        RewindFrame *frame = &history->frames[i];
+        frame->active = arena_alloc(arena, sizeof(Uint32) * ACTIVE_WORDS(enemies));
+        frame->x = arena_alloc(arena, sizeof(Sint16) * enemies);
+        frame->y = arena_alloc(arena, sizeof(Sint16) * enemies);
+        if (!frame->active || !frame->x || !frame->y) return 0;
+    }
+    return 1;
+}
+
+void rewind_on_spawn(RewindHistory *history, int enemy, Uint32 tick) {
+    if (enemy >= 0 && enemy < history->enemies) history->spawn_tick[enemy] = tick;
+}
+
+static Sint16 to_fixed(float value) {
+    float scaled = value * REWIND_POS_SCALE;
+    if (scaled > 32767.0f) scaled = 32767.0f;
+    if (scaled < -32768.0f) scaled = -32768.0f;
+    return (Sint16)scaled;
+}
+
+void rewind_record(RewindHistory *history, const GameState *state) {
+    RewindFrame *frame = &history->frames[state->tick % REWIND_HISTORY];
+    frame->tick = state->tick;
+    memset(frame->active, 0, sizeof(Uint32) * ACTIVE_WORDS(history->enemies));
+    for (int e = 0; e < history->enemies; e++) {
+        if (!state->enemies[e].active) continue;
+        frame->active[e / 32] |= ACTIVE_BIT(e);
+        frame->x[e] = to_fixed(state->enemies[e].x);
+        frame->y[e] = to_fixed(state->enemies[e].y);
+    }
+}
+
+static const RewindFrame *find_frame(const RewindHistory *history, int enemy, Uint32 tick) {
+    const RewindFrame *frame = &history->frames[tick % REWIND_HISTORY];
+    if (tick == 0 || frame->tick != tick) return NULL;
+    if (tick < history->spawn_tick[enemy] || !(frame->active[enemy / 32] & ACTIVE_BIT(enemy))) return NULL;
+    return frame;
+}
+
+int rewind_enemy_at(const RewindHistory *history, int enemy, double tick, float *x, float *y) {
+    if (enemy < 0 || enemy >= history->enemies || tick < 1) return 0;
+
+    Uint32 base = (Uint32)tick;
+    float t = (float)(tick - base);
+    const RewindFrame *from = find_frame(history, enemy, base);
+    if (!from) return 0;
+
+    *x = from->x[enemy] / REWIND_POS_SCALE;
+    *y = from->y[enemy] / REWIND_POS_SCALE;
+
+    const RewindFrame *to = t > 0 ? find_frame(history, enemy, base + 1) : NULL;
+    if (to) {
+        *x += (to->x[enemy] / REWIND_POS_SCALE - *x) * t;
+        *y += (to->y[enemy] / REWIND_POS_SCALE - *y) * t;
+    }
+    return 1;
+}
@@ -0,0 +1,70 @@
+#ifndef NETWORK_REWIND_H
+#define NETWORK_REWIND_H
+
+#include "network_common.h"
+#include "network_arena.h"
+
+#define REWIND_HISTORY 32          // Ticks of enemy positions kept (250 ms at MAX_TICK_RATE)
+#define DEFAULT_MAX_REWIND_MS 200  // Largest rewind a client's view can earn
+#define REWIND_POS_SCALE 8.0f      // Stored like the wire format: 1/8 pixel
+
+// Enemy positions as the snapshot for one tick carried them
+// Positions are 16-bit fixed point and presence a bitset, so a frame is
+// about four bytes per enemy slot and recording one costs a short loop per tick
+typedef struct {
+    Uint32 tick;                  // 0 = unused
+    Uint32 *active;               // Bit e % 32 of word e / 32: enemy e was active
+    Sint16 *x;
+    Sint16 *y;
+} RewindFrame;
+
+// Server-side ring of recent world states for lag-compensated hit tests
+typedef struct {
+    int enemies;                         // Enemy slots per frame
+    RewindFrame frames[REWIND_HISTORY];  // Indexed by tick % REWIND_HISTORY
+    Uint32 *spawn_tick;                  // First tick each slot's current occupant was visible
+} RewindHistory;
+
+/**
+ * Allocate an empty history
+ *
+ * @param history Pointer to RewindHistory
+ * @param enemies Enemy slots in the room
+ * @param arena Arena the frames are taken from
+ * @return 1 on success, 0 if allocation failed
+ */
+int rewind_init(RewindHistory *history, int enemies, Arena *arena);
+
+/**
+ * Note that an enemy slot holds a new enemy from this tick on, so older
+ * frames of the slot are not mistaken for it
+ *
+ * @param history Pointer to RewindHistory
+ * @param enemy Enemy slot
+ * @param tick Tick of the first snapshot that shows it
+ */
+void rewind_on_spawn(RewindHistory *history, int enemy, Uint32 tick);
+
+/**
+ * Record the world as sent in the snapshot for state->tick
+ *
+ * @param history Pointer to RewindHistory
+ * @param state State after the tick's simulation
+ */
+void rewind_record(RewindHistory *history, const GameState *state);
+
+/**
+ * Where an enemy was at a (fractional) past tick, blending the two frames
+ * around it. The tick is a double so its fraction survives at any room tick
+ *
+ * @param history Pointer to RewindHistory
+ * @param enemy Enemy slot
+ * @param tick Tick to look at
+ * @param x Receives the x position
+ * @param y Receives the y position
+ * @return 1 if the enemy was visible then, 0 if it was not (or the tick
+ *         has left the history)
+ */
+int rewind_enemy_at(const RewindHistory *history, int enemy, double tick, float *x, float *y);
+
+#endif // NETWORK_REWIND_H
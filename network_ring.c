@@ -0,0 +1,79 @@
+#include "network_ring.h"
+
+int ring_init(Ring *ring, int capacity, size_t entry_size, int producers, Arena *arena) {
+    Uint32 size = 2;
+    while (size < (Uint32)capacity) size *= 2;
+
+    ring->entries = arena_alloc(arena, entry_size * size);
+    ring->sequence = arena_alloc(arena, sizeof(atomic_uint) * size);
+    if (!ring->entries || !ring->sequence) return 0;
+    for (Uint32 i = 0; i < size; i++) atomic_init(&ring->sequence[i], i);
+    ring->mask = size - 1;
+    ring->entry_size = (Uint32)entry_size;
+    ring->producers = producers;
+    atomic_init(&ring->head, 0);
+    ring->tail = 0;
+    return 1;
+}
+
+void *ring_claim(Ring *ring, Uint32 *position) {
+    Uint32 head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    for (;;) {
+        Uint32 turn = atomic_load_explicit(&ring->sequence[head & ring->mask], memory_order_acquire);
+        Sint32 lag = (Sint32)(turn - head);
+        if (lag < 0) return NULL;  // The consumer has not freed this slot yet
+
+        if (lag > 0) {
+            // Another producer took this position first
+            head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+        } else if (ring->producers == RING_SINGLE_PRODUCER) {
+            atomic_store_explicit(&ring->head, head + 1, memory_order_relaxed);
+            break;
+        } else if (atomic_compare_exchange_weak_explicit(&ring->head, &head, head + 1,
+                                                         memory_order_relaxed, memory_order_relaxed)) {
+            break;
+        }
+    }
+    *position = head;
+    return ring->entries + (size_t)(head & ring->mask) * ring->entry_size;
+}
+
+void ring_publish(Ring *ring, Uint32 position) {
+    atomic_store_explicit(&ring->sequence[position & ring->mask], position + 1, memory_order_release);
+}
+
+int ring_has_space(Ring *ring, int count) {
+    if (count < 1) return 1;
+    if ((Uint32)count > ring->mask + 1) return 0;
+
+    // The consumer frees slots in order, so the last one being free means all are
+    Uint32 last = atomic_load_explicit(&ring->head, memory_order_relaxed) + (Uint32)count - 1;
+    return atomic_load_explicit(&ring->sequence[last & ring->mask], memory_order_acquire) == last;
+}
+
+void *ring_peek(Ring *ring) {
+    Uint32 turn = atomic_load_explicit(&ring->sequence[ring->tail & ring->mask], memory_order_acquire);
+    if (turn != ring->tail + 1) return NULL;
+    return ring->entries + (size_t)(ring->tail & ring->mask) * ring->entry_size;
+}
+
+void ring_release(Ring *ring) {
+    atomic_store_explicit(&ring->sequence[ring->tail & ring->mask], ring->tail + ring->mask + 1,
+                          memory_order_release);
+    ring->tail++;
+}
+
+int ring_peek_batch(Ring *ring, void **entries, int max) {
+    int count = 0;
+    for (; count < max && (Uint32)count <= ring->mask; count++) {
+        Uint32 position = ring->tail + (Uint32)count;
+        Uint32 turn = atomic_load_explicit(&ring->sequence[position & ring->mask], memory_order_acquire);
+        if (turn != position + 1) break;
+        entries[count] = ring->entries + (size_t)(position & ring->mask) * ring->entry_size;
+    }
+    return count;
+}
+
+void ring_release_batch(Ring *ring, int count) {
+    for (int i = 0; i < count; i++) ring_release(ring);
+}
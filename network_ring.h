@@ -0,0 +1,111 @@
+#ifndef NETWORK_RING_H
+#define NETWORK_RING_H
+
+#include <stdatomic.h>
+#include "network_common.h"
+#include "network_arena.h"
+
+#define RING_CACHE_LINE 64
+
+// Who may push into a ring
+#define RING_SINGLE_PRODUCER 0   // One thread pushes; claims are a plain increment
+#define RING_MULTI_PRODUCER 1    // Any thread pushes; claims are a compare-and-swap
+
+// Bounded queue of fixed-size entries between threads, without locks
+// Every slot carries a sequence number saying whose turn it is: a slot at
+// position p is free for the producer claiming p while its sequence is p,
+// ready for the consumer once the producer sets it to p + 1, and free
+// again for position p + size once the consumer sets it to that. Only one
+// thread ever consumes. Producer and consumer positions sit on their own
+// cache lines so the two sides do not bounce one line between cores.
+typedef struct {
+    Uint8 *entries;             // size slots of entry_size bytes
+    atomic_uint *sequence;      // Turn of each slot
+    Uint32 mask;                // Slot count minus one; the count is a power of two
+    Uint32 entry_size;
+    int producers;              // RING_SINGLE_PRODUCER or RING_MULTI_PRODUCER
+    Uint8 pad_head[RING_CACHE_LINE];
+    atomic_uint head;           // Next position to claim
+    Uint8 pad_tail[RING_CACHE_LINE - sizeof(atomic_uint)];
+    Uint32 tail;                // Next position to consume, touched by the consumer only
+    Uint8 pad_end[RING_CACHE_LINE - sizeof(Uint32)];
+} Ring;
+
+/**
+ * Allocate an empty ring
+ *
+ * @param ring Pointer to Ring
+ * @param capacity Entries wanted; rounded up to a power of two
+ * @param entry_size Bytes per entry
+ * @param producers RING_SINGLE_PRODUCER or RING_MULTI_PRODUCER
+ * @param arena Arena the slots are taken from
+ * @return 1 on success, 0 if allocation failed
+ */
+int ring_init(Ring *ring, int capacity, size_t entry_size, int producers, Arena *arena);
+
+/**
+ * Claim the next free slot for writing
+ * The entry is invisible to the consumer until it is published
+ *
+ * @param ring Pointer to Ring
+ * @param position Set to the position to publish
+ * @return Entry to fill, or NULL if the ring is full
+ */
+void *ring_claim(Ring *ring, Uint32 *position);
+
+/**
+ * Hand a filled entry to the consumer
+ *
+ * @param ring Pointer to Ring
+ * @param position Position returned by ring_claim
+ */
+void ring_publish(Ring *ring, Uint32 position);
+
+/**
+ * Check that the next count claims will succeed
+ * Only meaningful for RING_SINGLE_PRODUCER rings, where nobody else claims
+ *
+ * @param ring Pointer to Ring
+ * @param count Entries about to be pushed
+ * @return 1 if they fit
+ */
+int ring_has_space(Ring *ring, int count);
+
+/**
+ * Look at the oldest published entry
+ * Consumer only
+ *
+ * @param ring Pointer to Ring
+ * @return Entry, or NULL if none is ready
+ */
+void *ring_peek(Ring *ring);
+
+/**
+ * Free the entry returned by ring_peek for reuse
+ * Consumer only
+ *
+ * @param ring Pointer to Ring
+ */
+void ring_release(Ring *ring);
+
+/**
+ * Look at the oldest published entries, in order
+ * They stay in the ring until released. Consumer only.
+ *
+ * @param ring Pointer to Ring
+ * @param entries Receives up to max entry pointers
+ * @param max Most entries wanted
+ * @return Number of entries returned
+ */
+int ring_peek_batch(Ring *ring, void **entries, int max);
+
+/**
+ * Free the oldest count entries, as returned by ring_peek_batch
+ * Consumer only
+ *
+ * @param ring Pointer to Ring
+ * @param count Entries to free
+ */
+void ring_release_batch(Ring *ring, int count);
+
+#endif // NETWORK_RING_H
@@ -0,0 +1,67 @@
+#include "network_route.h"
+
+static int same_address(const IPaddress *a, const IPaddress *b) {
+    return a->host == b->host && a->port == b->port;
+}
+
+// Home entry of an address: host and port mixed by a multiplicative hash
+static int home_entry(const RouteTable *table, const IPaddress *address) {
+    Uint32 key = address->host ^ ((Uint32)address->port << 16 | address->port);
+    return (int)((key * 2654435761u) >> 8) & table->mask;
+}
+
+// Entry holding an address, or the empty entry ending its probe run
+static int probe(const RouteTable *table, const IPaddress *address) {
+    int i = home_entry(table, address);
+    while (table->entries[i].room != ROUTE_NONE && !same_address(&table->entries[i].address, address)) {
+        i = (i + 1) & table->mask;
+    }
+    return i;
+}
+
+int route_table_init(RouteTable *table, int capacity, Arena *arena) {
+    // At most half full, so probe runs stay short
+    int size = 2;
+    while (size < capacity * 2) size *= 2;
+
+    table->entries = arena_alloc(arena, sizeof(Route) * size);
+    if (!table->entries) return 0;
+    for (int i = 0; i < size; i++) table->entries[i].room = ROUTE_NONE;
+    table->mask = size - 1;
+    table->count = 0;
+    return 1;
+}
+
+int route_find(const RouteTable *table, const IPaddress *address) {
+    return table->entries[probe(table, address)].room;
+}
+
+int route_add(RouteTable *table, const IPaddress *address, int room) {
+    int i = probe(table, address);
+    if (table->entries[i].room == ROUTE_NONE) {
+        // Keep one entry empty so every probe run ends
+        if (table->count == table->mask) return 0;
+        table->entries[i].address = *address;
+        table->count++;
+    }
+    table->entries[i].room = room;
+    return 1;
+}
+
+int route_remove(RouteTable *table, const IPaddress *address) {
+    int i = probe(table, address);
+    if (table->entries[i].room == ROUTE_NONE) return 0;
+
+    // Pull back later entries of the run whose home lies at or before the hole
+    int hole = i;
+    for (int j = (i + 1) & table->mask; table->entries[j].room != ROUTE_NONE; j = (j + 1) & table->mask) {
+        int home = home_entry(table, &table->entries[j].address);
+        if (((j - home) & table->mask) >= ((j - hole) & table->mask)) {
+            table->entries[hole] = table->entries[j];
+            hole = j;
+        }
+    }
+    table->entries[hole].room = ROUTE_NONE;
+    table->count--;
+    return 1;
+}
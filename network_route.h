@@ -0,0 +1,63 @@
+#ifndef NETWORK_ROUTE_H
+#define NETWORK_ROUTE_H
+
+#include "network_common.h"
+#include "network_arena.h"
+
+#define ROUTE_NONE -1
+
+// One client address and the room it plays in
+typedef struct {
+    IPaddress address;
+    int room;               // ROUTE_NONE if the entry is empty
+} Route;
+
+// Client address to room map, open-addressed with linear probing
+// Lookups run once per received datagram, so entries sit in one flat array
+// and a lookup is a hash plus a short probe. Removal shifts later entries
+// of the probe run back, so there are no tombstones to slow lookups down.
+typedef struct {
+    Route *entries;
+    int mask;               // Entry count minus one; the count is a power of two
+    int count;              // Addresses held
+} RouteTable;
+
+/**
+ * Allocate an empty table
+ *
+ * @param table Pointer to RouteTable
+ * @param capacity Most addresses held at once
+ * @param arena Arena the entries are taken from
+ * @return 1 on success, 0 if allocation failed
+ */
+int route_table_init(RouteTable *table, int capacity, Arena *arena);
+
+/**
+ * Look up the room of an address
+ *
+ * @param table Pointer to RouteTable
+ * @param address Client address
+ * @return Room index, or ROUTE_NONE if the address has no route
+ */
+int route_find(const RouteTable *table, const IPaddress *address);
+
+/**
+ * Route an address to a room, replacing any existing route
+ *
+ * @param table Pointer to RouteTable
+ * @param address Client address
+ * @param room Room index
+ * @return 1 on success, 0 if the table is full
+ */
+int route_add(RouteTable *table, const IPaddress *address, int room);
+
+/**
+ * Remove the route of an address
+ *
+ * @param table Pointer to RouteTable
+ * @param address Client address
+ * @return 1 if a route was removed
+ */
+int route_remove(RouteTable *table, const IPaddress *address);
+
+#endif // NETWORK_ROUTE_H
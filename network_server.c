@@ -1,139 +1,644 @@
+#define _GNU_SOURCE  // rand_r, pthread_setaffinity_np
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdarg.h>
 #include <string.h>
 #include <time.h>
 #include <math.h>
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_net.h>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
 #include "network_common.h"
+#include "network_delta.h"
+#include "network_codec.h"
+#include "network_fragment.h"
+#include "network_projectile.h"
+#include "network_reliable.h"
+#include "network_congestion.h"
+#include "network_compress.h"
+#include "network_input.h"
+#include "network_movement.h"
+#include "network_rewind.h"
+#include "network_clock.h"
+#include "network_grid.h"
+#include "network_bullets.h"
+#include "network_pool.h"
+#include "network_timer.h"
+#include "network_arena.h"
+#include "network_route.h"
+#include "network_socket.h"
+#include "network_ring.h"
+#include "network_reactor.h"
 
-#define SPEED 300
-#define BULLET_SPEED 500
 #define ENEMY_SPEED 300
 #define ENEMY_BULLET_SPEED 400
 #define ENEMY_SPAWN_INTERVAL 2000
 #define ENEMY_SHOOT_INTERVAL 1500
-#define PLAYER_SHOOT_INTERVAL 200
-#define MAX_BULLETS_BEFORE_RELOAD 20
-#define RELOAD_TIME 2000
 #define WINDOW_WIDTH 1280
 #define WINDOW_HEIGHT 720
 #define RESPAWN_TIME 3000
-#define PLAYER_WIDTH 192
-#define PLAYER_HEIGHT 65
 #define ENEMY_WIDTH 192
 #define ENEMY_HEIGHT 65
 #define BULLET_WIDTH 40
 #define BULLET_HEIGHT 15
+#define DEFAULT_SNAPSHOT_BUDGET 1000  // Bytes per snapshot per client
+#define PRIORITY_PLAYER 2.0f          // Base priority gained per tick by a changed player
+#define PRIORITY_ENEMY 1.0f           // Base priority gained per tick by a changed enemy
+#define PRIORITY_SELF 1000.0f         // A client's own plane always goes first
+#define MAX_CLOSING_SPEED (PLAYER_BULLET_SPEED + ENEMY_SPEED)  // Fastest a bullet and its target approach
+#define MAX_SUBSTEP_TRAVEL BULLET_WIDTH  // Closing distance allowed between hit tests
+#define MAX_SUBSTEPS 8
+#define MAX_ROOMS 4096
+#define ROOM_INBOX_PER_PLAYER 4       // Messages a room can hold per player slot between two of its ticks
+#define ROOM_INBOX_MIN 16
+#define OUTBOX_PER_PLAYER 4           // Datagrams a worker can queue per player slot between two shard flushes
+#define OUTBOX_MIN 64
+#define OUTBOX_MAX 16384
+#define RELIABLE_BACKLOG_PER_PLAYER 4  // Reliable sends queued per channel behind a full window, per player slot
+#define ROUTE_CHANGE_QUEUE 256        // Route changes a worker can queue; a full queue applies them in place
+#define FLUSH_RETRY_NS 100000ull      // Shard recheck while a worker it flushes is still running
+#define LOG_LINE_SIZE 256             // Longest piece of log text a worker queues at once
+#define LOG_PER_ROOM 16               // Log entries a playing room's stats take, besides its players
+#define LOG_PER_PLAYER 4              // Log entries each player adds to its room's stats
+#define LOG_QUEUE_MIN 256
+#define LOG_QUEUE_MAX 8192
+#define STATS_INTERVAL_MS 5000
 
 typedef struct {
     IPaddress address;
+    int shard;          // Shard its datagrams arrive on, and replies leave from
     int active;
     Uint32 last_heard;
+    Uint32 snapshots;   // Snapshots sent since stats were last printed
+    Uint32 acked_tick;  // Latest snapshot tick the client confirmed (0 = none)
+    ReliableEndpoint reliable;
+    int stalled;        // A reliable send found its backlog full; dropped at the next timeout check
+    CongestionControl congestion;  // Send rate and snapshot budget for this link
+    int compression;    // COMPRESSION_* agreed on connect
+    InputBuffer inputs; // Applied one per tick, in client tick order
+    SnapshotRing views; // State the client holds after each snapshot, used as baselines
+    Uint32 view_events[SNAPSHOT_RING_SIZE];  // Newest projectile event in each view
+    int view_synced[SNAPSHOT_RING_SIZE];     // Flat projectile slot each view's table is in sync up to
+    float *player_priority;  // Accumulated while an update is held back, per player slot
+    float *enemy_priority;   // And per enemy slot
 } ClientInfo;
 
+// Entity update competing for a client's snapshot budget
 typedef struct {
-    UDPsocket socket;
-    UDPpacket *packet;
-    ClientInfo clients[MAX_PLAYERS];
+    int is_player;
+    int index;
+    int bits;
+    float priority;
+} SendCandidate;
+
+// Datagram received for a room, decoded by the shard that received it and
+// waiting in the room's inbox for the room's next tick
+typedef struct {
+    IPaddress address;
+    int shard;          // Shard that received it
+    Uint32 received;    // SDL_GetTicks when it arrived
+    Uint64 received_ns; // clock_now_ns when it arrived
+    union {
+        PacketHeader header;    // header.type says which of the others is filled in
+        ConnectPacket connect;
+        InputPacket input;
+    };
+} RoomMessage;
+
+// Change to a shard's route table asked for by a room
+// Rooms never lock route tables; the shard draining the room's worker
+// applies the change in queue order, so a release and a later claim of the
+// same address cannot swap.
+typedef struct {
+    IPaddress address;
+    int shard;          // Shard whose table holds the route
+    int room;
+    int claim;          // 1 to route the address to room, 0 to drop its route to room
+} RouteChange;
+
+// Log text queued by a worker, written out by the shard that flushes it
+typedef struct {
+    char text[LOG_LINE_SIZE];
+} LogLine;
+
+// One independent match: its own world, clients and timers
+// A room is only ever touched by the worker thread that owns it; other
+// threads reach it through its inbox, and it reaches them through its
+// worker's queues. Running a room makes no system calls: even its log
+// lines are only formatted into a queue, for a shard to write.
+typedef struct {
+    int index;
+    size_t footprint;   // Bytes allocated for it
+    Ring inbox;         // RoomMessages, pushed by any shard
+    Ring *outbox;       // Its worker's NetDatagrams
+    Ring *route_changes;    // Its worker's RouteChanges
+    Ring *log;          // Its worker's LogLines
+    Uint32 *log_dropped;    // Its worker's count of lines lost to a full log
+    unsigned int seed;  // rand_r state for enemy spawns
+    ClientInfo *clients;    // One per player slot
     GameState game_state;
-    Uint32 last_enemy_spawn;
-    Uint32 last_enemy_shoot;
-    int running;
+    GameState current;  // Canonical copy of game_state for this tick's snapshots
+    Uint8 message[MAX_MESSAGE_SIZE];  // Encoded state packet before fragmentation
+    Uint8 payload[MAX_MESSAGE_SIZE];  // State plus projectile events
+    Uint8 event_data[MAX_MESSAGE_SIZE];
+    Uint8 compressed[MAX_MESSAGE_SIZE];  // Range-coded payload
+    ProjectileLog projectiles;
+    ProjectileEvent event_batch[PROJECTILE_BATCH_MAX];
+    SendCandidate *candidates;  // Room for every player and enemy
+    BulletSet *player_bullets;  // Live projectiles, simulated here and
+    BulletSet enemy_bullets;    // turned into wire events only when sent
+    int bullet_slots;           // Slots in the largest bullet set
+    int *bullet_hits;           // Scratch for culls and hit tests, bullet_slots entries
+    int *spent;                 // Bullets used up by a hit pass: a row of bullet_slots per player, then enemies
+    int *spent_count;           // Entries in each row of spent
+    Uint64 projectile_ns;     // Time in projectile movement and hit tests since stats were last printed
+    Uint32 projectile_ticks;
+    EntityPool enemy_pool;    // Enemy slots; the live count is the enemy count
+    SpatialGrid enemy_grid;   // Broadphase for hits on enemies
+    int *grid_candidates;     // One per enemy slot
+    RewindHistory rewind;     // Recent enemy positions for lag-compensated hits
+    Uint32 hits;              // Player bullet hits since stats were last printed
+    Uint32 rewound_hits;      // Of those, hits tested against a past world
+    float rewound_ticks;      // Sum of rewind distances of those hits
+    TimerWheel timers;        // Game timers, on simulation ticks
+    EntityId *respawn_timers; // Per player slot
     Uint32 sequence;
+    Uint64 busy_ns;           // Time spent running this room since stats were last printed
+    Uint64 busy_max_ns;       // Longest single run
+    Uint32 runs;              // Worker wake-ups that ran this room
+    Uint64 input_wait_ns;     // Time inputs spent queued before the tick that took them
+    Uint64 input_wait_max_ns;
+    Uint32 inputs_taken;
+    Uint32 snapshots_sent;
+    Uint32 snapshot_bytes_sent;
+    Uint32 keyframes_sent;
+    Uint32 datagrams_sent;
+    Uint32 messages_dropped;  // Snapshots and responses lost to a full outbox
+    Uint32 updates_deferred;  // Entity updates held back by the budget
+    Uint32 compress_raw_bytes;     // Payload bytes before compression
+    Uint32 compress_bytes;         // The same payloads as sent
+    Uint64 compress_ticks;         // Performance counter ticks spent encoding
+} Room;
+
+// Thread running a share of the rooms on one fixed-rate clock
+// It sleeps on a timerfd until each tick is due. With every room empty it
+// stops ticking and sleeps until a shard queues a message for one of them.
+// What it publishes lets the shard that flushes it sleep until its
+// datagrams are ready instead of polling.
+typedef struct {
+    int index;
+    int cpu;                  // Core it is pinned to, -1 if unpinned
+    SDL_Thread *thread;
+    Arena arena;              // Its rooms, allocated on the worker so their memory is local to its core
+    TickScheduler scheduler;  // Fixed-rate simulation clock shared by its rooms
+    Reactor reactor;          // Tick deadlines, and wake-ups while idle
+    atomic_int idle;          // Asleep with every room empty; cleared by the shard that wakes it
+    atomic_ullong next_ns;    // Start of its next wake-up, 0 while idle
+    atomic_ullong wake_ns;    // Length of its last wake-up
+    atomic_uint done;         // Wake-ups finished
+    Uint32 flushed;           // done as of the last flush; touched only by the flushing shard
+    Ring outbox;              // NetDatagrams from its rooms, sent by shard index % shard_count from its own socket
+    Ring route_changes;       // RouteChanges from its rooms, applied by the same shard
+    Ring log;                 // LogLines from it and its rooms, written by the same shard
+    atomic_uint logged;       // Log position at the end of its last wake-up; the shard writes up to here
+    Uint32 log_dropped;       // Log entries lost to a full queue since stats were last printed
+    atomic_int model_saved;   // Training counts saved for the flushing shard to write out as a model
+    Uint64 busy_ns;           // Time spent running rooms since stats were last printed
+    Uint64 wake_max_ns;       // Longest wake-up, all rooms included
+    Uint32 wakes;
+    Uint32 last_stats;
+} Worker;
+
+// One SO_REUSEPORT socket of the server port and the thread doing its I/O
+// Steering sends a given client to the same shard every time, so each
+// shard routes its own clients from its own table. Shards are the only
+// threads that touch sockets: besides receiving, each one sends what a
+// share of the workers queued and applies their route changes.
+typedef struct {
+    int index;
+    int cpu;                // Core it is pinned to, -1 if unpinned
+    SDL_Thread *thread;
+    NetSocket socket;
+    Reactor reactor;        // Socket readability and the next flush
+    NetBatch incoming;      // Receive buffers, filled by one call each
+    NetBatch outgoing;      // Message headers for sending queued datagrams
+    SDL_mutex *routes_lock; // Guards routes
+    RouteTable routes;      // Address to room, for the clients of this shard
+    Uint32 received;        // Datagrams read since stats were last printed
+    Uint32 routed;          // Datagrams handed to rooms
+    Uint32 unrouted;        // Datagrams from addresses in no room
+    Uint32 rejected;        // Connects turned away with every room full
+    Uint32 dropped;         // Messages lost to a full room inbox
+    Uint32 sent;            // Datagrams sent for rooms
+    Uint32 last_stats;
+} Shard;
+
+// Process-wide state: options, the shard sockets and the placement of clients in rooms
+// Options are set before any thread starts and are read-only afterwards.
+typedef struct {
+    RoomCapacity capacity;  // Entity limits of every room, fixed at startup and sent to clients on connect
+    int room_count;
+    Room **rooms;           // Filled in by the workers as they create their rooms
+    int worker_count;
+    Worker *workers;
+    int shard_count;
+    Shard *shards;
+    int steer;              // NET_STEER_* policy spreading clients over shards
+    int pin_workers;        // Pin workers and shards to cores
+    SDL_sem *ready;         // Posted by each worker once its rooms exist
+    SDL_mutex *rooms_lock;  // Guards room_players
+    int *room_players;      // Clients routed to each room
+    SDL_mutex *stats_lock;  // Held by shards writing to the log, so blocks from different threads do not mix
+    Arena arena;            // Rooms table, workers, shards and routes
+    int snapshot_budget;
+    int compression_enabled;
+    int train_model;    // Record payload statistics into a new compression model (room 0)
+    BulletKernel bullet_kernel;
+    int max_rewind_ms;        // 0 disables lag compensation
+    int tick_rate;            // Simulation ticks per second
+    int send_rate;            // Snapshots per second per client, before congestion control
+    int substeps;             // Projectile movement and hit-test steps per tick
+    SDL_atomic_t running;
 } Server;
 
 Server server;
 
+// Queue log text for the shard flushing the worker to write
+// Formatting into a queue slot keeps system calls off the tick. Text
+// past LOG_LINE_SIZE is cut; with the queue full it is dropped and counted.
+void queue_log(Ring *log, Uint32 *dropped, const char *format, va_list args) {
+    Uint32 position;
+    LogLine *line = ring_claim(log, &position);
+    if (!line) {
+        (*dropped)++;
+        return;
+    }
+    vsnprintf(line->text, LOG_LINE_SIZE, format, args);
+    ring_publish(log, position);
+}
+
+void room_log(Room *room, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    queue_log(room->log, room->log_dropped, format, args);
+    va_end(args);
+}
+
+void worker_log(Worker *worker, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    queue_log(&worker->log, &worker->log_dropped, format, args);
+    va_end(args);
+}
+
 int check_collision(float x1, float y1, int w1, int h1, float x2, float y2, int w2, int h2) {
     return !(x1 + w1 <= x2 || x1 >= x2 + w2 || y1 + h1 <= y2 || y1 >= y2 + h2);
 }
 
-void add_explosion(float x, float y) {
-    for (int i = 0; i < 20; i++) {
-        if (!server.game_state.explosions[i].active) {
-            server.game_state.explosions[i].active = 1;
-            server.game_state.explosions[i].x = x;
-            server.game_state.explosions[i].y = y;
-            server.game_state.explosions[i].start_time = SDL_GetTicks();
-            break;
-        }
+// Queue an event for reliable delivery to every connected client
+void broadcast_event(Room *room, int channel, int type, int player_id, float x, float y, int value) {
+    GameEvent event;
+    event.type = type;
+    event.player_id = player_id;
+    event.x = x;
+    event.y = y;
+    event.value = value;
+
+    for (int i = 0; i < server.capacity.players; i++) {
+        if (!room->clients[i].active) continue;
+        if (!reliable_send(&room->clients[i].reliable, channel, &event)) room->clients[i].stalled = 1;
     }
 }
 
-void init_server() {
-    if (SDLNet_Init() < 0) {
-        printf("SDLNet_Init failed: %s\n", SDLNet_GetError());
-        exit(1);
+void add_explosion(Room *room, float x, float y) {
+    broadcast_event(room, RELIABLE_CHANNEL_GAMEPLAY, EVENT_EXPLOSION, -1, x, y, 0);
+}
+
+void log_projectile_spawn(Room *room, int owner, int slot, float x, float y, float vx, float vy) {
+    ProjectileEvent event;
+    memset(&event, 0, sizeof(event));
+    event.type = PROJECTILE_SPAWN;
+    event.tick = room->game_state.tick;
+    event.owner = owner;
+    event.slot = slot;
+    event.x = x;
+    event.y = y;
+    event.vx = vx;
+    event.vy = vy;
+    projectile_log_push(&room->projectiles, &event);
+}
+
+void log_projectile_despawn(Room *room, int owner, int slot) {
+    ProjectileEvent event;
+    memset(&event, 0, sizeof(event));
+    event.type = PROJECTILE_DESPAWN;
+    event.tick = room->game_state.tick;
+    event.owner = owner;
+    event.slot = slot;
+    projectile_log_push(&room->projectiles, &event);
+}
+
+void despawn_player_bullets(Room *room, int player_id) {
+    BulletSet *bullets = &room->player_bullets[player_id];
+    for (int i = 0; i < bullets->count; i++) {
+        log_projectile_despawn(room, player_id, bullets_slot(bullets, i));
     }
+    bullets_clear(bullets);
+}
 
-    server.socket = SDLNet_UDP_Open(SERVER_PORT);
-    if (!server.socket) {
-        printf("SDLNet_UDP_Open failed: %s\n", SDLNet_GetError());
-        exit(1);
+// First tick at least ms milliseconds of simulation time from now
+Uint32 ticks_from_now(Room *room, Uint32 ms) {
+    return room->game_state.tick + (ms * server.tick_rate + 999) / 1000;
+}
+
+// Where a player slot enters and respawns: the first four across the
+// middle of the arena, later ones in staggered rows around them
+void spawn_point(int slot, float *x, float *y) {
+    *x = 100 + (slot % 4) * 150;
+    *y = (float)((WINDOW_HEIGHT / 2 - 100 + (slot % 4) * 50 + (slot / 4) * 40) % (WINDOW_HEIGHT - 65));
+}
+
+// Bring a new enemy in at the right edge
+void spawn_enemy(Room *room) {
+    EntityId id = pool_alloc(&room->enemy_pool);
+    if (id == ENTITY_NONE) return;
+
+    int e = ENTITY_INDEX(id);
+    NetworkEnemy *enemy = &room->game_state.enemies[e];
+    enemy->id = id;
+    enemy->active = 1;
+    enemy->x = WINDOW_WIDTH;
+    enemy->y = rand_r(&room->seed) % (WINDOW_HEIGHT - 250);
+    enemy->texture_id = rand_r(&room->seed) % 6;
+    enemy->health = 1;
+    rewind_on_spawn(&room->rewind, e, room->game_state.tick + 1);
+}
+
+// Enemy spawn cadence: one enemy per interval, retried every tick while all slots are taken
+void enemy_spawn_timer(void *context, int arg) {
+    Room *room = context;
+    (void)arg;
+    if (room->enemy_pool.count == room->enemy_pool.capacity) {
+        timer_schedule(&room->timers, room->game_state.tick + 1, enemy_spawn_timer, 0);
+        return;
+    }
+    spawn_enemy(room);
+    timer_schedule(&room->timers, ticks_from_now(room, ENEMY_SPAWN_INTERVAL), enemy_spawn_timer, 0);
+}
+
+// Enemy fire cadence: the first enemy fires once per interval, retried
+// every tick while there is no enemy or no free enemy bullet slot
+void enemy_shoot_timer(void *context, int arg) {
+    Room *room = context;
+    (void)arg;
+    int slot = -1;
+    if (room->enemy_pool.count > 0) {
+        const NetworkEnemy *enemy = &room->game_state.enemies[room->enemy_pool.dense[0]];
+        float x = enemy->x;
+        float y = enemy->y + (ENEMY_HEIGHT / 2);
+        slot = bullets_spawn(&room->enemy_bullets, x, y, -ENEMY_BULLET_SPEED, 0);
+        if (slot >= 0) log_projectile_spawn(room, PROJECTILE_OWNER_ENEMY, slot, x, y, -ENEMY_BULLET_SPEED, 0);
     }
+    Uint32 due = slot >= 0 ? ticks_from_now(room, ENEMY_SHOOT_INTERVAL) : room->game_state.tick + 1;
+    timer_schedule(&room->timers, due, enemy_shoot_timer, 0);
+}
 
-    server.packet = SDLNet_AllocPacket(MAX_PACKET_SIZE);
-    if (!server.packet) {
-        printf("SDLNet_AllocPacket failed: %s\n", SDLNet_GetError());
-        exit(1);
+// Remove an enemy; ids left over from an earlier kill this tick are ignored
+int despawn_enemy(Room *room, EntityId id) {
+    int e = pool_slot(&room->enemy_pool, id);
+    if (e < 0) return 0;
+
+    pool_release(&room->enemy_pool, id);
+    room->game_state.enemies[e].active = 0;
+    grid_remove(&room->enemy_grid, e);
+    return 1;
+}
+
+void respawn_player(void *context, int player_id) {
+    Room *room = context;
+    NetworkPlayer *player = &room->game_state.players[player_id];
+    if (!player->active || player->alive) return;
+
+    player->alive = 1;
+    player->health = 100;
+    spawn_point(player_id, &player->x, &player->y);
+    player->bullets_fired = 0;
+    player->reloading = 0;
+    player->respawn_time = 0;
+    broadcast_event(room, RELIABLE_CHANNEL_GAMEPLAY, EVENT_PLAYER_RESPAWNED, player_id, player->x, player->y, 0);
+    room_log(room, "[RESPAWN] Player %d respawned\n", player_id);
+}
+
+void kill_player(Room *room, int player_id) {
+    NetworkPlayer *player = &room->game_state.players[player_id];
+    Uint32 due = ticks_from_now(room, RESPAWN_TIME);
+    player->alive = 0;
+    player->health = 0;
+    player->respawn_time = TICK_TIME_MS(due, server.tick_rate);
+    room->respawn_timers[player_id] = timer_schedule(&room->timers, due, respawn_player, player_id);
+    despawn_player_bullets(room, player_id);
+    add_explosion(room, player->x, player->y);
+    broadcast_event(room, RELIABLE_CHANNEL_GAMEPLAY, EVENT_PLAYER_DIED, player_id, player->x, player->y, player->score);
+}
+
+// Build one room on the calling worker's arena, sized from the room capacities
+Room *create_room(Worker *worker, int index) {
+    const RoomCapacity *capacity = &server.capacity;
+    Arena *arena = &worker->arena;
+    size_t allocated = arena->allocated;
+    Room *room = arena_alloc(arena, sizeof(Room));
+    if (!room) return NULL;
+
+    room->index = index;
+    room->seed = (unsigned int)time(NULL) ^ (unsigned int)index * 2654435761u;
+    room->outbox = &worker->outbox;
+    room->route_changes = &worker->route_changes;
+    room->log = &worker->log;
+    room->log_dropped = &worker->log_dropped;
+
+    int inbox_size = capacity->players * ROOM_INBOX_PER_PLAYER;
+    if (inbox_size < ROOM_INBOX_MIN) inbox_size = ROOM_INBOX_MIN;
+    int reliable_backlog = capacity->players * RELIABLE_BACKLOG_PER_PLAYER;
+    if (reliable_backlog < RELIABLE_WINDOW) reliable_backlog = RELIABLE_WINDOW;
+
+    projectile_log_init(&room->projectiles);
+    room->bullet_slots = capacity->bullets_per_player > capacity->enemy_bullets
+                          ? capacity->bullets_per_player : capacity->enemy_bullets;
+    room->clients = arena_alloc(arena, sizeof(ClientInfo) * capacity->players);
+    room->player_bullets = arena_alloc(arena, sizeof(BulletSet) * capacity->players);
+    room->candidates = arena_alloc(arena, sizeof(SendCandidate) * (capacity->players + capacity->enemies));
+    room->bullet_hits = arena_alloc(arena, sizeof(int) * room->bullet_slots);
+    room->spent = arena_alloc(arena, sizeof(int) * room->bullet_slots * (capacity->players + 1));
+    room->spent_count = arena_alloc(arena, sizeof(int) * (capacity->players + 1));
+    room->grid_candidates = arena_alloc(arena, sizeof(int) * capacity->enemies);
+    room->respawn_timers = arena_alloc(arena, sizeof(EntityId) * capacity->players);
+    int complete = ring_init(&room->inbox, inbox_size, sizeof(RoomMessage), RING_MULTI_PRODUCER, arena) &&
+                    room->clients && room->player_bullets && room->candidates && room->bullet_hits &&
+                    room->spent && room->spent_count && room->grid_candidates && room->respawn_timers &&
+                    game_state_init(&room->game_state, capacity, 0, arena) &&
+                    game_state_init(&room->current, capacity, 0, arena) &&
+                    rewind_init(&room->rewind, capacity->enemies, arena) &&
+                    bullets_init(&room->enemy_bullets, capacity->enemy_bullets, arena) &&
+                    pool_init(&room->enemy_pool, capacity->enemies, arena) &&
+                    grid_init(&room->enemy_grid, WINDOW_WIDTH, WINDOW_HEIGHT, capacity->enemies, arena) &&
+                    // Respawns plus the enemy spawn and shoot cadences
+                    timer_wheel_init(&room->timers, capacity->players + 2, room->game_state.tick, room, arena);
+    for (int i = 0; complete && i < capacity->players; i++) {
+        ClientInfo *client = &room->clients[i];
+        client->player_priority = arena_alloc(arena, sizeof(float) * capacity->players);
+        client->enemy_priority = arena_alloc(arena, sizeof(float) * capacity->enemies);
+        complete = client->player_priority && client->enemy_priority &&
+                    snapshot_ring_init(&client->views, capacity, arena) &&
+                    reliable_backlog_init(&client->reliable, reliable_backlog, arena) &&
+                    bullets_init(&room->player_bullets[i], capacity->bullets_per_player, arena);
     }
+    if (!complete) return NULL;
 
-    // Initialize game state
-    memset(&server.game_state, 0, sizeof(GameState));
-    memset(server.clients, 0, sizeof(server.clients));
-    
-    server.running = 1;
-    server.sequence = 0;
-    server.last_enemy_spawn = 0;
-    server.last_enemy_shoot = 0;
+    timer_schedule(&room->timers, ticks_from_now(room, ENEMY_SPAWN_INTERVAL), enemy_spawn_timer, 0);
+    timer_schedule(&room->timers, ticks_from_now(room, ENEMY_SHOOT_INTERVAL), enemy_shoot_timer, 0);
+    room->footprint = arena->allocated - allocated;
+    return room;
+}
 
-    printf("========================================\n");
-    printf("  Flying Aces: 1942 - Server Started\n");
-    printf("========================================\n");
-    printf("Port: %d\n", SERVER_PORT);
-    printf("Max Players: %d\n", MAX_PLAYERS);
-    printf("Tick Rate: %d Hz\n", TICK_RATE);
-    printf("\nWaiting for players...\n");
+// Apply a room's route change to a shard's table; runs on a shard thread
+void apply_route_change(const RouteChange *change) {
+    Shard *shard = &server.shards[change->shard];
+    SDL_LockMutex(shard->routes_lock);
+    int current = route_find(&shard->routes, &change->address);
+    if (change->claim) {
+        if (current != change->room && route_add(&shard->routes, &change->address, change->room)) {
+            SDL_LockMutex(server.rooms_lock);
+            if (current != ROUTE_NONE) server.room_players[current]--;
+            server.room_players[change->room]++;
+            SDL_UnlockMutex(server.rooms_lock);
+        }
+    } else if (current == change->room) {
+        route_remove(&shard->routes, &change->address);
+        SDL_LockMutex(server.rooms_lock);
+        server.room_players[change->room]--;
+        SDL_UnlockMutex(server.rooms_lock);
+    }
+    SDL_UnlockMutex(shard->routes_lock);
+}
+
+// Queue a route change for the shard draining this room's worker
+// The queue holds more changes than a room's clients can make between two
+// flushes; should it fill anyway the change is applied here, taking the
+// locks the worker otherwise never touches.
+void queue_route_change(Room *room, int shard, const IPaddress *address, int claim) {
+    RouteChange change;
+    change.address = *address;
+    change.shard = shard;
+    change.room = room->index;
+    change.claim = claim;
+
+    Uint32 position;
+    RouteChange *entry = ring_claim(room->route_changes, &position);
+    if (!entry) {
+        apply_route_change(&change);
+        return;
+    }
+    *entry = change;
+    ring_publish(room->route_changes, position);
+}
+
+// Route a client address to a room unless it already has a route
+// Called by a room for a client it accepts, since a disconnect processed
+// just before a reconnect from the same address removes the route
+void claim_route(Room *room, int shard, const IPaddress *address) {
+    queue_route_change(room, shard, address, 1);
+}
+
+// Drop a client address's route to this room, freeing its place for new connects
+void release_route(Room *room, int shard, const IPaddress *address) {
+    queue_route_change(room, shard, address, 0);
 }
 
-int find_free_player_slot() {
-    for (int i = 0; i < MAX_PLAYERS; i++) {
-        if (!server.clients[i].active) {
+int find_free_player_slot(Room *room) {
+    for (int i = 0; i < server.capacity.players; i++) {
+        if (!room->clients[i].active) {
             return i;
         }
     }
     return -1;
 }
 
-void handle_connect(IPaddress *addr) {
-    int slot = find_free_player_slot();
-    if (slot < 0) {
-        printf("Server full, rejecting connection\n");
-        
-        ConnectResponse response;
-        response.header.type = PACKET_CONNECT;
-        response.header.player_id = -1;
-        response.header.sequence = server.sequence++;
-        response.assigned_id = -1;
-        response.success = 0;
-
-        memcpy(server.packet->data, &response, sizeof(ConnectResponse));
-        server.packet->len = sizeof(ConnectResponse);
-        server.packet->address = *addr;
-        SDLNet_UDP_Send(server.socket, -1, server.packet);
+int find_player_by_address(Room *room, IPaddress *addr) {
+    for (int i = 0; i < server.capacity.players; i++) {
+        if (room->clients[i].active &&
+            room->clients[i].address.host == addr->host &&
+            room->clients[i].address.port == addr->port) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Encode a connect response; slot -1 rejects the connect
+int write_connect_response(Uint8 *data, int size, Uint32 sequence, int slot, int compression) {
+    ConnectResponse response;
+    response.header.type = PACKET_CONNECT;
+    response.header.player_id = slot;
+    response.header.sequence = sequence;
+    response.assigned_id = slot;
+    response.success = slot >= 0;
+    response.compression = compression;
+    response.tick_rate = server.tick_rate;
+    response.capacity = server.capacity;
+    return codec_write_connect_response(data, size, &response);
+}
+
+// Queue a room's connect response for its worker's shard to send
+void send_connect_response(Room *room, const IPaddress *addr, int slot, int compression) {
+    Uint32 position;
+    NetDatagram *datagram = ring_claim(room->outbox, &position);
+    if (!datagram) {
+        room->messages_dropped++;
+        return;
+    }
+    datagram->address = *addr;
+    datagram->len = write_connect_response(datagram->data, NET_MTU, room->sequence++, slot, compression);
+    ring_publish(room->outbox, position);
+}
+
+void handle_connect(Room *room, int shard, IPaddress *addr, const ConnectPacket *request) {
+    // A retried connect (lost response) gets its existing slot back
+    int existing = find_player_by_address(room, addr);
+    if (existing >= 0) {
+        send_connect_response(room, addr, existing, room->clients[existing].compression);
         return;
     }
 
-    server.clients[slot].address = *addr;
-    server.clients[slot].active = 1;
-    server.clients[slot].last_heard = SDL_GetTicks();
+    int slot = find_free_player_slot(room);
+    if (slot < 0) {
+        room_log(room, "Room %d full, rejecting connection\n", room->index);
+        release_route(room, shard, addr);
+        send_connect_response(room, addr, -1, COMPRESSION_NONE);
+        return;
+    }
+    claim_route(room, shard, addr);
+
+    room->clients[slot].address = *addr;
+    room->clients[slot].shard = shard;
+    room->clients[slot].active = 1;
+    room->clients[slot].last_heard = SDL_GetTicks();
+    room->clients[slot].acked_tick = 0;
+    room->clients[slot].stalled = 0;
+    reliable_init(&room->clients[slot].reliable);
+    congestion_init(&room->clients[slot].congestion, server.snapshot_budget, (float)server.send_rate,
+                    server.tick_rate, SDL_GetTicks());
+    input_buffer_init(&room->clients[slot].inputs, server.tick_rate);
+    snapshot_ring_clear(&room->clients[slot].views);
+    memset(room->clients[slot].player_priority, 0, sizeof(float) * server.capacity.players);
+    memset(room->clients[slot].enemy_priority, 0, sizeof(float) * server.capacity.enemies);
 
     // Initialize player
-    NetworkPlayer *player = &server.game_state.players[slot];
+    NetworkPlayer *player = &room->game_state.players[slot];
     player->id = slot;
-    player->x = 100 + slot * 150;
-    player->y = (WINDOW_HEIGHT / 2) + (slot * 50) - 100;
+    spawn_point(slot, &player->x, &player->y);
     player->health = 100;
     player->score = 0;
     player->active = 1;
@@ -143,405 +648,1461 @@ void handle_connect(IPaddress *addr) {
     player->reloading = 0;
     player->last_shoot_time = 0;
     player->respawn_time = 0;
-    memset(player->bullets, 0, sizeof(player->bullets));
 
-    server.game_state.player_count++;
+    room->game_state.player_count++;
 
-    // Send connection response
-    ConnectResponse response;
-    response.header.type = PACKET_CONNECT;
-    response.header.player_id = slot;
-    response.header.sequence = server.sequence++;
-    response.assigned_id = slot;
-    response.success = 1;
+    room->clients[slot].compression = server.compression_enabled && request->compression >= COMPRESSION_RANGE
+                                       ? COMPRESSION_RANGE : COMPRESSION_NONE;
+    send_connect_response(room, addr, slot, room->clients[slot].compression);
 
-    memcpy(server.packet->data, &response, sizeof(ConnectResponse));
-    server.packet->len = sizeof(ConnectResponse);
-    server.packet->address = *addr;
-    SDLNet_UDP_Send(server.socket, -1, server.packet);
+    // Tell everyone, the newcomer included, who is in the game
+    broadcast_event(room, RELIABLE_CHANNEL_CONTROL, EVENT_PLAYER_JOINED, slot, player->x, player->y, 0);
+    for (int i = 0; i < server.capacity.players; i++) {
+        if (i == slot || !room->clients[i].active) continue;
+        GameEvent event = {EVENT_PLAYER_JOINED, i, room->game_state.players[i].x, room->game_state.players[i].y, 0};
+        if (!reliable_send(&room->clients[slot].reliable, RELIABLE_CHANNEL_CONTROL, &event)) {
+            room->clients[slot].stalled = 1;
+        }
+    }
 
-    printf("[+] Player %d connected (Total: %d/%d)\n", slot, server.game_state.player_count, MAX_PLAYERS);
+    room_log(room, "[+] Player %d connected to room %d (Total: %d/%d)\n",
+           slot, room->index, room->game_state.player_count, server.capacity.players);
 }
 
-void handle_disconnect(int player_id) {
-    if (player_id < 0 || player_id >= MAX_PLAYERS || !server.clients[player_id].active) {
+void handle_disconnect(Room *room, int player_id) {
+    if (player_id < 0 || player_id >= server.capacity.players || !room->clients[player_id].active) {
         return;
     }
 
-    server.clients[player_id].active = 0;
-    server.game_state.players[player_id].active = 0;
-    server.game_state.players[player_id].alive = 0;
-    server.game_state.player_count--;
-    printf("[-] Player %d disconnected (Total: %d/%d)\n", player_id, server.game_state.player_count, MAX_PLAYERS);
+    room->clients[player_id].active = 0;
+    release_route(room, room->clients[player_id].shard, &room->clients[player_id].address);
+    despawn_player_bullets(room, player_id);
+    room->game_state.players[player_id].active = 0;
+    room->game_state.players[player_id].alive = 0;
+    room->game_state.player_count--;
+    timer_cancel(&room->timers, room->respawn_timers[player_id]);
+    broadcast_event(room, RELIABLE_CHANNEL_CONTROL, EVENT_PLAYER_LEFT, player_id, 0, 0, 0);
+    room_log(room, "[-] Player %d left room %d (Total: %d/%d)\n",
+           player_id, room->index, room->game_state.player_count, server.capacity.players);
 }
 
-void process_player_input(int player_id, PlayerInput *input, float delta_time) {
-    if (player_id < 0 || player_id >= MAX_PLAYERS) return;
-    if (!server.game_state.players[player_id].active) return;
-    if (!server.game_state.players[player_id].alive) return;
-
-    NetworkPlayer *player = &server.game_state.players[player_id];
-    Uint32 current_time = SDL_GetTicks();
-
-    // Update position
-    float x_vel = 0, y_vel = 0;
-    if (input->move_up && !input->move_down) y_vel = -SPEED;
-    if (input->move_down && !input->move_up) y_vel = SPEED;
-    if (input->move_left && !input->move_right) x_vel = -SPEED;
-    if (input->move_right && !input->move_left) x_vel = SPEED;
+// Step a player by one input using the rules clients predict with
+// now is the input clock time of the input (INPUT_TICK_TIME)
+void process_player_input(Room *room, int player_id, PlayerInput *input, float delta_time, Uint32 now) {
+    if (player_id < 0 || player_id >= server.capacity.players) return;
+    if (!room->game_state.players[player_id].active) return;
+    if (!room->game_state.players[player_id].alive) return;
 
-    player->x += x_vel * delta_time;
-    player->y += y_vel * delta_time;
+    NetworkPlayer *player = &room->game_state.players[player_id];
 
-    // Clamp position
-    if (player->x < 0) player->x = 0;
-    if (player->y < 0) player->y = 0;
-    if (player->x > WINDOW_WIDTH - PLAYER_WIDTH) player->x = WINDOW_WIDTH - PLAYER_WIDTH;
-    if (player->y > WINDOW_HEIGHT - PLAYER_HEIGHT) player->y = WINDOW_HEIGHT - PLAYER_HEIGHT;
+    movement_update_reload(player, now);
+    movement_apply(player, input, delta_time);
 
     // Handle shooting with rate limiting
-    if (input->shooting && !player->reloading && 
-        player->bullets_fired < MAX_BULLETS_BEFORE_RELOAD &&
-        current_time >= player->last_shoot_time + PLAYER_SHOOT_INTERVAL) {
-        
-        // Find free bullet slot
-        for (int i = 0; i < MAX_BULLETS_PER_PLAYER; i++) {
-            if (!player->bullets[i].active) {
-                player->bullets[i].active = 1;
-                player->bullets[i].x = player->x + PLAYER_WIDTH;
-                player->bullets[i].y = player->y + (PLAYER_HEIGHT / 2);
-                player->bullets[i].vx = BULLET_SPEED;
-                player->bullets[i].vy = 0;
-                player->bullets_fired++;
-                player->last_shoot_time = current_time;
-                
-                if (player->bullets_fired >= MAX_BULLETS_BEFORE_RELOAD) {
-                    player->reloading = 1;
-                    player->reload_start_time = current_time;
-                }
-                break;
-            }
+    if (movement_can_shoot(player, input, now)) {
+        NetworkBullet shot;
+        movement_shot_origin(player, &shot);
+        int slot = bullets_spawn(&room->player_bullets[player_id], shot.x, shot.y, shot.vx, shot.vy);
+        if (slot >= 0) {
+            log_projectile_spawn(room, player_id, slot, shot.x, shot.y, shot.vx, shot.vy);
+            movement_on_shot(player, now);
         }
     }
 }
 
-void update_game_state(float delta_time) {
-    Uint32 current_time = SDL_GetTicks();
+// Apply exactly one buffered input per client for this tick
+void apply_player_inputs(Room *room) {
+    Uint32 now = SDL_GetTicks();
+    for (int i = 0; i < server.capacity.players; i++) {
+        if (!room->clients[i].active) continue;
+
+        // Holding means the client's input clock has not reached this tick
+        PlayerInput input;
+        InputBuffer *inputs = &room->clients[i].inputs;
+        if (!input_buffer_pop(inputs, now, &input)) continue;
+        process_player_input(room, i, &input, 1.0f / server.tick_rate,
+                             INPUT_TICK_TIME(inputs->applied_sequence, server.tick_rate));
+    }
+}
 
-    // Update players
-    for (int i = 0; i < MAX_PLAYERS; i++) {
-        if (!server.game_state.players[i].active) continue;
-        
-        NetworkPlayer *player = &server.game_state.players[i];
+// Tick of the world a player was looking at when it made the input just
+// applied, capped at the rewind window; 0 means test against the present
+double shooter_view_tick(Room *room, int player_id) {
+    if (server.max_rewind_ms <= 0 || !room->clients[player_id].active) return 0;
 
-        // Handle respawn
-        if (!player->alive && player->respawn_time > 0 && current_time >= player->respawn_time) {
-            player->alive = 1;
-            player->health = 100;
-            player->x = 100 + i * 150;
-            player->y = (WINDOW_HEIGHT / 2) + (i * 50) - 100;
-            player->bullets_fired = 0;
-            player->reloading = 0;
-            player->respawn_time = 0;
-            printf("[RESPAWN] Player %d respawned\n", i);
-        }
+    double view_tick = room->clients[player_id].inputs.applied_view_tick;
+    Uint32 present = room->game_state.tick + 1;  // Tick the positions being tested will carry
+    double earliest = present - (double)server.max_rewind_ms * server.tick_rate / 1000.0;
+    if (view_tick <= 0 || view_tick >= present) return 0;
+    return view_tick < earliest ? earliest : view_tick;
+}
 
-        if (!player->alive) continue;
+// Move bullets and enemies by one sub-step, removing those that left the arena
+void move_projectiles(Room *room, float delta_time) {
+    int *removed = room->bullet_hits;
 
-        // Handle reloading
-        if (player->reloading && current_time >= player->reload_start_time + RELOAD_TIME) {
-            player->reloading = 0;
-            player->bullets_fired = 0;
-        }
+    for (int i = 0; i < server.capacity.players; i++) {
+        NetworkPlayer *player = &room->game_state.players[i];
+        if (!player->active || !player->alive) continue;
 
-        // Update player bullets
-        for (int j = 0; j < MAX_BULLETS_PER_PLAYER; j++) {
-            if (!player->bullets[j].active) continue;
+        BulletSet *bullets = &room->player_bullets[i];
+        bullets_integrate(bullets, delta_time);
+        int count = bullets_cull(bullets, 0, 0, WINDOW_WIDTH, WINDOW_HEIGHT, removed);
+        for (int k = 0; k < count; k++) log_projectile_despawn(room, i, removed[k]);
+    }
 
-            player->bullets[j].x += player->bullets[j].vx * delta_time;
-            player->bullets[j].y += player->bullets[j].vy * delta_time;
+    // Backwards, so a despawn only moves enemies already visited
+    for (int k = room->enemy_pool.count - 1; k >= 0; k--) {
+        NetworkEnemy *enemy = &room->game_state.enemies[room->enemy_pool.dense[k]];
+        enemy->x -= ENEMY_SPEED * delta_time;
 
-            // Remove off-screen bullets
-            if (player->bullets[j].x > WINDOW_WIDTH || player->bullets[j].x < 0 ||
-                player->bullets[j].y > WINDOW_HEIGHT || player->bullets[j].y < 0) {
-                player->bullets[j].active = 0;
-            }
-        }
+        // Remove off-screen enemies
+        if (enemy->x < -200) despawn_enemy(room, enemy->id);
     }
 
-    // Spawn enemies
-    if (current_time > server.last_enemy_spawn + ENEMY_SPAWN_INTERVAL &&
-        server.game_state.enemy_count < MAX_ENEMIES) {
-        for (int i = 0; i < MAX_ENEMIES; i++) {
-            if (!server.game_state.enemies[i].active) {
-                server.game_state.enemies[i].active = 1;
-                server.game_state.enemies[i].x = WINDOW_WIDTH;
-                server.game_state.enemies[i].y = rand() % (WINDOW_HEIGHT - 250);
-                server.game_state.enemies[i].texture_id = rand() % 6;
-                server.game_state.enemies[i].health = 1;
-                server.game_state.enemy_count++;
-                server.last_enemy_spawn = current_time;
-                break;
-            }
-        }
+    bullets_integrate(&room->enemy_bullets, delta_time);
+    int count = bullets_cull(&room->enemy_bullets, -50, -50, WINDOW_WIDTH + 50, WINDOW_HEIGHT + 50, removed);
+    for (int k = 0; k < count; k++) log_projectile_despawn(room, PROJECTILE_OWNER_ENEMY, removed[k]);
+}
+
+// Bring the broadphase grid up to date with enemy positions
+void update_grids(Room *room) {
+    for (int k = 0; k < room->enemy_pool.count; k++) {
+        int e = room->enemy_pool.dense[k];
+        NetworkEnemy *enemy = &room->game_state.enemies[e];
+        grid_update(&room->enemy_grid, e, enemy->x, enemy->y, ENEMY_WIDTH, ENEMY_HEIGHT);
     }
+}
 
-    // Update enemies and enemy shooting
-    for (int i = 0; i < MAX_ENEMIES; i++) {
-        if (!server.game_state.enemies[i].active) continue;
+// Bullets used up in the current hit pass: row p is player p's, the row
+// after the last player is the enemies'
+int *spent_row(Room *room, int row) {
+    return room->spent + row * room->bullet_slots;
+}
 
-        server.game_state.enemies[i].x -= ENEMY_SPEED * delta_time;
+// Test bullets against what they can hit after a sub-step
+// fraction is how far through the tick the sub-step ends (1 = the tick's end)
+void check_bullet_hits(Room *room, float fraction) {
+    int *hits = room->bullet_hits;
+    int players = server.capacity.players;
+
+    // Bullets that hit something leave after the pass, so like a bullet
+    // tested against every enemy in turn, one can destroy several at once
+    int *spent_count = room->spent_count;
+    memset(spent_count, 0, sizeof(int) * (players + 1));
+
+    // Doubles, since room ticks grow past where a float keeps fractions
+    double view_ticks[players];
+    for (int p = 0; p < players; p++) {
+        view_ticks[p] = shooter_view_tick(room, p);
+        if (view_ticks[p] > 0) view_ticks[p] -= 1.0 - fraction;
+    }
 
-        // Enemy shooting
-        if (current_time > server.last_enemy_shoot + ENEMY_SHOOT_INTERVAL &&
-            server.game_state.enemy_bullet_count < MAX_ENEMY_BULLETS) {
-            for (int j = 0; j < MAX_ENEMY_BULLETS; j++) {
-                if (!server.game_state.enemy_bullets[j].active) {
-                    server.game_state.enemy_bullets[j].active = 1;
-                    server.game_state.enemy_bullets[j].x = server.game_state.enemies[i].x;
-                    server.game_state.enemy_bullets[j].y = server.game_state.enemies[i].y + (ENEMY_HEIGHT / 2);
-                    server.game_state.enemy_bullets[j].vx = -ENEMY_BULLET_SPEED;
-                    server.game_state.enemy_bullets[j].vy = 0;
-                    server.game_state.enemy_bullet_count++;
-                    server.last_enemy_shoot = current_time;
-                    break;
-                }
+    // Player bullets vs Enemies: a band query on the enemy grid finds the
+    // enemies near the box around a shooter's bullets, which spans most of
+    // the arena's width, and each of those, placed where the shooter saw
+    // it, is tested against all of the shooter's bullets at once. Shooters
+    // go in slot order, so the lowest one takes a shared kill.
+    for (int p = 0; p < players; p++) {
+        NetworkPlayer *player = &room->game_state.players[p];
+        BulletSet *bullets = &room->player_bullets[p];
+        float min_x, min_y, max_x, max_y;
+        if (!player->active || !player->alive) continue;
+        if (!bullets_bounds(bullets, &min_x, &min_y, &max_x, &max_y)) continue;
+
+        // Enemies only fly left, so where the shooter saw one is up to this
+        // far right of where it is now
+        int rewound = view_ticks[p] > 0;
+        float rewind_ticks = rewound ? (float)(room->game_state.tick + (double)fraction - view_ticks[p]) : 0;
+        float rewind_travel = rewound ? ENEMY_SPEED * rewind_ticks / server.tick_rate + 1.0f : 0;
+        int found = grid_query_band(&room->enemy_grid, min_x - rewind_travel, min_y,
+                                    max_x - min_x + BULLET_WIDTH + rewind_travel, max_y - min_y + BULLET_HEIGHT,
+                                    room->grid_candidates, server.capacity.enemies);
+
+        for (int c = 0; c < found; c++) {
+            int e = room->grid_candidates[c];
+            if (!room->game_state.enemies[e].active) continue;
+
+            // Enemies the shooter could not see yet cannot be hit
+            float enemy_x = room->game_state.enemies[e].x;
+            float enemy_y = room->game_state.enemies[e].y;
+            if (rewound && !rewind_enemy_at(&room->rewind, e, view_ticks[p], &enemy_x, &enemy_y)) continue;
+
+            int count = bullets_overlap(bullets, BULLET_WIDTH, BULLET_HEIGHT,
+                                        enemy_x, enemy_y, ENEMY_WIDTH, ENEMY_HEIGHT, hits);
+            if (count == 0) continue;
+
+            // The lowest slot takes the kill, as when slots were tested in order
+            int slot = bullets_slot(bullets, hits[0]);
+            for (int h = 1; h < count; h++) {
+                if (bullets_slot(bullets, hits[h]) < slot) slot = bullets_slot(bullets, hits[h]);
+            }
+            spent_row(room, p)[spent_count[p]++] = slot;
+
+            despawn_enemy(room, room->game_state.enemies[e].id);
+            player->score += 10;
+            add_explosion(room, room->game_state.enemies[e].x, room->game_state.enemies[e].y);
+            room->hits++;
+            if (rewound) {
+                room->rewound_hits++;
+                room->rewound_ticks += rewind_ticks;
             }
-        }
-
-        // Remove off-screen enemies
-        if (server.game_state.enemies[i].x < -200) {
-            server.game_state.enemies[i].active = 0;
-            server.game_state.enemy_count--;
         }
     }
 
-    // Update enemy bullets
-    for (int i = 0; i < MAX_ENEMY_BULLETS; i++) {
-        if (!server.game_state.enemy_bullets[i].active) continue;
+    // Enemy bullets vs Players
+    for (int p = 0; p < players; p++) {
+        NetworkPlayer *player = &room->game_state.players[p];
+        if (!player->active || !player->alive) continue;
 
-        server.game_state.enemy_bullets[i].x += server.game_state.enemy_bullets[i].vx * delta_time;
-        server.game_state.enemy_bullets[i].y += server.game_state.enemy_bullets[i].vy * delta_time;
+        int count = bullets_overlap(&room->enemy_bullets, BULLET_WIDTH, BULLET_HEIGHT,
+                                    player->x, player->y, PLAYER_WIDTH, PLAYER_HEIGHT, hits);
+        for (int k = 0; k < count; k++) {
+            spent_row(room, players)[spent_count[players]++] = bullets_slot(&room->enemy_bullets, hits[k]);
+            player->health -= 10;
 
-        // Remove off-screen bullets
-        if (server.game_state.enemy_bullets[i].x < -50 || server.game_state.enemy_bullets[i].x > WINDOW_WIDTH + 50 ||
-            server.game_state.enemy_bullets[i].y < -50 || server.game_state.enemy_bullets[i].y > WINDOW_HEIGHT + 50) {
-            server.game_state.enemy_bullets[i].active = 0;
-            server.game_state.enemy_bullet_count--;
+            if (player->health <= 0) {
+                kill_player(room, p);
+                room_log(room, "[DEATH] Player %d killed by enemy fire (Score: %d)\n", p, player->score);
+                break;
+            }
         }
     }
 
-    // Update explosions
-    for (int i = 0; i < 20; i++) {
-        if (server.game_state.explosions[i].active && 
-            current_time - server.game_state.explosions[i].start_time > 500) {
-            server.game_state.explosions[i].active = 0;
+    for (int row = 0; row <= players; row++) {
+        BulletSet *bullets = row < players ? &room->player_bullets[row] : &room->enemy_bullets;
+        for (int k = 0; k < spent_count[row]; k++) {
+            int slot = spent_row(room, row)[k];
+            if (!bullets_remove(bullets, slot)) continue;  // Already gone: hit twice, or its owner died
+            log_projectile_despawn(room, row < players ? row : PROJECTILE_OWNER_ENEMY, slot);
         }
     }
+}
 
-    // Check collisions: Player bullets vs Enemies
-    for (int p = 0; p < MAX_PLAYERS; p++) {
-        if (!server.game_state.players[p].active || !server.game_state.players[p].alive) continue;
-        NetworkPlayer *player = &server.game_state.players[p];
-
-        for (int b = 0; b < MAX_BULLETS_PER_PLAYER; b++) {
-            if (!player->bullets[b].active) continue;
-
-            for (int e = 0; e < MAX_ENEMIES; e++) {
-                if (!server.game_state.enemies[e].active) continue;
-
-                if (check_collision(player->bullets[b].x, player->bullets[b].y, BULLET_WIDTH, BULLET_HEIGHT,
-                                  server.game_state.enemies[e].x, server.game_state.enemies[e].y, 
-                                  ENEMY_WIDTH, ENEMY_HEIGHT)) {
-                    player->bullets[b].active = 0;
-                    server.game_state.enemies[e].active = 0;
-                    server.game_state.enemy_count--;
-                    player->score += 10;
-                    add_explosion(server.game_state.enemies[e].x, server.game_state.enemies[e].y);
-                }
-            }
-        }
+void update_game_state(Room *room, float delta_time) {
+    // Respawns and enemy spawn and fire cadence, on simulation ticks so
+    // catch-up ticks see time advance
+    timer_wheel_advance(&room->timers, room->game_state.tick);
+
+    // Fast movers advance in sub-steps with hit tests after each, so
+    // nothing passes through a target between two ticks
+    float step = delta_time / server.substeps;
+    Uint64 start = clock_now_ns();
+    for (int s = 1; s <= server.substeps; s++) {
+        move_projectiles(room, step);
+        update_grids(room);
+        check_bullet_hits(room, (float)s / server.substeps);
     }
+    room->projectile_ns += clock_now_ns() - start;
+    room->projectile_ticks++;
 
     // Check collisions: Players vs Enemies (ram damage)
-    for (int p = 0; p < MAX_PLAYERS; p++) {
-        if (!server.game_state.players[p].active || !server.game_state.players[p].alive) continue;
-        NetworkPlayer *player = &server.game_state.players[p];
+    for (int p = 0; p < server.capacity.players; p++) {
+        if (!room->game_state.players[p].active || !room->game_state.players[p].alive) continue;
+        NetworkPlayer *player = &room->game_state.players[p];
 
-        for (int e = 0; e < MAX_ENEMIES; e++) {
-            if (!server.game_state.enemies[e].active) continue;
+        int count = grid_query(&room->enemy_grid, player->x, player->y, PLAYER_WIDTH, PLAYER_HEIGHT,
+                               room->grid_candidates, server.capacity.enemies);
+        for (int c = 0; c < count; c++) {
+            int e = room->grid_candidates[c];
+            if (!room->game_state.enemies[e].active) continue;
 
             if (check_collision(player->x, player->y, PLAYER_WIDTH, PLAYER_HEIGHT,
-                              server.game_state.enemies[e].x, server.game_state.enemies[e].y, 
+                              room->game_state.enemies[e].x, room->game_state.enemies[e].y, 
                               ENEMY_WIDTH, ENEMY_HEIGHT)) {
                 player->health -= 20;
                 player->score += 10;
-                server.game_state.enemies[e].active = 0;
-                server.game_state.enemy_count--;
-                add_explosion(server.game_state.enemies[e].x, server.game_state.enemies[e].y);
+                despawn_enemy(room, room->game_state.enemies[e].id);
+                add_explosion(room, room->game_state.enemies[e].x, room->game_state.enemies[e].y);
 
                 if (player->health <= 0) {
-                    player->alive = 0;
-                    player->health = 0;
-                    player->respawn_time = current_time + RESPAWN_TIME;
-                    add_explosion(player->x, player->y);
-                    printf("[DEATH] Player %d killed by collision (Score: %d)\n", p, player->score);
+                    kill_player(room, p);
+                    room_log(room, "[DEATH] Player %d killed by collision (Score: %d)\n", p, player->score);
                 }
             }
         }
     }
 
-    // Check collisions: Enemy bullets vs Players
-    for (int i = 0; i < MAX_ENEMY_BULLETS; i++) {
-        if (!server.game_state.enemy_bullets[i].active) continue;
+    room->game_state.tick++;
 
-        for (int p = 0; p < MAX_PLAYERS; p++) {
-            if (!server.game_state.players[p].active || !server.game_state.players[p].alive) continue;
-            NetworkPlayer *player = &server.game_state.players[p];
+    // Remember the world this tick's snapshots show for later rewinds
+    rewind_record(&room->rewind, &room->game_state);
+}
 
-            if (check_collision(server.game_state.enemy_bullets[i].x, server.game_state.enemy_bullets[i].y, 
-                              BULLET_WIDTH, BULLET_HEIGHT,
-                              player->x, player->y, PLAYER_WIDTH, PLAYER_HEIGHT)) {
-                server.game_state.enemy_bullets[i].active = 0;
-                server.game_state.enemy_bullet_count--;
-                player->health -= 10;
+// Number of flat projectile slots, as numbered by ProjectileResync
+int projectile_slots(void) {
+    return server.capacity.players * server.capacity.bullets_per_player + server.capacity.enemy_bullets;
+}
 
-                if (player->health <= 0) {
-                    player->alive = 0;
-                    player->health = 0;
-                    player->respawn_time = current_time + RESPAWN_TIME;
-                    add_explosion(player->x, player->y);
-                    printf("[DEATH] Player %d killed by enemy fire (Score: %d)\n", p, player->score);
-                }
+// List live bullets from flat slot first on as spawns, at most max of them
+// Returns the count; *end is the slot the list stops before
+int collect_resync(Room *room, int first, int max, ProjectileEvent *out, int *end) {
+    int players = server.capacity.players;
+    int per_player = server.capacity.bullets_per_player;
+    int count = 0;
+
+    for (int row = first / per_player < players ? first / per_player : players; row <= players; row++) {
+        if (row < players && !room->game_state.players[row].active) continue;
+        const BulletSet *bullets = row < players ? &room->player_bullets[row] : &room->enemy_bullets;
+        int base = row * per_player;
+        int from = first > base ? first - base : 0;
+
+        // Whole rows go in dense order; the row the list stops in is walked
+        // in slot order so the range can end partway through it
+        int whole = from == 0 && count + bullets->count <= max;
+        for (int n = 0; n < (whole ? bullets->count : bullets->pool.capacity - from); n++) {
+            int i = whole ? n : bullets->pool.sparse[from + n];
+            if (i < 0) continue;
+            if (count == max) {
+                *end = base + from + n;
+                return count;
+            }
+            ProjectileEvent *event = &out[count++];
+            memset(event, 0, sizeof(ProjectileEvent));
+            event->type = PROJECTILE_SPAWN;
+            event->tick = room->game_state.tick;
+            event->owner = row < players ? row : PROJECTILE_OWNER_ENEMY;
+            event->slot = bullets_slot(bullets, i);
+            event->x = bullets->x[i];
+            event->y = bullets->y[i];
+            event->vx = bullets->vx[i];
+            event->vy = bullets->vy[i];
+        }
+    }
+    *end = projectile_slots();
+    return count;
+}
+
+// Collect the projectile events after sequence seen, oldest first
+// A client whose table is in sync only up to flat slot synced also gets the
+// next chunk of live bullets from there. One with no baseline, or whose
+// events have fallen out of the log, starts over from slot 0.
+int build_projectile_events(Room *room, int has_baseline, Uint32 seen, int synced, ProjectileResync *resync) {
+    Uint32 newest = room->projectiles.sequence;
+    int count = 0;
+    memset(resync, 0, sizeof(ProjectileResync));
+
+    if (has_baseline) {
+        Uint32 pending = newest - seen;
+        if (pending == 0 || (pending <= PROJECTILE_LOG_SIZE && projectile_log_get(&room->projectiles, seen + 1))) {
+            for (Uint32 seq = seen + 1; seq != newest + 1; seq++) {
+                room->event_batch[count++] = *projectile_log_get(&room->projectiles, seq);
             }
+            if (synced >= projectile_slots()) return count;
+            resync->first = synced;
+        }
+    }
+
+    resync->active = 1;
+    resync->spawns = collect_resync(room, resync->first, PROJECTILE_RESYNC_CHUNK,
+                                    &room->event_batch[count], &resync->end);
+    return count + resync->spawns;
+}
+
+// How much a client cares about an entity at (x, y): closer to its plane is better
+float relevance(Room *room, int client_id, float x, float y) {
+    const NetworkPlayer *self = &room->current.players[client_id];
+    float dx = x - self->x;
+    float dy = y - self->y;
+    float closeness = 1.0f - sqrtf(dx * dx + dy * dy) / WINDOW_WIDTH;
+    return 1.0f + (closeness > 0 ? closeness : 0);
+}
+
+int compare_candidates(const void *a, const void *b) {
+    float pa = ((const SendCandidate *)a)->priority;
+    float pb = ((const SendCandidate *)b)->priority;
+    return (pa < pb) - (pa > pb);
+}
+
+// Gather changed players and enemies, growing each one's priority accumulator
+int collect_candidates(Room *room, int client_id, const GameState *view) {
+    ClientInfo *client = &room->clients[client_id];
+    const GameState *current = &room->current;
+    int count = 0;
+
+    for (int p = 0; p < current->capacity.players; p++) {
+        int bits = codec_player_delta_bits(&view->players[p], &current->players[p]);
+        if (bits == 0) {
+            client->player_priority[p] = 0;
+            continue;
+        }
+
+        float gain = PRIORITY_PLAYER * relevance(room, client_id, current->players[p].x, current->players[p].y);
+        if (view->players[p].active != current->players[p].active) gain *= 4;
+        else if (view->players[p].health != current->players[p].health) gain *= 2;
+        if (p == client_id) gain += PRIORITY_SELF;
+        client->player_priority[p] += gain;
+
+        SendCandidate *candidate = &room->candidates[count++];
+        candidate->is_player = 1;
+        candidate->index = p;
+        candidate->bits = bits;
+        candidate->priority = client->player_priority[p];
+    }
+
+    for (int e = 0; e < current->capacity.enemies; e++) {
+        int bits = codec_enemy_delta_bits(&view->enemies[e], &current->enemies[e]);
+        if (bits == 0) {
+            client->enemy_priority[e] = 0;
+            continue;
         }
+
+        float gain = PRIORITY_ENEMY * relevance(room, client_id, current->enemies[e].x, current->enemies[e].y);
+        if (view->enemies[e].active != current->enemies[e].active || view->enemies[e].id != current->enemies[e].id) gain *= 4;
+        client->enemy_priority[e] += gain;
+
+        SendCandidate *candidate = &room->candidates[count++];
+        candidate->is_player = 0;
+        candidate->index = e;
+        candidate->bits = bits;
+        candidate->priority = client->enemy_priority[e];
     }
 
-    server.game_state.tick++;
+    return count;
 }
 
-void send_game_state() {
-    GameStatePacket pkt;
-    pkt.header.type = PACKET_GAME_STATE;
-    pkt.header.sequence = server.sequence++;
-    pkt.state = server.game_state;
+// Encode one client's snapshot within its byte budget
+// Returns the packet size in room->message, or -1 if nothing could be encoded
+int build_snapshot(Room *room, int client_id, GameStatePacket *pkt) {
+    ClientInfo *client = &room->clients[client_id];
+    const GameState *current = &room->current;
+    Uint32 tick = current->tick;
+
+    // Deltas are taken against what the client actually holds for its acked tick
+    Uint32 baseline_tick = client->acked_tick;
+    const GameState *baseline = NULL;
+    if (baseline_tick != 0 && tick - baseline_tick < SNAPSHOT_RING_SIZE) {
+        baseline = snapshot_ring_find(&client->views, baseline_tick);
+    }
+    if (!baseline) baseline_tick = 0;
+
+    pkt->header.type = PACKET_GAME_STATE;
+    pkt->header.player_id = client_id;
+    pkt->header.sequence = room->sequence++;
+    pkt->tick = tick;
+    pkt->baseline_tick = baseline_tick;
+    pkt->input_ack = client->inputs.applied_sequence;
+    pkt->compressed = 0;
+    reliable_collect(&client->reliable, SDL_GetTicks(), &pkt->reliable);
+
+    int overhead = codec_write_state_packet(room->message, MAX_MESSAGE_SIZE, pkt, room->payload, 0);
+    if (overhead < 0) return -1;
+    int remaining = client->congestion.budget - overhead;
+
+    // Projectile events must stay contiguous, so they are trimmed from the
+    // newest end to at most half the budget, after dropping any resync chunk
+    // riding along; a restart goes out whole, which its chunk size bounds
+    int synced = baseline ? client->view_synced[baseline_tick % SNAPSHOT_RING_SIZE] : 0;
+    Uint32 seen = baseline ? client->view_events[baseline_tick % SNAPSHOT_RING_SIZE] : 0;
+    ProjectileResync resync;
+    int event_count = build_projectile_events(room, baseline != NULL, seen, synced, &resync);
+    Uint32 last_sequence = room->projectiles.sequence;
+    int events_size = codec_write_projectile_events(room->event_data, MAX_MESSAGE_SIZE, tick, &resync,
+                                                    last_sequence, room->event_batch, event_count);
+    int restart = resync.active && resync.first == 0;
+    while (!restart && (events_size < 0 || events_size > remaining / 2)) {
+        if (resync.active) {
+            event_count -= resync.spawns;
+            resync.active = 0;
+            resync.spawns = 0;
+        } else if (event_count > 0) {
+            int size = events_size < 0 ? MAX_MESSAGE_SIZE : events_size;
+            int keep = remaining > 0 ? (int)((long long)event_count * (remaining / 2) / size) : 0;
+            if (keep >= event_count) keep = event_count - 1;
+            last_sequence -= event_count - keep;
+            event_count = keep;
+        } else {
+            break;
+        }
+        events_size = codec_write_projectile_events(room->event_data, MAX_MESSAGE_SIZE, tick, &resync,
+                                                    last_sequence, room->event_batch, event_count);
+    }
+    if (resync.active) synced = resync.end;
+    if (events_size < 0) return -1;
+    remaining -= events_size;
+
+    // Start the client's new view from its baseline, then admit entity
+    // updates in priority order while they fit
+    GameState *view = snapshot_ring_claim(&client->views, tick);
+    size_t players_size = sizeof(NetworkPlayer) * current->capacity.players;
+    size_t enemies_size = sizeof(NetworkEnemy) * current->capacity.enemies;
+    game_state_copy(view, current);
+    if (baseline) {
+        memcpy(view->players, baseline->players, players_size);
+        memcpy(view->enemies, baseline->enemies, enemies_size);
+    } else {
+        memset(view->players, 0, players_size);
+        memset(view->enemies, 0, enemies_size);
+    }
+
+    int fixed_size = codec_write_state(room->payload, MAX_MESSAGE_SIZE, baseline, view);
+    int bits_left = (remaining - fixed_size - 4) * 8;  // 4 bytes slack for presence lists
+
+    int candidate_count = collect_candidates(room, client_id, view);
+    qsort(room->candidates, candidate_count, sizeof(SendCandidate), compare_candidates);
+    for (int i = 0; i < candidate_count; i++) {
+        SendCandidate *candidate = &room->candidates[i];
+        if (candidate->bits > bits_left) {
+            room->updates_deferred++;
+            continue;
+        }
+        bits_left -= candidate->bits;
+        if (candidate->is_player) {
+            view->players[candidate->index] = current->players[candidate->index];
+            client->player_priority[candidate->index] = 0;
+        } else {
+            view->enemies[candidate->index] = current->enemies[candidate->index];
+            client->enemy_priority[candidate->index] = 0;
+        }
+    }
+
+    // Clients reconcile their prediction against their own player, so the
+    // input ack only holds if that player went out up to date
+    if (codec_player_delta_bits(&view->players[client_id], &current->players[client_id]) != 0) {
+        pkt->input_ack = 0;
+    }
+
+    int state_size = codec_write_state(room->payload, MAX_MESSAGE_SIZE, baseline, view);
+    if (state_size < 0 || state_size + events_size > MAX_MESSAGE_SIZE) {
+        room_log(room, "[WARNING] Snapshot %u exceeds the largest fragmented message\n", tick);
+        return -1;
+    }
+    memcpy(room->payload + state_size, room->event_data, events_size);
+
+    client->view_events[tick % SNAPSHOT_RING_SIZE] = last_sequence;
+    client->view_synced[tick % SNAPSHOT_RING_SIZE] = synced;
+    snapshot_ring_commit(&client->views, tick);
+
+    const Uint8 *payload = room->payload;
+    int payload_size = state_size + events_size;
+    if (server.train_model && room->index == 0) compress_train(payload, payload_size);
+
+    // Range code the payload when the client supports it and it helps
+    if (client->compression == COMPRESSION_RANGE) {
+        Uint64 start = SDL_GetPerformanceCounter();
+        int compressed_size = compress_encode(payload, payload_size, room->compressed, MAX_MESSAGE_SIZE);
+        room->compress_ticks += SDL_GetPerformanceCounter() - start;
+        room->compress_raw_bytes += payload_size;
+        if (compressed_size > 0) {
+            payload = room->compressed;
+            payload_size = compressed_size;
+            pkt->compressed = 1;
+        }
+        room->compress_bytes += payload_size;
+    }
 
-    memcpy(server.packet->data, &pkt, sizeof(GameStatePacket));
-    server.packet->len = sizeof(GameStatePacket);
+    return codec_write_state_packet(room->message, MAX_MESSAGE_SIZE, pkt, payload, payload_size);
+}
 
-    // Send to all active clients
-    for (int i = 0; i < MAX_PLAYERS; i++) {
-        if (server.clients[i].active) {
-            server.packet->address = server.clients[i].address;
-            SDLNet_UDP_Send(server.socket, -1, server.packet);
+// ticks: simulation ticks run since the previous call, paid for by one snapshot
+void send_game_state(Room *room, int ticks) {
+    room->game_state.enemy_count = room->enemy_pool.count;
+    room->game_state.enemy_bullet_count = room->enemy_bullets.count;
+    game_state_copy(&room->current, &room->game_state);
+    delta_canonicalize(&room->current);
+
+    // Send to every active client whose send rate allows a snapshot this tick
+    Uint32 now = SDL_GetTicks();
+    for (int i = 0; i < server.capacity.players; i++) {
+        if (!room->clients[i].active) continue;
+        congestion_update(&room->clients[i].congestion, now);
+        if (!congestion_should_send(&room->clients[i].congestion, ticks)) continue;
+
+        GameStatePacket pkt;
+        int size = build_snapshot(room, i, &pkt);
+        if (size < 0) continue;
+
+        // Split into MTU-sized fragments when the snapshot is too large for one datagram
+        int datagrams = fragment_send(room->outbox, &room->clients[i].address,
+                                      i, pkt.header.sequence, room->message, size);
+        if (datagrams == 0) {
+            room->messages_dropped++;
+            continue;
         }
+        congestion_on_sent(&room->clients[i].congestion, pkt.tick, now);
+
+        room->clients[i].snapshots++;
+        room->snapshots_sent++;
+        room->snapshot_bytes_sent += size;
+        room->datagrams_sent += datagrams;
+        if (pkt.baseline_tick == 0) room->keyframes_sent++;
     }
 }
 
-void receive_packets() {
-    while (SDLNet_UDP_Recv(server.socket, server.packet)) {
-        PacketHeader *header = (PacketHeader *)server.packet->data;
+// Process the messages routed to this room since its last run, at the start of the run at now_ns
+// At most one inbox's worth is taken, so a flood arriving meanwhile waits
+// for the next run instead of stretching this one.
+void receive_packets(Room *room, Uint64 now_ns) {
+    for (Uint32 i = 0; i <= room->inbox.mask; i++) {
+        RoomMessage *message = ring_peek(&room->inbox);
+        if (!message) break;
 
-        switch (header->type) {
+        switch (message->header.type) {
             case PACKET_CONNECT:
-                handle_connect(&server.packet->address);
+                handle_connect(room, message->shard, &message->address, &message->connect);
                 break;
 
             case PACKET_INPUT: {
-                InputPacket *input_pkt = (InputPacket *)server.packet->data;
+                InputPacket *input_pkt = &message->input;
                 int pid = input_pkt->header.player_id;
-                if (pid >= 0 && pid < MAX_PLAYERS && server.clients[pid].active) {
-                    server.clients[pid].last_heard = SDL_GetTicks();
-                    process_player_input(pid, &input_pkt->input, 1.0f / TICK_RATE);
+                if (pid >= 0 && pid < server.capacity.players && room->clients[pid].active) {
+                    room->clients[pid].last_heard = message->received;
+                    reliable_receive(&room->clients[pid].reliable, &input_pkt->reliable);
+                    congestion_on_ack(&room->clients[pid].congestion, input_pkt->ack_tick,
+                                      input_pkt->ack_bits, input_pkt->ack_delay, message->received);
+                    if (input_pkt->ack_tick > room->clients[pid].acked_tick &&
+                        input_pkt->ack_tick <= room->game_state.tick) {
+                        room->clients[pid].acked_tick = input_pkt->ack_tick;
+                    }
+                    double view_tick = input_pkt->ack_tick ? input_pkt->ack_tick - input_pkt->view_lag / 8.0 : 0;
+                    input_buffer_push(&room->clients[pid].inputs, input_pkt->header.sequence,
+                                      input_pkt->inputs, input_pkt->input_count, view_tick, message->received);
+
+                    Uint64 wait = now_ns > message->received_ns ? now_ns - message->received_ns : 0;
+                    room->input_wait_ns += wait;
+                    if (wait > room->input_wait_max_ns) room->input_wait_max_ns = wait;
+                    room->inputs_taken++;
                 }
                 break;
             }
 
             case PACKET_DISCONNECT:
-                handle_disconnect(header->player_id);
+                handle_disconnect(room, message->header.player_id);
                 break;
 
             default:
                 break;
         }
+        ring_release(&room->inbox);
     }
 }
 
-void check_timeouts() {
+void check_timeouts(Room *room) {
     Uint32 current_time = SDL_GetTicks();
-    for (int i = 0; i < MAX_PLAYERS; i++) {
-        if (server.clients[i].active && 
-            current_time - server.clients[i].last_heard > 10000) {
-            printf("[TIMEOUT] Player %d timed out\n", i);
-            handle_disconnect(i);
+    for (int i = 0; i < server.capacity.players; i++) {
+        if (room->clients[i].active && 
+            current_time - room->clients[i].last_heard > 10000) {
+            room_log(room, "[TIMEOUT] Player %d timed out\n", i);
+            handle_disconnect(room, i);
+        } else if (room->clients[i].active && room->clients[i].stalled) {
+            // Reliable messages cannot be dropped, so a client that stopped
+            // acknowledging them has to go
+            room_log(room, "[TIMEOUT] Player %d stopped acknowledging reliable messages\n", i);
+            handle_disconnect(room, i);
         }
     }
 }
 
-void print_stats() {
-    static Uint32 last_print = 0;
+// Report a room's stats since the last report, elapsed_ms ago, and start new counts
+void print_stats(Room *room, Uint32 elapsed_ms) {
     Uint32 current = SDL_GetTicks();
+    room_log(room, "\n[STATS] Room %d | Tick: %u | Players: %d | Enemies: %d | Enemy Bullets: %d\n",
+           room->index,
+           room->game_state.tick, 
+           room->game_state.player_count,
+           room->enemy_pool.count,
+           room->enemy_bullets.count);
+
+    if (room->runs > 0) {
+        room_log(room, "  Load: %.1f%% of a core | Run: avg %.0f us, max %.0f us | Outbox drops: %u\n",
+               room->busy_ns / 1e4 / elapsed_ms,
+               room->busy_ns / 1e3 / room->runs,
+               room->busy_max_ns / 1e3,
+               room->messages_dropped);
+    }
+    room->messages_dropped = 0;
+    room->busy_ns = 0;
+    if (room->inputs_taken > 0) {
+        room_log(room, "  Input wait: avg %.0f us, max %.0f us before simulation | Inputs: %u\n",
+               room->input_wait_ns / 1e3 / room->inputs_taken, room->input_wait_max_ns / 1e3, room->inputs_taken);
+    }
+    room->input_wait_ns = 0;
+    room->input_wait_max_ns = 0;
+    room->inputs_taken = 0;
+    room->busy_max_ns = 0;
+    room->runs = 0;
+
+    if (room->snapshots_sent > 0) {
+        room_log(room, "  Snapshots: %u sent | Avg size: %u bytes | Keyframes: %u | Datagrams: %u | Deferred: %u\n",
+               room->snapshots_sent,
+               room->snapshot_bytes_sent / room->snapshots_sent,
+               room->keyframes_sent,
+               room->datagrams_sent,
+               room->updates_deferred);
+    }
+
+    Uint32 events_sent = 0, events_resent = 0;
+    for (int i = 0; i < server.capacity.players; i++) {
+        if (!room->clients[i].active) continue;
+        events_sent += room->clients[i].reliable.messages_sent;
+        events_resent += room->clients[i].reliable.messages_resent;
+        room->clients[i].reliable.messages_sent = 0;
+        room->clients[i].reliable.messages_resent = 0;
+    }
+    if (events_sent > 0) {
+        room_log(room, "  Reliable events: %u sent | %u resent\n", events_sent, events_resent);
+    }
+
+    if (room->hits > 0) {
+        room_log(room, "  Hits: %u | Lag-compensated: %u (avg rewind %.0f ms)\n",
+               room->hits, room->rewound_hits,
+               room->rewound_hits ? room->rewound_ticks * 1000.0f / server.tick_rate / room->rewound_hits : 0.0f);
+        room->hits = 0;
+        room->rewound_hits = 0;
+        room->rewound_ticks = 0;
+    }
+
+    SpatialGrid *grid = &room->enemy_grid;
+    if (grid->queries > 0) {
+        room_log(room, "  Broadphase: %u queries | %.2f candidates/query | %u cell changes\n",
+               grid->queries, (float)grid->candidates / grid->queries, grid->relinks);
+    }
+    grid->queries = 0;
+    grid->candidates = 0;
+    grid->relinks = 0;
+
+    room_log(room, "  Timers: %d pending | %u fired | %u cascaded\n",
+           room->timers.pool.count, room->timers.fired, room->timers.cascaded);
+    room->timers.fired = 0;
+    room->timers.cascaded = 0;
+
+    if (room->projectile_ticks > 0) {
+        int live = room->enemy_bullets.count;
+        for (int i = 0; i < server.capacity.players; i++) live += room->player_bullets[i].count;
+        room_log(room, "  Projectiles: %d live | %.2f us/tick (%s kernels)\n",
+               live, room->projectile_ns / 1e3 / room->projectile_ticks,
+               bullets_kernel_name(server.bullet_kernel));
+        room->projectile_ns = 0;
+        room->projectile_ticks = 0;
+    }
+
+    if (room->compress_raw_bytes > 0) {
+        room_log(room, "  Compression: %u -> %u payload bytes (%.1f%% saved) | Encode: %.2f us/snapshot\n",
+               room->compress_raw_bytes,
+               room->compress_bytes,
+               100.0 * (room->compress_raw_bytes - room->compress_bytes) / room->compress_raw_bytes,
+               1e6 * room->compress_ticks / SDL_GetPerformanceFrequency() / room->snapshots_sent);
+    }
+
+    room->compress_raw_bytes = 0;
+    room->compress_bytes = 0;
+    room->compress_ticks = 0;
+    room->snapshots_sent = 0;
+    room->snapshot_bytes_sent = 0;
+    room->keyframes_sent = 0;
+    room->datagrams_sent = 0;
+    room->updates_deferred = 0;
     
-    if (current - last_print > 5000) {
-        printf("\n[STATS] Tick: %u | Players: %d | Enemies: %d | Enemy Bullets: %d\n", 
-               server.game_state.tick, 
-               server.game_state.player_count,
-               server.game_state.enemy_count,
-               server.game_state.enemy_bullet_count);
-        
-        for (int i = 0; i < MAX_PLAYERS; i++) {
-            if (server.game_state.players[i].active) {
-                printf("  Player %d: Score=%d HP=%d %s\n", 
-                       i, 
-                       server.game_state.players[i].score,
-                       server.game_state.players[i].health,
-                       server.game_state.players[i].alive ? "ALIVE" : "DEAD");
+    for (int i = 0; i < server.capacity.players; i++) {
+        if (room->game_state.players[i].active) {
+            room_log(room, "  Player %d: Score=%d HP=%d %s\n", 
+                   i, 
+                   room->game_state.players[i].score,
+                   room->game_state.players[i].health,
+                   room->game_state.players[i].alive ? "ALIVE" : "DEAD");
+        }
+        if (room->clients[i].active) {
+            CongestionControl *cc = &room->clients[i].congestion;
+            room_log(room, "    Link: %.1f Hz (sent %.1f Hz, max %d) | Budget: %d bytes | RTT: %.0f ms (min %.0f) | Loss: %.1f%% | Backoffs: %u\n",
+                   cc->send_rate, room->clients[i].snapshots * 1000.0f / elapsed_ms, server.send_rate,
+                   cc->budget, cc->srtt, cc->min_rtt, cc->loss * 100, cc->decreases);
+            cc->decreases = 0;
+            room->clients[i].snapshots = 0;
+
+            InputBuffer *inputs = &room->clients[i].inputs;
+            room_log(room, "    Input: lead %d (target %d, jitter %.1f ms) | Applied: %u | Repeated: %u | Held: %u | Trimmed: %u | Late: %u | Duplicates: %u\n",
+                   input_buffer_lead(inputs, current), inputs->target_depth, inputs->jitter,
+                   inputs->applied, inputs->repeated, inputs->held, inputs->trimmed,
+                   inputs->late, inputs->duplicates);
+            inputs->applied = 0;
+            inputs->repeated = 0;
+            inputs->held = 0;
+            inputs->trimmed = 0;
+            inputs->late = 0;
+            inputs->duplicates = 0;
+        }
+    }
+}
+
+// Keep the calling thread on one core, so its rooms stay in that core's caches
+int pin_to_cpu(int cpu) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return 0;
+#endif
+}
+
+// One worker wake-up for a room at now_ns: its messages, the ticks due, snapshots and timeouts
+// An empty room only listens; its world stays paused until someone joins
+void run_room(Room *room, int due, Uint64 now_ns) {
+    receive_packets(room, now_ns);
+    if (due > 0 && room->game_state.player_count > 0) {
+        for (int i = 0; i < due; i++) {
+            apply_player_inputs(room);
+            update_game_state(room, 1.0f / server.tick_rate);
+        }
+        send_game_state(room, due);
+    }
+    check_timeouts(room);
+}
+
+void print_worker_stats(Worker *worker) {
+    Uint32 now = SDL_GetTicks();
+    Uint32 elapsed = now - worker->last_stats;
+    if (elapsed < STATS_INTERVAL_MS) return;
+
+    int rooms = 0, playing = 0;
+    for (int r = worker->index; r < server.room_count; r += server.worker_count) {
+        rooms++;
+        if (server.rooms[r]->game_state.player_count > 0) playing++;
+    }
+
+    if (worker->cpu >= 0) worker_log(worker, "\n[WORKER %d] CPU %d", worker->index, worker->cpu);
+    else worker_log(worker, "\n[WORKER %d] Unpinned", worker->index);
+    worker_log(worker, " | Rooms: %d (%d playing) | Load: %.1f%% of a core", rooms, playing, worker->busy_ns / 1e4 / elapsed);
+    if (worker->wakes > 0) {
+        worker_log(worker, " | Wake: avg %.0f us, max %.0f us", worker->busy_ns / 1e3 / worker->wakes, worker->wake_max_ns / 1e3);
+    }
+    if (worker->log_dropped > 0) worker_log(worker, " | Log drops: %u", worker->log_dropped);
+    worker_log(worker, "\n");
+    worker->log_dropped = 0;
+
+    TickScheduler *scheduler = &worker->scheduler;
+    if (scheduler->ticks > 0) {
+        worker_log(worker, "  Tick timing: %.2f Hz (target %d) | Late: avg %.0f us, max %.0f us | Interval: %.2f-%.2f ms | Caught up: %u | Dropped: %u\n",
+               tick_scheduler_rate(scheduler), server.tick_rate,
+               scheduler->lateness_sum_ns / 1e3 / scheduler->ticks,
+               scheduler->lateness_max_ns / 1e3,
+               scheduler->interval_min_ns / 1e6,
+               scheduler->interval_max_ns / 1e6,
+               scheduler->caught_up, scheduler->dropped);
+        tick_scheduler_reset_stats(scheduler);
+    }
+
+    // Idle rooms would only repeat the same empty block
+    for (int r = worker->index; r < server.room_count; r += server.worker_count) {
+        Room *room = server.rooms[r];
+        if (room->game_state.player_count > 0) {
+            print_stats(room, elapsed);
+        } else {
+            room->busy_ns = 0;
+            room->busy_max_ns = 0;
+            room->runs = 0;
+            room->messages_dropped = 0;
+            room->input_wait_ns = 0;
+            room->input_wait_max_ns = 0;
+            room->inputs_taken = 0;
+        }
+    }
+
+    // Room 0 lives on worker 0. The file is written by the flushing shard,
+    // from counts saved once it has written the previous ones
+    if (server.train_model && worker->index == 0 && !atomic_load(&worker->model_saved)) {
+        compress_save_training();
+        atomic_store(&worker->model_saved, 1);
+    }
+
+    worker->busy_ns = 0;
+    worker->wake_max_ns = 0;
+    worker->wakes = 0;
+    worker->last_stats = now;
+}
+
+// Whether a shard has queued messages for any of a worker's rooms
+int worker_has_messages(Worker *worker) {
+    for (int r = worker->index; r < server.room_count; r += server.worker_count) {
+        if (ring_peek(&server.rooms[r]->inbox)) return 1;
+    }
+    return 0;
+}
+
+// Sleep until the worker's next tick is due
+// With no room playing there is nothing to tick, so it sleeps until a
+// shard queues a message; the rooms then take it in without ticking, and
+// ticking restarts from that moment if someone joined.
+// Returns the ticks to simulate, 0 after an idle wake-up.
+int worker_wait(Worker *worker, int playing) {
+    TickScheduler *scheduler = &worker->scheduler;
+    if (!playing) {
+        // Pairs with the fence in wake_worker: either this sees the
+        // message, or the shard sees idle set and wakes us
+        atomic_store(&worker->idle, 1);
+        atomic_thread_fence(memory_order_seq_cst);
+        if (!worker_has_messages(worker)) {
+            reactor_arm(&worker->reactor, 0);
+            while (atomic_load(&worker->idle) && SDL_AtomicGet(&server.running)) reactor_wait(&worker->reactor);
+        }
+        atomic_store(&worker->idle, 0);
+        tick_scheduler_restart(scheduler);
+        return 0;
+    }
+
+    // Stray wake-ups from an idle spell end early; sleep again
+    for (;;) {
+        Uint64 now = clock_now_ns();
+        if (now >= scheduler->next_ns) return tick_scheduler_advance(scheduler, now);
+        reactor_arm(&worker->reactor, scheduler->next_ns);
+        reactor_wait(&worker->reactor);
+    }
+}
+
+// Worker thread: builds its rooms, then runs them all on every tick
+// Rooms are dealt out round-robin, and clients fill rooms in order, so
+// busy rooms spread evenly across the workers
+int worker_main(void *data) {
+    Worker *worker = data;
+    if (worker->cpu >= 0 && !pin_to_cpu(worker->cpu)) worker->cpu = -1;
+
+    arena_init(&worker->arena, 0);
+    int rooms = (server.room_count - worker->index + server.worker_count - 1) / server.worker_count;
+    int queued = rooms * server.capacity.players * OUTBOX_PER_PLAYER;
+    if (queued < OUTBOX_MIN) queued = OUTBOX_MIN;
+    if (queued > OUTBOX_MAX) queued = OUTBOX_MAX;
+    // Enough for a stats report with every room playing
+    int logged = rooms * (LOG_PER_ROOM + server.capacity.players * LOG_PER_PLAYER);
+    if (logged < LOG_QUEUE_MIN) logged = LOG_QUEUE_MIN;
+    if (logged > LOG_QUEUE_MAX) logged = LOG_QUEUE_MAX;
+    if (!ring_init(&worker->outbox, queued, sizeof(NetDatagram), RING_SINGLE_PRODUCER, &worker->arena) ||
+        !ring_init(&worker->route_changes, ROUTE_CHANGE_QUEUE, sizeof(RouteChange), RING_SINGLE_PRODUCER, &worker->arena) ||
+        !ring_init(&worker->log, logged, sizeof(LogLine), RING_SINGLE_PRODUCER, &worker->arena)) {
+        printf("Failed to allocate worker %d queues\n", worker->index);
+        exit(1);
+    }
+    for (int r = worker->index; r < server.room_count; r += server.worker_count) {
+        server.rooms[r] = create_room(worker, r);
+        if (!server.rooms[r]) {
+            printf("Failed to allocate room %d\n", r);
+            exit(1);
+        }
+    }
+    SDL_SemPost(server.ready);
+
+    tick_scheduler_init(&worker->scheduler, server.tick_rate);
+    worker->last_stats = SDL_GetTicks();
+    int playing = 0;
+    while (SDL_AtomicGet(&server.running)) {
+        // Every tick advances the world by exactly 1 / tick_rate; after an
+        // overrun the missed ticks run back-to-back and one snapshot covers them.
+        // Snapshots go out at the send rate, independently of the tick rate
+        int due = worker_wait(worker, playing);
+
+        Uint64 wake = clock_now_ns();
+        playing = 0;
+        for (int r = worker->index; r < server.room_count; r += server.worker_count) {
+            Room *room = server.rooms[r];
+            Uint64 start = clock_now_ns();
+            run_room(room, due, wake);
+            Uint64 elapsed = clock_now_ns() - start;
+            room->busy_ns += elapsed;
+            if (elapsed > room->busy_max_ns) room->busy_max_ns = elapsed;
+            room->runs++;
+            worker->busy_ns += elapsed;
+            if (room->game_state.player_count > 0) playing++;
+        }
+        Uint64 wake_ns = clock_now_ns() - wake;
+        if (wake_ns > worker->wake_max_ns) worker->wake_max_ns = wake_ns;
+        worker->wakes++;
+        print_worker_stats(worker);
+
+        // The deadline and log position go out before the count, so a shard
+        // that sees this wake-up finished also sees when the next one starts
+        // and writes all of its log
+        atomic_store(&worker->wake_ns, wake_ns);
+        atomic_store(&worker->next_ns, playing ? worker->scheduler.next_ns : 0);
+        atomic_store(&worker->logged, atomic_load(&worker->log.head));
+        atomic_fetch_add(&worker->done, 1);
+    }
+
+    arena_free(&worker->arena);
+    return 0;
+}
+
+// Wake a worker sleeping with every room empty, after queueing a message for one
+// The shard that flushes the worker is woken too, since with the worker
+// idle it has no deadline to wake for.
+void wake_worker(Shard *shard, Worker *worker) {
+    // Pairs with the fence in worker_wait
+    atomic_thread_fence(memory_order_seq_cst);
+    if (!atomic_load_explicit(&worker->idle, memory_order_relaxed) || !atomic_exchange(&worker->idle, 0)) return;
+
+    atomic_store(&worker->next_ns, clock_now_ns());
+    reactor_wake(&worker->reactor);
+    Shard *flusher = &server.shards[worker->index % server.shard_count];
+    if (flusher != shard) reactor_wake(&flusher->reactor);
+}
+
+// Decode a datagram received by a shard and hand it to the room its sender plays in
+// A connect from an unknown address is given a place in the first room
+// with one free, so matches fill up rather than spreading thin. Decoding
+// here keeps the parsing cost of a burst on the shard, off the room's tick.
+// received and received_ns are when the datagram's batch was read.
+void route_packet(Shard *shard, UDPpacket *packet, Uint32 received, Uint64 received_ns) {
+    RoomMessage message;
+    if (!codec_read_header(packet->data, packet->len, &message.header)) return;
+
+    int is_connect = 0;
+    switch (message.header.type) {
+        case PACKET_CONNECT:
+            is_connect = codec_read_connect(packet->data, packet->len, &message.connect);
+            if (!is_connect) return;
+            break;
+        case PACKET_INPUT:
+            if (!codec_read_input(packet->data, packet->len, &message.input)) return;
+            break;
+        case PACKET_DISCONNECT:
+            break;
+        default:
+            return;
+    }
+    message.address = packet->address;
+    message.shard = shard->index;
+    message.received = received;
+    message.received_ns = received_ns;
+
+    SDL_LockMutex(shard->routes_lock);
+    int index = route_find(&shard->routes, &packet->address);
+    if (index == ROUTE_NONE && is_connect) {
+        SDL_LockMutex(server.rooms_lock);
+        for (int r = 0; r < server.room_count; r++) {
+            if (server.room_players[r] < server.capacity.players) {
+                index = r;
+                break;
+            }
+        }
+        if (index != ROUTE_NONE && route_add(&shard->routes, &packet->address, index)) {
+            server.room_players[index]++;
+        } else {
+            index = ROUTE_NONE;
+        }
+        SDL_UnlockMutex(server.rooms_lock);
+    }
+    SDL_UnlockMutex(shard->routes_lock);
+
+    if (index == ROUTE_NONE) {
+        if (is_connect) {
+            packet->len = write_connect_response(packet->data, packet->maxlen, 0, -1, COMPRESSION_NONE);
+            net_socket_send(&shard->socket, packet);
+            shard->rejected++;
+        } else {
+            shard->unrouted++;
+        }
+        return;
+    }
+
+    Ring *inbox = &server.rooms[index]->inbox;
+    Uint32 position;
+    RoomMessage *entry = ring_claim(inbox, &position);
+    if (!entry) {
+        shard->dropped++;
+        return;
+    }
+    *entry = message;
+    ring_publish(inbox, position);
+    shard->routed++;
+    wake_worker(shard, &server.workers[index % server.worker_count]);
+}
+
+// Write what a worker logged up to the end of its last finished wake-up
+// Stopping there keeps a stats report whole; the lock keeps other
+// threads' lines out of it.
+void write_worker_log(Worker *worker) {
+    Uint32 logged = atomic_load(&worker->logged);
+    int saved = atomic_load(&worker->model_saved);
+    if (worker->log.tail == logged && !saved) return;
+
+    SDL_LockMutex(server.stats_lock);
+    while (worker->log.tail != logged) {
+        LogLine *line = ring_peek(&worker->log);
+        fputs(line->text, stdout);
+        ring_release(&worker->log);
+    }
+    if (saved) {
+        FILE *model = fopen("network_compress_model.h", "w");
+        if (model) {
+            compress_print_model(model);
+            fclose(model);
+            printf("  Compression model written to network_compress_model.h\n");
+        }
+        atomic_store(&worker->model_saved, 0);
+    }
+    SDL_UnlockMutex(server.stats_lock);
+}
+
+// Send what this shard's workers queued and apply their route changes
+// Worker w is drained by shard w % shard_count, so each queue has exactly
+// one consumer. Datagrams go out straight from the queue slots, a batch
+// per system call. Returns the number of datagrams sent.
+int flush_workers(Shard *shard) {
+    int sent = 0;
+    for (int w = shard->index; w < server.worker_count; w += server.shard_count) {
+        Worker *worker = &server.workers[w];
+        // Read before draining, so everything that wake-up queued is taken
+        Uint32 done = atomic_load(&worker->done);
+
+        RouteChange *change;
+        while ((change = ring_peek(&worker->route_changes))) {
+            apply_route_change(change);
+            ring_release(&worker->route_changes);
+        }
+
+        NetDatagram *queued[NET_BATCH_SIZE];
+        NetDatagram *batch[NET_BATCH_SIZE];
+        int count;
+        while ((count = ring_peek_batch(&worker->outbox, (void **)queued, shard->outgoing.count)) > 0) {
+            int filled = 0;
+            for (int i = 0; i < count; i++) {
+                if (queued[i]->len > 0) batch[filled++] = queued[i];
             }
+            if (filled > 0) sent += net_socket_send_batch(&shard->socket, &shard->outgoing, batch, filled);
+            ring_release_batch(&worker->outbox, count);
+        }
+
+        write_worker_log(worker);
+        worker->flushed = done;
+    }
+    return sent;
+}
+
+// When this shard should next flush its workers, 0 if none of them is ticking
+// A worker's datagrams are ready once the wake-up it starts at next_ns has
+// run, which should take about as long as its last one did. A worker still
+// running past that is checked again every FLUSH_RETRY_NS.
+Uint64 next_flush(Shard *shard) {
+    Uint64 now = clock_now_ns();
+    Uint64 next = 0;
+    for (int w = shard->index; w < server.worker_count; w += server.shard_count) {
+        Worker *worker = &server.workers[w];
+        if (atomic_load(&worker->done) != worker->flushed) return now;
+
+        Uint64 start = atomic_load(&worker->next_ns);
+        if (!start) continue;
+        Uint64 ready = start + atomic_load(&worker->wake_ns);
+        if (ready <= now) ready = now + FLUSH_RETRY_NS;
+        if (!next || ready < next) next = ready;
+    }
+    return next;
+}
+
+void print_shard_stats(Shard *shard) {
+    Uint32 now = SDL_GetTicks();
+    Uint32 elapsed = now - shard->last_stats;
+    if (elapsed < STATS_INTERVAL_MS) return;
+
+    SDL_LockMutex(shard->routes_lock);
+    int clients = shard->routes.count;
+    SDL_UnlockMutex(shard->routes_lock);
+    if (clients > 0 || shard->routed > 0 || shard->sent > 0 || shard->unrouted > 0 || shard->rejected > 0) {
+        SDL_LockMutex(server.stats_lock);
+        if (shard->cpu >= 0) printf("\n[SHARD %d] CPU %d", shard->index, shard->cpu);
+        else printf("\n[SHARD %d] Unpinned", shard->index);
+        printf(" | Clients: %d | Routed: %u (%.0f/s) | Sent: %u (%.0f/s) | Unrouted: %u | Rejected: %u | Inbox drops: %u\n",
+               clients, shard->routed, shard->routed * 1000.0f / elapsed,
+               shard->sent, shard->sent * 1000.0f / elapsed,
+               shard->unrouted, shard->rejected, shard->dropped);
+        NetSocket *socket = &shard->socket;
+        printf("  Syscalls: %u receive (%.1f datagrams each) | %u send (%.1f datagrams each) | Offload: %s\n",
+               socket->receive_calls, socket->receive_calls ? (float)shard->received / socket->receive_calls : 0.0f,
+               socket->send_calls, socket->send_calls ? (float)shard->sent / socket->send_calls : 0.0f,
+               socket->gso ? "on" : "off");
+        SDL_UnlockMutex(server.stats_lock);
+    }
+    shard->routed = 0;
+    shard->unrouted = 0;
+    shard->rejected = 0;
+    shard->received = 0;
+    shard->socket.receive_calls = 0;
+    shard->socket.send_calls = 0;
+    shard->dropped = 0;
+    shard->sent = 0;
+    shard->last_stats = now;
+}
+
+// Shard thread: the network I/O for its socket and its share of the workers
+// It sleeps in its reactor until its socket has datagrams, which it routes
+// at once, or until its workers' datagrams should be ready, which it sends.
+// Workers never wake it, since that would take a system call on their
+// tick; their published deadlines tell it when to look. A shard with no
+// traffic and no ticking workers sleeps without a timeout.
+int shard_main(void *data) {
+    Shard *shard = data;
+    if (shard->cpu >= 0 && !pin_to_cpu(shard->cpu)) shard->cpu = -1;
+
+    shard->last_stats = SDL_GetTicks();
+    while (SDL_AtomicGet(&server.running)) {
+        int events = reactor_wait(&shard->reactor);
+        if (events & REACTOR_READABLE) {
+            // A short batch means the socket is drained, so no call is spent finding that out
+            int count;
+            do {
+                count = net_socket_recv_batch(&shard->socket, &shard->incoming);
+                Uint32 received = SDL_GetTicks();
+                Uint64 received_ns = clock_now_ns();
+                for (int i = 0; i < count; i++) route_packet(shard, &shard->incoming.packets[i], received, received_ns);
+                if (count > 0) shard->received += count;
+            } while (count == shard->incoming.count);
         }
-        last_print = current;
+
+        shard->sent += flush_workers(shard);
+        reactor_arm(&shard->reactor, next_flush(shard));
+        print_shard_stats(shard);
+    }
+    return 0;
+}
+
+void init_server() {
+    if (SDLNet_Init() < 0) {
+        printf("SDLNet_Init failed: %s\n", SDLNet_GetError());
+        exit(1);
+    }
+
+    Arena *arena = &server.arena;
+    arena_init(arena, 0);
+    NetSocket sockets[MAX_SHARDS];
+    server.shard_count = net_socket_open_shards(sockets, server.shard_count, SERVER_PORT, &server.steer);
+    if (server.shard_count == 0) {
+        printf("Failed to open port %d: %s\n", SERVER_PORT, net_socket_error());
+        exit(1);
+    }
+
+    // Any shard may end up with every client, so each route table holds them all
+    server.shards = arena_alloc(arena, sizeof(Shard) * server.shard_count);
+    for (int i = 0; server.shards && i < server.shard_count; i++) {
+        Shard *shard = &server.shards[i];
+        shard->index = i;
+        shard->socket = sockets[i];
+        shard->routes_lock = SDL_CreateMutex();
+        if (!reactor_init(&shard->reactor, &shard->socket) ||
+            !net_batch_init(&shard->incoming, NET_BATCH_SIZE, MAX_PACKET_SIZE, arena) ||
+            !net_batch_init(&shard->outgoing, NET_BATCH_SIZE, 0, arena) || !shard->routes_lock ||
+            !route_table_init(&shard->routes, server.room_count * server.capacity.players, arena)) {
+            printf("Failed to allocate shard %d\n", i);
+            exit(1);
+        }
+    }
+
+    server.rooms = arena_alloc(arena, sizeof(Room *) * server.room_count);
+    server.room_players = arena_alloc(arena, sizeof(int) * server.room_count);
+    server.workers = arena_alloc(arena, sizeof(Worker) * server.worker_count);
+    server.rooms_lock = SDL_CreateMutex();
+    server.stats_lock = SDL_CreateMutex();
+    server.ready = SDL_CreateSemaphore(0);
+    if (!server.shards || !server.rooms || !server.room_players || !server.workers ||
+        !server.rooms_lock || !server.stats_lock || !server.ready) {
+        printf("Failed to allocate server storage\n");
+        exit(1);
+    }
+    server.bullet_kernel = bullets_select_kernel(server.bullet_kernel);
+
+    SDL_AtomicSet(&server.running, 1);
+    int cpus = SDL_GetCPUCount();
+    for (int w = 0; w < server.worker_count; w++) {
+        Worker *worker = &server.workers[w];
+        worker->index = w;
+        worker->cpu = server.pin_workers ? w % cpus : -1;
+        if (!reactor_init(&worker->reactor, NULL)) {
+            printf("Failed to set up worker %d: %s\n", w, net_socket_error());
+            exit(1);
+        }
+        worker->thread = SDL_CreateThread(worker_main, "room worker", worker);
+        if (!worker->thread) {
+            printf("SDL_CreateThread failed: %s\n", SDL_GetError());
+            exit(1);
+        }
+    }
+    for (int w = 0; w < server.worker_count; w++) SDL_SemWait(server.ready);
+
+    // Shard i shares a core with worker i; with CPU steering that is also
+    // the core whose packets the shard receives
+    for (int i = 0; i < server.shard_count; i++) {
+        Shard *shard = &server.shards[i];
+        shard->cpu = server.pin_workers ? i % cpus : -1;
+        shard->thread = SDL_CreateThread(shard_main, "shard", shard);
+        if (!shard->thread) {
+            printf("SDL_CreateThread failed: %s\n", SDL_GetError());
+            exit(1);
+        }
+    }
+
+    int pinned = 0;
+    for (int w = 0; w < server.worker_count; w++) pinned += server.workers[w].cpu >= 0;
+
+    const RoomCapacity *capacity = &server.capacity;
+    printf("========================================\n");
+    printf("  Flying Aces: 1942 - Server Started\n");
+    printf("========================================\n");
+    printf("Port: %d (%d socket%s, %s steering)\n", SERVER_PORT, server.shard_count,
+           server.shard_count == 1 ? "" : "s", net_steer_name(server.steer));
+    printf("Rooms: %d on %d worker thread%s (%d pinned to cores)\n",
+           server.room_count, server.worker_count, server.worker_count == 1 ? "" : "s", pinned);
+    printf("Room: %d players | %d enemies | %d bullets per player | %d enemy bullets | %.1f MB\n",
+           capacity->players, capacity->enemies, capacity->bullets_per_player, capacity->enemy_bullets,
+           server.rooms[0]->footprint / (1024.0 * 1024.0));
+    printf("Tick Rate: %d Hz (%d projectile substep%s)\n", server.tick_rate, server.substeps, server.substeps == 1 ? "" : "s");
+    printf("Send Rate: %d Hz\n", server.send_rate);
+    printf("Projectile Kernels: %s\n", bullets_kernel_name(server.bullet_kernel));
+    printf("Snapshot Budget: %d bytes\n", server.snapshot_budget);
+    printf("Compression: %s\n", server.compression_enabled ? "range coder" : "off");
+    printf("\nWaiting for players...\n");
+}
+
+void parse_args(int argc, char *argv[]) {
+    server.snapshot_budget = DEFAULT_SNAPSHOT_BUDGET;
+    server.compression_enabled = 1;
+    server.train_model = 0;
+    server.max_rewind_ms = DEFAULT_MAX_REWIND_MS;
+    server.tick_rate = TICK_RATE;
+    server.send_rate = 0;
+    server.substeps = 1;
+    server.bullet_kernel = BULLET_KERNEL_AVX2;
+    server.capacity.players = DEFAULT_PLAYERS;
+    server.capacity.bullets_per_player = DEFAULT_BULLETS_PER_PLAYER;
+    server.capacity.enemies = DEFAULT_ENEMIES;
+    server.capacity.enemy_bullets = DEFAULT_ENEMY_BULLETS;
+    server.capacity.explosions = DEFAULT_EXPLOSIONS;
+    server.room_count = 1;
+    server.worker_count = 0;
+    server.pin_workers = 1;
+    server.shard_count = 0;
+    server.steer = NET_STEER_KERNEL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--budget") == 0 && i + 1 < argc) {
+            server.snapshot_budget = atoi(argv[++i]);
+            if (server.snapshot_budget < 64) server.snapshot_budget = 64;
+        } else if (strcmp(argv[i], "--no-compression") == 0) {
+            server.compression_enabled = 0;
+        } else if (strcmp(argv[i], "--train-model") == 0) {
+            server.train_model = 1;
+        } else if (strcmp(argv[i], "--max-rewind") == 0 && i + 1 < argc) {
+            server.max_rewind_ms = atoi(argv[++i]);
+            if (server.max_rewind_ms < 0) server.max_rewind_ms = 0;
+        } else if (strcmp(argv[i], "--tick-rate") == 0 && i + 1 < argc) {
+            server.tick_rate = atoi(argv[++i]);
+            if (server.tick_rate < 1) server.tick_rate = 1;
+            if (server.tick_rate > MAX_TICK_RATE) server.tick_rate = MAX_TICK_RATE;
+        } else if (strcmp(argv[i], "--send-rate") == 0 && i + 1 < argc) {
+            server.send_rate = atoi(argv[++i]);
+            if (server.send_rate < 1) server.send_rate = 1;
+        } else if (strcmp(argv[i], "--substeps") == 0 && i + 1 < argc) {
+            server.substeps = atoi(argv[++i]);
+            if (server.substeps < 1) server.substeps = 1;
+        } else if (strcmp(argv[i], "--simd") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "scalar") == 0) server.bullet_kernel = BULLET_KERNEL_SCALAR;
+            else if (strcmp(argv[i], "sse2") == 0) server.bullet_kernel = BULLET_KERNEL_SSE2;
+            else server.bullet_kernel = BULLET_KERNEL_AVX2;
+        } else if (strcmp(argv[i], "--players") == 0 && i + 1 < argc) {
+            server.capacity.players = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--enemies") == 0 && i + 1 < argc) {
+            server.capacity.enemies = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--bullets") == 0 && i + 1 < argc) {
+            server.capacity.bullets_per_player = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--enemy-bullets") == 0 && i + 1 < argc) {
+            server.capacity.enemy_bullets = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--explosions") == 0 && i + 1 < argc) {
+            server.capacity.explosions = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--rooms") == 0 && i + 1 < argc) {
+            server.room_count = atoi(argv[++i]);
+            if (server.room_count < 1) server.room_count = 1;
+            if (server.room_count > MAX_ROOMS) server.room_count = MAX_ROOMS;
+        } else if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            server.worker_count = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--no-pin") == 0) {
+            server.pin_workers = 0;
+        } else if (strcmp(argv[i], "--shards") == 0 && i + 1 < argc) {
+            server.shard_count = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--steer") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "hash") == 0) server.steer = NET_STEER_HASH;
+            else if (strcmp(argv[i], "cpu") == 0) server.steer = NET_STEER_CPU;
+            else server.steer = NET_STEER_KERNEL;
+        } else {
+            printf("Usage: %s [--budget <bytes per snapshot>] [--no-compression] [--train-model] [--max-rewind <ms>]\n"
+                   "          [--tick-rate <Hz>] [--send-rate <Hz>] [--substeps <n>]\n"
+                   "          [--simd <scalar|sse2|avx2>]\n"
+                   "          [--players <n>] [--enemies <n>] [--bullets <per player>] [--enemy-bullets <n>]\n"
+                   "          [--explosions <n>] [--rooms <n>] [--workers <n>] [--no-pin]\n"
+                   "          [--shards <n>] [--steer <kernel|hash|cpu>]\n", argv[0]);
+            exit(1);
+        }
+    }
+
+    // Room capacities stay within what the protocol can address
+    RoomCapacity *capacity = &server.capacity;
+    if (capacity->players < 1) capacity->players = 1;
+    if (capacity->players > MAX_PLAYERS) capacity->players = MAX_PLAYERS;
+    if (capacity->enemies < 1) capacity->enemies = 1;
+    if (capacity->enemies > MAX_ENEMIES) capacity->enemies = MAX_ENEMIES;
+    if (capacity->bullets_per_player < 1) capacity->bullets_per_player = 1;
+    if (capacity->bullets_per_player > MAX_BULLETS_PER_PLAYER) capacity->bullets_per_player = MAX_BULLETS_PER_PLAYER;
+    if (capacity->enemy_bullets < 1) capacity->enemy_bullets = 1;
+    if (capacity->enemy_bullets > MAX_ENEMY_BULLETS) capacity->enemy_bullets = MAX_ENEMY_BULLETS;
+    if (capacity->explosions < 1) capacity->explosions = 1;
+    if (capacity->explosions > MAX_EXPLOSIONS) capacity->explosions = MAX_EXPLOSIONS;
+
+    // One worker per core by default, and never more workers than rooms
+    if (server.worker_count < 1) server.worker_count = SDL_GetCPUCount();
+    if (server.worker_count > server.room_count) server.worker_count = server.room_count;
+
+    // One receive socket per worker core by default
+    if (server.shard_count < 1) server.shard_count = server.worker_count;
+    if (server.shard_count > MAX_SHARDS) server.shard_count = MAX_SHARDS;
+
+    // Snapshots carry the latest tick, so sending faster than ticking gains nothing
+    if (server.send_rate == 0 || server.send_rate > server.tick_rate) server.send_rate = server.tick_rate;
+
+    // Low tick rates need more sub-steps to keep bullets from skipping targets
+    int needed = (MAX_CLOSING_SPEED + server.tick_rate * MAX_SUBSTEP_TRAVEL - 1) / (server.tick_rate * MAX_SUBSTEP_TRAVEL);
+    if (server.substeps < needed) server.substeps = needed;
+    if (server.substeps > MAX_SUBSTEPS) server.substeps = MAX_SUBSTEPS;
+
+    // The rewind window must stay inside the recorded history
+    if (server.max_rewind_ms > (REWIND_HISTORY - 2) * 1000 / server.tick_rate) {
+        server.max_rewind_ms = (REWIND_HISTORY - 2) * 1000 / server.tick_rate;
     }
 }
 
 int main(int argc, char *argv[]) {
-    srand(time(NULL));
+    parse_args(argc, argv);
     
     if (SDL_Init(0) < 0) {
         printf("SDL_Init failed: %s\n", SDL_GetError());
         return 1;
     }
 
+    // Model tables are built once, then shared read-only by every worker
+    compress_init();
     init_server();
 
-    Uint32 last_time = SDL_GetTicks();
-    Uint32 tick_interval = 1000 / TICK_RATE;
-
     printf("\n[SERVER READY] Waiting for connections...\n");
     printf("Press Ctrl+C to stop.\n\n");
 
-    while (server.running) {
-        Uint32 current_time = SDL_GetTicks();
-        float delta_time = (current_time - last_time) / 1000.0f;
-        if (delta_time > 0.1f) delta_time = 0.1f; // Cap delta
-
-        receive_packets();
-        update_game_state(delta_time);
-        send_game_state();
-        check_timeouts();
-        print_stats();
-
-        last_time = current_time;
-        
-        Uint32 frame_time = SDL_GetTicks() - current_time;
-        if (frame_time < tick_interval) {
-            SDL_Delay(tick_interval - frame_time);
-        }
-    }
+    // The shards receive and the workers simulate; this thread only waits
+    for (int i = 0; i < server.shard_count; i++) SDL_WaitThread(server.shards[i].thread, NULL);
 
     printf("\n[SHUTDOWN] Server closing...\n");
-    SDLNet_FreePacket(server.packet);
-    SDLNet_UDP_Close(server.socket);
+    SDL_AtomicSet(&server.running, 0);
+    for (int w = 0; w < server.worker_count; w++) {
+        reactor_wake(&server.workers[w].reactor);
+        SDL_WaitThread(server.workers[w].thread, NULL);
+        reactor_close(&server.workers[w].reactor);
+    }
+    for (int i = 0; i < server.shard_count; i++) {
+        reactor_close(&server.shards[i].reactor);
+        SDL_DestroyMutex(server.shards[i].routes_lock);
+        net_socket_close(&server.shards[i].socket);
+    }
     SDLNet_Quit();
+    SDL_DestroySemaphore(server.ready);
+    SDL_DestroyMutex(server.rooms_lock);
+    SDL_DestroyMutex(server.stats_lock);
+    arena_free(&server.arena);
     SDL_Quit();
 
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,410 @@
+#ifdef __linux__
+#define _GNU_SOURCE  // SO_REUSEPORT, SO_ATTACH_REUSEPORT_CBPF, recvmmsg, sendmmsg
+#endif
+#include <string.h>
+#ifdef __linux__
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <linux/filter.h>
+#endif
+#include "network_socket.h"
+
+#define SOCKET_BUFFER_SIZE (4 * 1024 * 1024)  // Kernel buffer per shard, enough for a burst from every room
+
+#ifdef __linux__
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103  // Linux 4.18; older headers lack it
+#endif
+#define GSO_MAX_SEGMENTS 64       // Kernel limit on datagrams per offload send
+#define GSO_MAX_BYTES 60000       // Stays under the 64 KB an offload send may carry
+#define GSO_CONTROL_SIZE CMSG_SPACE(sizeof(Uint16))
+
+struct NetBatchNative {
+    struct mmsghdr *messages;
+    struct iovec *vectors;          // One per datagram; an offload send spans several
+    struct sockaddr_in *addresses;
+    Uint8 *control;                 // GSO_CONTROL_SIZE per message
+    int *segments;                  // Datagrams in each message
+};
+#endif
+
+const char *net_steer_name(int steer) {
+    if (steer == NET_STEER_HASH) return "hash";
+    if (steer == NET_STEER_CPU) return "cpu";
+    return "kernel";
+}
+
+#ifdef __linux__
+
+const char *net_socket_error(void) {
+    return strerror(errno);
+}
+
+// Steering program for the whole reuseport group, run per datagram
+// Classic BPF sees the datagram from its UDP payload; negative offsets
+// reach back into the IP and UDP headers. The return value is the index of
+// the socket to use, in bind order; out of range values fall back to the
+// kernel's hash.
+static int attach_steering(int fd, int steer, int count) {
+    struct sock_filter hash[] = {
+        BPF_STMT(BPF_LDX | BPF_B | BPF_MSH, SKF_NET_OFF),        // X = IP header length
+        BPF_STMT(BPF_LD | BPF_H | BPF_IND, SKF_NET_OFF),         // A = UDP source port
+        BPF_STMT(BPF_ST, 0),
+        BPF_STMT(BPF_LD | BPF_W | BPF_ABS, SKF_NET_OFF + 12),    // A = IP source address
+        BPF_STMT(BPF_LDX | BPF_MEM, 0),
+        BPF_STMT(BPF_ALU | BPF_XOR | BPF_X, 0),
+        BPF_STMT(BPF_ALU | BPF_MUL | BPF_K, 2654435761u),
+        BPF_STMT(BPF_ALU | BPF_RSH | BPF_K, 16),
+        BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, (Uint32)count),
+        BPF_STMT(BPF_RET | BPF_A, 0),
+    };
+    struct sock_filter cpu[] = {
+        BPF_STMT(BPF_LD | BPF_W | BPF_ABS, SKF_AD_OFF + SKF_AD_CPU),
+        BPF_STMT(BPF_RET | BPF_A, 0),
+    };
+
+    struct sock_fprog program;
+    if (steer == NET_STEER_HASH) {
+        program.len = sizeof(hash) / sizeof(hash[0]);
+        program.filter = hash;
+    } else {
+        program.len = sizeof(cpu) / sizeof(cpu[0]);
+        program.filter = cpu;
+    }
+    return setsockopt(fd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &program, sizeof(program)) == 0;
+}
+
+static int open_native(Uint16 port, int reuse) {
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) return -1;
+
+    int one = 1;
+    int size = SOCKET_BUFFER_SIZE;
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+    setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+    if ((reuse && setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one)) < 0) ||
+        bind(fd, (struct sockaddr *)&address, sizeof(address)) < 0 ||
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK) < 0) {
+        int error = errno;
+        close(fd);
+        errno = error;
+        return -1;
+    }
+    return fd;
+}
+
+int net_socket_open_shards(NetSocket *sockets, int count, Uint16 port, int *steer) {
+    if (count > MAX_SHARDS) count = MAX_SHARDS;
+
+    // Sockets join the reuseport group in bind order, which is the index
+    // the steering program returns
+    for (int i = 0; i < count; i++) {
+        sockets[i].sdl = NULL;
+        sockets[i].sdl_set = NULL;
+        sockets[i].fd = open_native(port, count > 1);
+        if (sockets[i].fd < 0) {
+            while (--i >= 0) close(sockets[i].fd);
+            return 0;
+        }
+    }
+
+    if (*steer != NET_STEER_KERNEL && (count == 1 || !attach_steering(sockets[0].fd, *steer, count))) {
+        *steer = NET_STEER_KERNEL;
+    }
+
+    // Segmentation offload is per send, so it only needs the kernel to know the option
+    for (int i = 0; i < count; i++) {
+        int segment = 0;
+        socklen_t size = sizeof(segment);
+        sockets[i].gso = getsockopt(sockets[i].fd, SOL_UDP, UDP_SEGMENT, &segment, &size) == 0;
+        sockets[i].receive_calls = 0;
+        sockets[i].send_calls = 0;
+    }
+    return count;
+}
+
+int net_socket_wait(NetSocket *socket, int timeout_ms) {
+    struct pollfd poller;
+    poller.fd = socket->fd;
+    poller.events = POLLIN;
+    int ready = poll(&poller, 1, timeout_ms);
+    if (ready < 0) return errno == EINTR ? 0 : -1;
+    return ready > 0;
+}
+
+int net_socket_recv(NetSocket *socket, UDPpacket *packet) {
+    struct sockaddr_in from;
+    socklen_t from_size = sizeof(from);
+    socket->receive_calls++;
+    ssize_t size = recvfrom(socket->fd, packet->data, packet->maxlen, 0, (struct sockaddr *)&from, &from_size);
+    if (size < 0) return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR ? 0 : -1;
+
+    // Same byte order as SDL_net: both fields stay in network order
+    packet->len = (int)size;
+    packet->address.host = from.sin_addr.s_addr;
+    packet->address.port = from.sin_port;
+    return 1;
+}
+
+int net_socket_send(NetSocket *socket, const UDPpacket *packet) {
+    struct sockaddr_in to;
+    memset(&to, 0, sizeof(to));
+    to.sin_family = AF_INET;
+    to.sin_addr.s_addr = packet->address.host;
+    to.sin_port = packet->address.port;
+    socket->send_calls++;
+    return sendto(socket->fd, packet->data, packet->len, 0, (struct sockaddr *)&to, sizeof(to)) == packet->len;
+}
+
+int net_batch_init(NetBatch *batch, int count, int size, Arena *arena) {
+    if (count > NET_BATCH_SIZE) count = NET_BATCH_SIZE;
+    batch->count = count;
+    batch->packets = NULL;
+    batch->native = arena_alloc(arena, sizeof(struct NetBatchNative));
+    if (!batch->native) return 0;
+
+    struct NetBatchNative *native = batch->native;
+    native->messages = arena_alloc(arena, sizeof(struct mmsghdr) * count);
+    native->vectors = arena_alloc(arena, sizeof(struct iovec) * count);
+    native->addresses = arena_alloc(arena, sizeof(struct sockaddr_in) * count);
+    native->control = arena_alloc(arena, GSO_CONTROL_SIZE * count);
+    native->segments = arena_alloc(arena, sizeof(int) * count);
+    if (!native->messages || !native->vectors || !native->addresses || !native->control || !native->segments) return 0;
+
+    if (size > 0) {
+        Uint8 *storage = arena_alloc(arena, (size_t)size * count);
+        batch->packets = arena_alloc(arena, sizeof(UDPpacket) * count);
+        if (!storage || !batch->packets) return 0;
+        for (int i = 0; i < count; i++) {
+            batch->packets[i].channel = -1;
+            batch->packets[i].data = storage + (size_t)size * i;
+            batch->packets[i].maxlen = size;
+        }
+    }
+    return 1;
+}
+
+int net_socket_recv_batch(NetSocket *socket, NetBatch *batch) {
+    struct NetBatchNative *native = batch->native;
+    for (int i = 0; i < batch->count; i++) {
+        native->vectors[i].iov_base = batch->packets[i].data;
+        native->vectors[i].iov_len = batch->packets[i].maxlen;
+        memset(&native->messages[i], 0, sizeof(struct mmsghdr));
+        native->messages[i].msg_hdr.msg_name = &native->addresses[i];
+        native->messages[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+        native->messages[i].msg_hdr.msg_iov = &native->vectors[i];
+        native->messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    socket->receive_calls++;
+    int received = recvmmsg(socket->fd, native->messages, batch->count, MSG_DONTWAIT, NULL);
+    if (received < 0) return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR ? 0 : -1;
+
+    for (int i = 0; i < received; i++) {
+        batch->packets[i].len = (int)native->messages[i].msg_len;
+        batch->packets[i].address.host = native->addresses[i].sin_addr.s_addr;
+        batch->packets[i].address.port = native->addresses[i].sin_port;
+    }
+    return received;
+}
+
+// Fill in the message for datagrams[first ..], taking the following
+// datagrams into one offload send while they can be segments of it
+// Returns the number of datagrams the message carries.
+static int build_message(NetSocket *socket, struct NetBatchNative *native, int message, int vector,
+                         NetDatagram *const *datagrams, int first, int count) {
+    const NetDatagram *lead = datagrams[first];
+    int segments = 1;
+    int bytes = lead->len;
+    if (socket->gso) {
+        // Every segment but the last must be exactly as long as the first
+        while (first + segments < count && segments < GSO_MAX_SEGMENTS) {
+            const NetDatagram *next = datagrams[first + segments];
+            if (datagrams[first + segments - 1]->len != lead->len || next->len > lead->len ||
+                next->address.host != lead->address.host || next->address.port != lead->address.port ||
+                bytes + next->len > GSO_MAX_BYTES) {
+                break;
+            }
+            bytes += next->len;
+            segments++;
+        }
+    }
+
+    struct sockaddr_in *to = &native->addresses[message];
+    memset(to, 0, sizeof(*to));
+    to->sin_family = AF_INET;
+    to->sin_addr.s_addr = lead->address.host;
+    to->sin_port = lead->address.port;
+
+    for (int i = 0; i < segments; i++) {
+        native->vectors[vector + i].iov_base = (void *)datagrams[first + i]->data;
+        native->vectors[vector + i].iov_len = datagrams[first + i]->len;
+    }
+
+    struct msghdr *header = &native->messages[message].msg_hdr;
+    memset(header, 0, sizeof(*header));
+    header->msg_name = to;
+    header->msg_namelen = sizeof(*to);
+    header->msg_iov = &native->vectors[vector];
+    header->msg_iovlen = segments;
+    if (segments > 1) {
+        Uint8 *control = native->control + GSO_CONTROL_SIZE * message;
+        memset(control, 0, GSO_CONTROL_SIZE);
+        header->msg_control = control;
+        header->msg_controllen = GSO_CONTROL_SIZE;
+        struct cmsghdr *option = CMSG_FIRSTHDR(header);
+        option->cmsg_level = SOL_UDP;
+        option->cmsg_type = UDP_SEGMENT;
+        option->cmsg_len = CMSG_LEN(sizeof(Uint16));
+        Uint16 segment_size = (Uint16)lead->len;
+        memcpy(CMSG_DATA(option), &segment_size, sizeof(segment_size));
+    }
+    native->segments[message] = segments;
+    return segments;
+}
+
+int net_socket_send_batch(NetSocket *socket, NetBatch *batch, NetDatagram *const *datagrams, int count) {
+    struct NetBatchNative *native = batch->native;
+    if (count > batch->count) count = batch->count;
+
+    int sent = 0;
+    int first = 0;
+    while (first < count) {
+        int messages = 0;
+        for (int next = first; next < count; messages++) {
+            next += build_message(socket, native, messages, next - first, datagrams, next, count);
+        }
+
+        socket->send_calls++;
+        int done = sendmmsg(socket->fd, native->messages, messages, 0);
+        if (done < 0) {
+            // A full send buffer drops the rest, as the network would
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS) break;
+            if (errno == EINTR) continue;
+            if (native->segments[0] > 1 && (errno == EIO || errno == EINVAL || errno == EMSGSIZE)) {
+                // Offload refused on this path, e.g. without checksum offload: stop using it
+                socket->gso = 0;
+                continue;
+            }
+            // Skip the datagrams the kernel refused and send the rest
+            first += native->segments[0];
+            continue;
+        }
+        for (int i = 0; i < done; i++) {
+            sent += native->segments[i];
+            first += native->segments[i];
+        }
+    }
+    return sent;
+}
+
+void net_socket_close(NetSocket *socket) {
+    if (socket->fd >= 0) close(socket->fd);
+    socket->fd = -1;
+}
+
+#else  // SDL_net: one socket, no steering
+
+const char *net_socket_error(void) {
+    return SDLNet_GetError();
+}
+
+int net_socket_open_shards(NetSocket *sockets, int count, Uint16 port, int *steer) {
+    (void)count;
+    *steer = NET_STEER_KERNEL;
+    sockets[0].fd = -1;
+    sockets[0].gso = 0;
+    sockets[0].receive_calls = 0;
+    sockets[0].send_calls = 0;
+    sockets[0].sdl = SDLNet_UDP_Open(port);
+    if (!sockets[0].sdl) return 0;
+
+    sockets[0].sdl_set = SDLNet_AllocSocketSet(1);
+    if (!sockets[0].sdl_set || SDLNet_UDP_AddSocket(sockets[0].sdl_set, sockets[0].sdl) < 0) {
+        SDLNet_UDP_Close(sockets[0].sdl);
+        return 0;
+    }
+    return 1;
+}
+
+int net_socket_wait(NetSocket *socket, int timeout_ms) {
+    int ready = SDLNet_CheckSockets(socket->sdl_set, (Uint32)timeout_ms);
+    return ready < 0 ? -1 : ready > 0;
+}
+
+int net_socket_recv(NetSocket *socket, UDPpacket *packet) {
+    socket->receive_calls++;
+    return SDLNet_UDP_Recv(socket->sdl, packet);
+}
+
+int net_socket_send(NetSocket *socket, const UDPpacket *packet) {
+    socket->send_calls++;
+    return SDLNet_UDP_Send(socket->sdl, -1, (UDPpacket *)packet) ? 1 : 0;
+}
+
+int net_batch_init(NetBatch *batch, int count, int size, Arena *arena) {
+    if (count > NET_BATCH_SIZE) count = NET_BATCH_SIZE;
+    batch->count = count;
+    batch->packets = NULL;
+    batch->native = NULL;
+    if (size > 0) {
+        Uint8 *storage = arena_alloc(arena, (size_t)size * count);
+        batch->packets = arena_alloc(arena, sizeof(UDPpacket) * count);
+        if (!storage || !batch->packets) return 0;
+        for (int i = 0; i < count; i++) {
+            batch->packets[i].channel = -1;
+            batch->packets[i].data = storage + (size_t)size * i;
+            batch->packets[i].maxlen = size;
+        }
+    }
+    return 1;
+}
+
+int net_socket_recv_batch(NetSocket *socket, NetBatch *batch) {
+    int received = 0;
+    while (received < batch->count) {
+        int result = net_socket_recv(socket, &batch->packets[received]);
+        if (result < 0) return received > 0 ? received : -1;
+        if (result == 0) break;
+        received++;
+    }
+    return received;
+}
+
+int net_socket_send_batch(NetSocket *socket, NetBatch *batch, NetDatagram *const *datagrams, int count) {
+    (void)batch;
+    int sent = 0;
+    for (int i = 0; i < count; i++) {
+        UDPpacket packet;
+        memset(&packet, 0, sizeof(packet));
+        packet.channel = -1;
+        packet.data = datagrams[i]->data;
+        packet.len = datagrams[i]->len;
+        packet.maxlen = NET_MTU;
+        packet.address = datagrams[i]->address;
+        sent += net_socket_send(socket, &packet);
+    }
+    return sent;
+}
+
+void net_socket_close(NetSocket *socket) {
+    if (socket->sdl_set) SDLNet_FreeSocketSet(socket->sdl_set);
+    if (socket->sdl) SDLNet_UDP_Close(socket->sdl);
+    socket->sdl_set = NULL;
+    socket->sdl = NULL;
+}
+
+#endif
@@ -0,0 +1,145 @@
+#ifndef NETWORK_SOCKET_H
+#define NETWORK_SOCKET_H
+
+#include <SDL2/SDL_net.h>
+#include "network_common.h"
+#include "network_arena.h"
+
+#define MAX_SHARDS 64
+#define NET_BATCH_SIZE 64    // Datagrams moved per system call
+
+// How datagrams are spread over the shard sockets of one port
+#define NET_STEER_KERNEL 0   // The kernel's flow hash of the sender's address
+#define NET_STEER_HASH 1     // BPF program hashing the sender's address and port
+#define NET_STEER_CPU 2      // BPF program picking the shard of the CPU that took the packet
+
+// Server UDP socket
+// On Linux several sockets can share one port through SO_REUSEPORT, each
+// drained by its own thread; the kernel picks a socket per datagram and a
+// given client always reaches the same one. Elsewhere there is a single
+// SDL_net socket. Datagrams travel in UDPpackets either way.
+typedef struct {
+    int fd;                     // Native socket, -1 when SDL_net is used
+    int gso;                    // Kernel splits runs of equal datagrams itself (UDP_SEGMENT)
+    UDPsocket sdl;
+    SDLNet_SocketSet sdl_set;   // For waiting on the SDL_net socket
+    Uint32 receive_calls;       // System calls made, for stats; reset by the owner
+    Uint32 send_calls;
+} NetSocket;
+
+// Encoded datagram waiting in a queue for a shard thread to send
+// Every socket of a shard group shares the port, so any of them can send it
+typedef struct {
+    IPaddress address;
+    int len;
+    Uint8 data[NET_MTU];
+} NetDatagram;
+
+struct NetBatchNative;
+
+// Pre-allocated buffers and message headers for batched system calls
+// On Linux one recvmmsg fills every packet at once and one sendmmsg sends
+// a whole batch; elsewhere the calls loop over single datagrams.
+typedef struct {
+    int count;                      // Datagrams per call
+    UDPpacket *packets;             // count packets filled by receives; NULL for a send-only batch
+    struct NetBatchNative *native;  // Message headers, reused by every call
+} NetBatch;
+
+/**
+ * Open the shard sockets of a port
+ * Without SO_REUSEPORT support only one socket is opened
+ *
+ * @param sockets Array of at least count NetSockets
+ * @param count Sockets wanted, at most MAX_SHARDS
+ * @param port Port to bind, in host byte order
+ * @param steer NET_STEER_* policy; falls back to NET_STEER_KERNEL if the program is refused
+ * @return Number of sockets opened, or 0 on failure
+ */
+int net_socket_open_shards(NetSocket *sockets, int count, Uint16 port, int *steer);
+
+/**
+ * Wait until a socket has a datagram to read
+ *
+ * @param socket Pointer to NetSocket
+ * @param timeout_ms Longest wait
+ * @return 1 if readable, 0 on timeout, -1 on error
+ */
+int net_socket_wait(NetSocket *socket, int timeout_ms);
+
+/**
+ * Read one datagram without blocking
+ *
+ * @param socket Pointer to NetSocket
+ * @param packet Receives the data, length and sender address
+ * @return 1 if a datagram was read, 0 if none was waiting, -1 on error
+ */
+int net_socket_recv(NetSocket *socket, UDPpacket *packet);
+
+/**
+ * Allocate a batch
+ *
+ * @param batch Pointer to NetBatch
+ * @param count Datagrams per call, at most NET_BATCH_SIZE
+ * @param size Receive buffer bytes per packet, 0 for a batch that only sends
+ * @param arena Arena the buffers are taken from
+ * @return 1 on success, 0 if allocation failed
+ */
+int net_batch_init(NetBatch *batch, int count, int size, Arena *arena);
+
+/**
+ * Read waiting datagrams without blocking, as many as the batch holds
+ *
+ * @param socket Pointer to NetSocket
+ * @param batch Batch with receive buffers; packets[0 .. n - 1] are filled in
+ * @return Number n of datagrams read, 0 if none was waiting, -1 on error
+ */
+int net_socket_recv_batch(NetSocket *socket, NetBatch *batch);
+
+/**
+ * Send datagrams, as few system calls as the batch allows
+ * Consecutive datagrams to one address go out as a single segmentation
+ * offload send when every one but the last has the same length, as the
+ * fragments of a message do. Datagrams the kernel has no room for are
+ * dropped, like any UDP loss.
+ *
+ * @param socket Pointer to NetSocket
+ * @param batch Batch whose message headers are used
+ * @param datagrams Datagrams to send, in order
+ * @param count Number of datagrams, at most batch->count
+ * @return Number of datagrams sent
+ */
+int net_socket_send_batch(NetSocket *socket, NetBatch *batch, NetDatagram *const *datagrams, int count);
+
+/**
+ * Send a datagram to packet->address
+ *
+ * @param socket Pointer to NetSocket
+ * @param packet Data, length and destination
+ * @return 1 if sent, 0 on failure
+ */
+int net_socket_send(NetSocket *socket, const UDPpacket *packet);
+
+/**
+ * Close a socket
+ *
+ * @param socket Pointer to NetSocket
+ */
+void net_socket_close(NetSocket *socket);
+
+/**
+ * Describe the last socket error
+ *
+ * @return Error message
+ */
+const char *net_socket_error(void);
+
+/**
+ * Name of a steering policy, for logs
+ *
+ * @param steer NET_STEER_* value
+ * @return "kernel", "hash" or "cpu"
+ */
+const char *net_steer_name(int steer);
+
+#endif // NETWORK_SOCKET_H
@@ -0,0 +1,110 @@
+#include <string.h>
+#include "network_timer.h"
+
+int timer_wheel_init(TimerWheel *wheel, int capacity, Uint32 now, void *context, Arena *arena) {
+    memset(wheel, 0, sizeof(TimerWheel));
+    wheel->timers = arena_alloc(arena, sizeof(Timer) * capacity);
+    if (!wheel->timers || !pool_init(&wheel->pool, capacity, arena)) return 0;
+
+    for (int i = 0; i < TIMER_LEVELS * TIMER_SLOTS; i++) wheel->buckets[i] = TIMER_NONE;
+    wheel->now = now;
+    wheel->context = context;
+    return 1;
+}
+
+// Bucket for a timer: the finest level whose span still reaches its tick
+// A delay of 0 lands in the level 0 bucket about to fire
+static int bucket_for(Uint32 now, Uint32 due) {
+    Uint32 delay = due - now;
+    int level = 0;
+    while (level < TIMER_LEVELS - 1 && delay >= (1u << (TIMER_SLOT_BITS * (level + 1)))) level++;
+    return level * TIMER_SLOTS + (int)((due >> (TIMER_SLOT_BITS * level)) & (TIMER_SLOTS - 1));
+}
+
+static void link_timer(TimerWheel *wheel, int t) {
+    Timer *timer = &wheel->timers[t];
+    int *head = &wheel->buckets[timer->bucket];
+    timer->prev = TIMER_NONE;
+    timer->next = *head;
+    if (*head != TIMER_NONE) wheel->timers[*head].prev = t;
+    *head = t;
+}
+
+static void unlink_timer(TimerWheel *wheel, int t) {
+    Timer *timer = &wheel->timers[t];
+    if (timer->prev != TIMER_NONE) wheel->timers[timer->prev].next = timer->next;
+    else wheel->buckets[timer->bucket] = timer->next;
+    if (timer->next != TIMER_NONE) wheel->timers[timer->next].prev = timer->prev;
+}
+
+EntityId timer_schedule(TimerWheel *wheel, Uint32 due, TimerCallback callback, int arg) {
+    EntityId id = pool_alloc(&wheel->pool);
+    if (id == ENTITY_NONE) return ENTITY_NONE;
+
+    // Signed difference, so ticks already past count as due now
+    Sint32 delay = (Sint32)(due - wheel->now);
+    if (delay < 1) due = wheel->now + 1;
+    else if ((Uint32)delay > TIMER_MAX_DELAY) due = wheel->now + TIMER_MAX_DELAY;
+
+    int t = ENTITY_INDEX(id);
+    Timer *timer = &wheel->timers[t];
+    timer->due = due;
+    timer->callback = callback;
+    timer->arg = arg;
+    timer->bucket = bucket_for(wheel->now, due);
+    link_timer(wheel, t);
+    return id;
+}
+
+int timer_cancel(TimerWheel *wheel, EntityId id) {
+    int t = pool_slot(&wheel->pool, id);
+    if (t < 0) return 0;
+
+    unlink_timer(wheel, t);
+    pool_release(&wheel->pool, id);
+    return 1;
+}
+
+// Move a bucket's timers down to the buckets their remaining delay calls for
+static void cascade(TimerWheel *wheel, int bucket) {
+    int t = wheel->buckets[bucket];
+    wheel->buckets[bucket] = TIMER_NONE;
+    while (t != TIMER_NONE) {
+        int next = wheel->timers[t].next;
+        wheel->timers[t].bucket = bucket_for(wheel->now, wheel->timers[t].due);
+        link_timer(wheel, t);
+        wheel->cascaded++;
+        t = next;
+    }
+}
+
+int timer_wheel_advance(TimerWheel *wheel, Uint32 tick) {
+    int fired = 0;
+    while ((Sint32)(tick - wheel->now) > 0) {
+        Uint32 now = ++wheel->now;
+
+        // Crossing a boundary of level n also crosses every level below it,
+        // so cascade from the top down: timers fall through to level 0 in one pass
+        int levels = 1;
+        while (levels < TIMER_LEVELS && ((now >> (TIMER_SLOT_BITS * levels)) << (TIMER_SLOT_BITS * levels)) == now) {
+            levels++;
+        }
+        for (int level = levels - 1; level >= 1; level--) {
+            cascade(wheel, level * TIMER_SLOTS + (int)((now >> (TIMER_SLOT_BITS * level)) & (TIMER_SLOTS - 1)));
+        }
+
+        // Pop one at a time: callbacks may cancel timers in this same bucket,
+        // and anything they schedule is due later so lands elsewhere
+        int *head = &wheel->buckets[now & (TIMER_SLOTS - 1)];
+        while (*head != TIMER_NONE) {
+            int t = *head;
+            Timer timer = wheel->timers[t];
+            unlink_timer(wheel, t);
+            pool_release(&wheel->pool, pool_id(&wheel->pool, t));
+            timer.callback(wheel->context, timer.arg);
+            fired++;
+        }
+    }
+    wheel->fired += fired;
+    return fired;
+}
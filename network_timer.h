@@ -0,0 +1,86 @@
+#ifndef NETWORK_TIMER_H
+#define NETWORK_TIMER_H
+
+#include "network_common.h"
+#include "network_pool.h"
+
+#define TIMER_SLOT_BITS 6
+#define TIMER_SLOTS (1 << TIMER_SLOT_BITS)  // Buckets per level
+#define TIMER_LEVELS 4                      // Reach: 2^24 ticks, over a day at MAX_TICK_RATE
+#define TIMER_MAX_DELAY ((1u << (TIMER_SLOT_BITS * TIMER_LEVELS)) - 1)
+#define TIMER_NONE -1
+
+typedef void (*TimerCallback)(void *context, int arg);
+
+// One scheduled callback, linked into the bucket of its due tick
+typedef struct {
+    Uint32 due;             // Tick it fires on
+    TimerCallback callback;
+    int arg;
+    int bucket;             // Index into TimerWheel.buckets
+    int next;
+    int prev;
+} Timer;
+
+// Hierarchical timer wheel on simulation ticks
+// Level 0 has one bucket per tick for the next TIMER_SLOTS ticks; each
+// level above covers TIMER_SLOTS times the span of the one below. When the
+// clock crosses a level's bucket boundary, that bucket's timers move down
+// to finer buckets. Advancing one tick touches only the timers due on it,
+// plus the occasional cascade, whatever the number of timers pending.
+typedef struct {
+    EntityPool pool;        // Timer slots; ids are generation-tagged so stale cancels are harmless
+    void *context;          // Passed to every callback
+    Timer *timers;
+    int buckets[TIMER_LEVELS * TIMER_SLOTS];  // Head timer of each bucket, TIMER_NONE if empty
+    Uint32 now;             // Last tick advanced to
+    Uint32 fired;           // Stats since last reset
+    Uint32 cascaded;        // Timers moved down a level
+} TimerWheel;
+
+/**
+ * Allocate an empty wheel
+ *
+ * @param wheel Pointer to TimerWheel
+ * @param capacity Most timers pending at once
+ * @param now Current tick
+ * @param context Passed to every callback, along with the timer's argument
+ * @param arena Arena the timer slots are taken from
+ * @return 1 on success, 0 if allocation failed
+ */
+int timer_wheel_init(TimerWheel *wheel, int capacity, Uint32 now, void *context, Arena *arena);
+
+/**
+ * Schedule a callback
+ * Ticks already reached fire on the next advance; delays beyond
+ * TIMER_MAX_DELAY are shortened to it
+ *
+ * @param wheel Pointer to TimerWheel
+ * @param due Tick to fire on
+ * @param callback Function to call
+ * @param arg Passed to the callback after the wheel's context
+ * @return Timer id, or ENTITY_NONE if the wheel is full
+ */
+EntityId timer_schedule(TimerWheel *wheel, Uint32 due, TimerCallback callback, int arg);
+
+/**
+ * Cancel a pending timer
+ *
+ * @param wheel Pointer to TimerWheel
+ * @param id Timer id; ids of fired or cancelled timers are ignored
+ * @return 1 if a timer was cancelled
+ */
+int timer_cancel(TimerWheel *wheel, EntityId id);
+
+/**
+ * Advance the clock, firing every timer due up to and including a tick
+ * Timers due on the same tick fire in no particular order. Callbacks may
+ * schedule and cancel timers; new ones are due after the current tick.
+ *
+ * @param wheel Pointer to TimerWheel
+ * @param tick Tick to advance to
+ * @return Number of timers fired
+ */
+int timer_wheel_advance(TimerWheel *wheel, Uint32 tick);
+
+#endif // NETWORK_TIMER_H